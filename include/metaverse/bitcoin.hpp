@@ -125,6 +125,7 @@
 #include <metaverse/bitcoin/utility/monitor.hpp>
 #include <metaverse/bitcoin/utility/notifier.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
+#include <metaverse/bitcoin/utility/parallel.hpp>
 #include <metaverse/bitcoin/utility/png.hpp>
 #include <metaverse/bitcoin/utility/random.hpp>
 #include <metaverse/bitcoin/utility/reader.hpp>
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_PARALLEL_HPP
+#define MVS_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <metaverse/bitcoin/utility/threadpool.hpp>
+
+namespace libbitcoin {
+
+/**
+ * Invokes job(index) for every index in [0, count) on the pool threads and
+ * on the calling thread, and returns once every index has completed.
+ *
+ * The calling thread takes part in the work, so this cannot deadlock when it
+ * is itself a pool thread or when the pool is saturated (or stopped): in the
+ * worst case the caller simply runs every index.
+ * The job must be safe to invoke concurrently for distinct indexes.
+ */
+template <typename Job>
+void parallel_for(threadpool& pool, size_t count, Job job)
+{
+    if (count == 0)
+        return;
+
+    struct state
+    {
+        state(size_t count, Job job)
+          : count(count), next(0), done(0), job(std::move(job))
+        {
+        }
+
+        // Returns true if the caller completed the last index.
+        bool run()
+        {
+            auto finished = false;
+            for (auto index = next++; index < count; index = next++)
+            {
+                job(index);
+                finished = (++done == count);
+            }
+
+            return finished;
+        }
+
+        const size_t count;
+        std::atomic<size_t> next;
+        std::atomic<size_t> done;
+        Job job;
+        std::mutex mutex;
+        std::condition_variable completed;
+    };
+
+    const auto shared = std::make_shared<state>(count, std::move(job));
+
+    // Late helpers find no remaining index and only touch the shared state.
+    const auto helper = [shared]()
+    {
+        if (shared->run())
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            shared->completed.notify_one();
+        }
+    };
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const auto helpers = std::min(count, cores) - 1;
+    for (size_t helper_index = 0; helper_index < helpers; ++helper_index)
+        pool.service().post(helper);
+
+    shared->run();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->completed.wait(lock, [&shared]()
+    {
+        return shared->done.load() == shared->count;
+    });
+}
+
+} // namespace libbitcoin
+
+#endif
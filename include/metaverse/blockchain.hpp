@@ -28,6 +28,7 @@
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/orphan_pool.hpp>
+#include <metaverse/blockchain/script_cache.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
@@ -109,6 +109,11 @@ public:
     bool get_transaction(chain::transaction& out_transaction,
         uint64_t& out_block_height, const hash_digest& transaction_hash) const;
 
+    /// Get a confirmed output from the unspent output set, a miss does not
+    /// imply the output is spent (the set may predate the output).
+    bool get_unspent_output(database::unspent_output& out_output,
+        const chain::output_point& outpoint) const;
+
     /// Import a block to the blockchain.
     bool import(chain::block::ptr block, uint64_t height);
 
@@ -307,6 +312,14 @@ public:
     std::shared_ptr<business_record::list> get_address_business_record(
         const std::string& address, const std::string& symbol, size_t start_height, size_t end_height,
         uint64_t limit, uint64_t page_number) const;
+
+    /// One page of the distinct transactions of the addresses, ordered by
+    /// height descending then by hash, after the position in cursor. cursor
+    /// is replaced by the token of the next page, empty after the last page.
+    /// Returns nullptr if cursor is not a token of this function.
+    std::shared_ptr<business_record::list> get_address_business_record_page(
+        const std::vector<std::string>& addresses, const std::string& symbol,
+        size_t start_height, size_t end_height, size_t limit, std::string& cursor);
     std::shared_ptr<account_address::list> get_addresses();
 
     // account message api
@@ -335,6 +348,22 @@ public:
         std::function<void(const code&, chain::history::list&)> handler);
     bool get_history(const wallet::payment_address& address,
         uint64_t limit, uint64_t from_height, history_compact::list& history);
+    bool get_pool_history(const wallet::payment_address& address,
+        chain::spend_info::list& spends, chain::output_info::list& outputs);
+
+    /// Get the confirmed balance of an address from the balance index,
+    /// false if the index does not cover the whole chain.
+    bool get_address_balance(const wallet::payment_address& address,
+        database::address_balance& balance);
+
+    /// Get a confirmed unspent output from the balance index.
+    bool get_address_output(const chain::output_point& point,
+        database::address_output& output);
+
+    /// Get the unspent outputs of an address, confirmed and pooled, from the
+    /// balance index, false if the index does not cover the whole chain.
+    bool get_address_unspent(const wallet::payment_address& address,
+        chain::history::list& rows);
     code validate_transaction(const chain::transaction& tx);
     code broadcast_transaction(const chain::transaction& tx);
     bool get_tx_inputs_etp_value (chain::transaction& tx, uint64_t& etp_val);
@@ -366,9 +395,10 @@ private:
     void do_store(message::block_message::ptr block,
         block_store_handler handler);
 
-    ////void fetch_ordered(perform_read_functor perform_read);
-    ////void fetch_parallel(perform_read_functor perform_read);
+    void fetch_ordered(perform_read_functor perform_read);
+    void fetch_parallel(perform_read_functor perform_read);
     void fetch_serial(perform_read_functor perform_read);
+    void do_fetch(perform_read_functor perform_read);
     bool stopped() const;
 
     std::string get_asset_symbol_from_business_data(const business_data& data);
@@ -379,7 +409,7 @@ private:
 
     // These are thread safe.
     organizer organizer_;
-    ////dispatcher read_dispatch_;
+    dispatcher read_dispatch_;
     ////dispatcher write_dispatch_;
     blockchain::transaction_pool transaction_pool_;
 
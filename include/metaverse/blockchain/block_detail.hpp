@@ -65,12 +65,19 @@ public:
     void set_is_checked_work_proof(bool is_checked);
     bool get_is_checked_work_proof() const;
 
+    // Set once the ethash seal alone is checked, ahead of full validation.
+    void set_checked_seal(bool is_valid);
+    bool get_is_checked_seal() const;
+    bool get_is_valid_seal() const;
+
 private:
     bc::atomic<code> code_;
     std::atomic<bool> processed_;
     std::atomic<uint64_t> height_;
     const block_ptr actual_block_;
     std::atomic<bool> is_checked_work_proof_;
+    std::atomic<bool> is_checked_seal_;
+    std::atomic<bool> is_valid_seal_;
 };
 
 } // namespace blockchain
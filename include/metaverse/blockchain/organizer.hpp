@@ -83,6 +83,7 @@ private:
     virtual code verify(uint64_t fork_index,
         const block_detail::list& orphan_chain, uint64_t orphan_index);
     void process(block_detail::ptr process_block);
+    void prevalidate_work(uint64_t fork_index, const detail_list& orphan_chain);
     void replace_chain(uint64_t fork_index, detail_list& orphan_chain);
     void remove_processed(block_detail::ptr remove_block);
     void clip_orphans(detail_list& orphan_chain, uint64_t orphan_index,
@@ -93,6 +94,7 @@ private:
         const detail_list& orphan_chain, const detail_list& replaced_chain);
 
     std::atomic<bool> stopped_;
+    threadpool& pool_;
     const bool use_testnet_rules_;
     const config::checkpoint::list checkpoints_;
 
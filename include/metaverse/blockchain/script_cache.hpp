@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_SCRIPT_CACHE_HPP
+#define MVS_BLOCKCHAIN_SCRIPT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// Bounded cache of successful input script verifications, shared by the
+/// transaction pool and block validation so that inputs verified on pool
+/// acceptance are not verified again when the block arrives.
+/// Entries are keyed by (tx hash, input index, prevout script) and record the
+/// verification flags, a lookup hits if the cached flags cover the requested
+/// flags (script flags only ever add restrictions).
+class BCB_API script_cache
+{
+public:
+    static const size_t default_capacity;
+
+    static script_cache& instance();
+
+    /// A capacity of zero disables the cache.
+    void set_capacity(size_t capacity);
+
+    bool contains(const hash_digest& tx_hash, uint32_t input_index,
+        const data_chunk& prevout_script, uint32_t flags) const;
+    void store(const hash_digest& tx_hash, uint32_t input_index,
+        const data_chunk& prevout_script, uint32_t flags);
+    void clear();
+
+private:
+    typedef std::unordered_map<hash_digest, uint32_t> entry_map;
+
+    script_cache();
+    script_cache(const script_cache&) = delete;
+    void operator=(const script_cache&) = delete;
+
+    static hash_digest to_key(const hash_digest& tx_hash,
+        uint32_t input_index, const data_chunk& prevout_script);
+
+    size_t capacity_;
+    entry_map entries_;
+    std::deque<hash_digest> order_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -40,7 +40,10 @@ public:
     uint32_t block_pool_capacity;
     uint32_t transaction_pool_capacity;
     bool transaction_pool_consistency;
+    uint32_t script_cache_capacity;
     bool use_testnet_rules;
+    uint32_t dag_threads;
+    bool dag_pregenerate;
     config::checkpoint::list checkpoints;
 };
 
@@ -80,6 +80,8 @@ public:
     void delete_tx(const hash_digest& tx_hash);
     void fetch_history(const wallet::payment_address& address, size_t limit,
         size_t from_height, block_chain::history_fetch_handler handler);
+    void fetch_index_history(const wallet::payment_address& address,
+        transaction_pool_index::query_handler handler);
     void exists(const hash_digest& tx_hash, result_handler handler);
     void filter(get_data_ptr message, result_handler handler);
     void validate(transaction_ptr tx, validate_handler handler);
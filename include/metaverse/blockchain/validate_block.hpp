@@ -32,6 +32,8 @@
 namespace libbitcoin {
 namespace blockchain {
 
+class validation_context;
+
 // Max block size (1000000 bytes).
 constexpr uint32_t max_block_size = 1000000;
 
@@ -59,7 +61,17 @@ protected:
     typedef std::vector<uint8_t> versions;
     typedef std::function<bool()> stopped_callback;
 
-    validate_block(size_t height, const chain::block& block,
+    /// The result of connecting a single input, tallied in block order.
+    struct connected_input
+    {
+        bool valid;
+        uint64_t value;
+        size_t sigops;
+    };
+
+    typedef std::vector<connected_input> connected_inputs;
+
+    validate_block(threadpool& pool, size_t height, const chain::block& block,
         bool testnet, const config::checkpoint::list& checks,
         stopped_callback stop_callback);
 
@@ -76,13 +88,25 @@ protected:
     virtual bool is_output_spent(const chain::output_point& previous_output,
         size_t index_in_parent, size_t input_index) const = 0;
 
+    /// Get a previous output known to be unspent in the chain (up to the
+    /// fork) and in the orphan chain (excluding the given input).
+    /// A miss implies nothing, callers fall back to fetch_transaction.
+    virtual bool fetch_unspent_output(chain::output& out_output,
+        size_t& out_height, bool& out_coinbase,
+        const chain::output_point& previous_output, size_t index_in_parent,
+        size_t input_index) const = 0;
+
     // These have default implementations that can be overriden.
     virtual bool connect_input(size_t index_in_parent,
-        const chain::transaction& current_tx, size_t input_index,
+        const validation_context& context, size_t input_index,
         uint64_t& value_in, size_t& total_sigops) const;
     virtual bool validate_inputs(const chain::transaction& tx,
-        size_t index_in_parent, uint64_t& value_in,
-        size_t& total_sigops) const;
+        size_t index_in_parent, const connected_inputs& connected,
+        uint64_t& value_in, size_t& total_sigops) const;
+
+    /// Connects every input of every non-coinbase transaction concurrently.
+    /// The result is indexed by transaction position and then input index.
+    std::vector<connected_inputs> connect_inputs() const;
 
     // These are protected virtual for testability.
     bool stopped() const;
@@ -102,6 +126,7 @@ protected:
     static size_t legacy_sigops_count(const chain::transaction::list& txs);
 
 private:
+    threadpool& pool_;
     bool testnet_;
     const size_t height_;
     uint32_t activations_;
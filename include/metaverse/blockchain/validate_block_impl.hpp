@@ -36,7 +36,8 @@ class BCB_API validate_block_impl
   : public validate_block
 {
 public:
-    validate_block_impl(block_chain_impl& chain, size_t fork_index,
+    validate_block_impl(threadpool& pool, block_chain_impl& chain,
+        size_t fork_index,
         const block_detail::list& orphan_chain, size_t orphan_index,
         size_t height, const chain::block& block, bool testnet,
         const config::checkpoint::list& checkpoints,
@@ -55,6 +56,9 @@ protected:
     bool is_output_spent(const chain::output_point& outpoint) const;
     bool is_output_spent(const chain::output_point& previous_output,
         size_t index_in_parent, size_t input_index) const;
+    bool fetch_unspent_output(chain::output& out_output, size_t& out_height,
+        bool& out_coinbase, const chain::output_point& previous_output,
+        size_t index_in_parent, size_t input_index) const;
     bool transaction_exists(const hash_digest& tx_hash) const;
 
 private:
@@ -26,6 +26,7 @@
 #include <functional>
 #include <memory>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/consensus/export.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/blockchain/block_chain_impl.hpp>
@@ -35,6 +36,29 @@ namespace blockchain {
 
 class validate_block;
 
+/// This class is thread safe (immutable).
+/// A transaction serialized and prepared once for the script checks of all of
+/// its inputs, so an N input transaction is not serialized N times.
+/// The transaction must outlive the context.
+class BCB_API validation_context
+{
+public:
+    typedef std::shared_ptr<const validation_context> ptr;
+
+    explicit validation_context(const chain::transaction& tx);
+
+    const chain::transaction& tx() const;
+    const hash_digest& hash() const;
+
+    /// Null unless built with the consensus library.
+    const consensus::prepared_transaction* prepared() const;
+
+private:
+    const chain::transaction& tx_;
+    const hash_digest hash_;
+    std::shared_ptr<const consensus::prepared_transaction> prepared_;
+};
+
 /// This class is not thread safe.
 /// This is a utility for transaction_pool::validate and validate_block.
 class BCB_API validate_transaction
@@ -56,6 +80,9 @@ public:
     static bool check_consensus(const chain::script& prevout_script,
         const chain::transaction& current_tx, size_t input_index,
         uint32_t flags);
+    static bool check_consensus(const chain::script& prevout_script,
+        const validation_context& context, size_t input_index,
+        uint32_t flags);
 
     code check_transaction_connect_input(size_t last_height);
     code check_transaction() const;
@@ -69,6 +96,8 @@ public:
     code connect_input_address_match_did(const output& output) const;
 
     bool connect_input(const chain::transaction& previous_tx, size_t parent_height);
+    bool connect_input(const chain::output& previous_output,
+        bool previous_coinbase, size_t parent_height);
 
     static bool tally_fees(const chain::transaction& tx, uint64_t value_in,
         uint64_t& fees);
@@ -117,6 +146,7 @@ private:
 
     block_chain_impl& blockchain_;
     const transaction_ptr tx_;
+    validation_context::ptr context_;
     const transaction_pool* const pool_;
     dispatcher* const dispatch_;
     const validate_block* const validate_block_;
@@ -22,6 +22,7 @@
 #define MVS_CONSENSUS_EXPORT_HPP
 
 #include <cstddef>
+#include <memory>
 #include <metaverse/consensus/define.hpp>
 #include <metaverse/consensus/version.hpp>
 
@@ -177,6 +178,26 @@ typedef enum verify_flags_type
     verify_flags_checkattenuationverify = (1U << 10)
 } verify_flags;
 
+/**
+ * A transaction deserialized once for the verification of all of its inputs.
+ * This is immutable and may be shared across threads.
+ */
+class BCK_API prepared_transaction
+{
+public:
+    prepared_transaction(const unsigned char* transaction,
+        size_t transaction_size);
+
+    /// verify_result_eval_true if the transaction deserialized correctly.
+    verify_result_type status() const;
+
+    class implementation;
+    const implementation& impl() const;
+
+private:
+    std::shared_ptr<const implementation> impl_;
+};
+
 /**
  * Verify that the transaction input correctly spends the previous output,
  * considering any additional constraints specified by flags.
@@ -189,11 +210,20 @@ typedef enum verify_flags_type
  * @param[in]  flags               Verification constraint flags.
  * @returns                        A script verification result code.
  */
- BCK_API verify_result_type verify_script(const unsigned char* transaction,
+BCK_API verify_result_type verify_script(const unsigned char* transaction,
     size_t transaction_size, const unsigned char* prevout_script,
-    size_t prevout_script_size, unsigned int tx_input_index, 
+    size_t prevout_script_size, unsigned int tx_input_index,
     unsigned int flags);
 
+/**
+ * As above, for a transaction prepared once for all of its inputs.
+ * @param[in]  transaction         The prepared transaction to verify.
+ */
+BCK_API verify_result_type verify_script(
+    const prepared_transaction& transaction,
+    const unsigned char* prevout_script, size_t prevout_script_size,
+    unsigned int tx_input_index, unsigned int flags);
+
 } // namespace consensus
 } // namespace libbitcoin
 
@@ -110,6 +110,21 @@ ethash_return_value_t ethash_light_compute(
  */
 ethash_full_t ethash_full_new(ethash_light_t light, ethash_callback_t callback);
 
+/**
+ * Set the number of threads used to compute the items of a new DAG
+ *
+ * DAG items are independent of each other, so @ref ethash_full_new() splits
+ * them across this many threads. The callback is still only invoked from the
+ * calling thread. Defaults to 1.
+ *
+ * @param threads      The number of threads, 0 is treated as 1
+ */
+void ethash_set_dag_threads(unsigned threads);
+/**
+ * @return             The number of threads used to compute a new DAG
+ */
+unsigned ethash_get_dag_threads(void);
+
 /**
  * Frees a previously allocated ethash_full handler
  * @param full    The light handler to free
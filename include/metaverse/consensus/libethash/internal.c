@@ -25,6 +25,11 @@
 #include <stddef.h>
 #include <errno.h>
 #include <math.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 #include "mmap.h"
 #include "ethash.h"
 #include "fnv.h"
@@ -33,6 +38,17 @@
 #include "data_sizes.h"
 #include "io.h"
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ETHASH_SIMD_X86 1
+#define ETHASH_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#define ETHASH_SIMD_X86 1
+#define ETHASH_TARGET(isa)
+#endif
+
 #ifdef WITH_CRYPTOPP
 
 #include "sha3_cryptopp.h"
@@ -90,6 +106,171 @@ static bool ethash_compute_cache_nodes(
 	return true;
 }
 
+// Vectorized variants of the two FNV loops of ethash: folding the parents
+// into a DAG item and folding the DAG pages into the mix. The loops are
+// stamped out once per instruction set so the node mixing inlines into them,
+// and the best variant for the CPU is picked at runtime. Loads are unaligned
+// since DAG nodes in a mapped file are only 8 byte aligned.
+#define ETHASH_DAG_PARENTS_LOOP(fnv_node)								\
+	uint32_t word = ret->words[0];											\
+	for (uint32_t i = 0; i != ETHASH_DATASET_PARENTS; ++i) {				\
+		node const* const parent = &cache_nodes[fnv_hash(node_index ^ i, word) % num_parent_nodes]; \
+		uint32_t const next = (i + 1) % NODE_WORDS;							\
+		word = fnv_hash(ret->words[next], parent->words[next]);				\
+		fnv_node(ret, parent);												\
+	}
+
+#define ETHASH_MIX_ACCESSES_LOOP(fnv_node)								\
+	node* const mix = s_mix + 1;											\
+	uint32_t word = mix->words[0];											\
+	for (unsigned i = 0; i != ETHASH_ACCESSES; ++i) {						\
+		uint32_t const index = fnv_hash(s_mix->words[0] ^ i, word) % num_full_pages; \
+		node const* dag_nodes;												\
+		node tmp_nodes[MIX_NODES];											\
+		if (full_nodes) {													\
+			dag_nodes = &full_nodes[MIX_NODES * index];						\
+		} else {															\
+			for (unsigned n = 0; n != MIX_NODES; ++n) {						\
+				ethash_calculate_dag_item(&tmp_nodes[n], index * MIX_NODES + n, light); \
+			}																\
+			dag_nodes = tmp_nodes;											\
+		}																	\
+		unsigned const next = (i + 1) % MIX_WORDS;							\
+		word = fnv_hash(mix->words[next], dag_nodes->words[next]);			\
+		for (unsigned n = 0; n != MIX_NODES; ++n) {							\
+			fnv_node(&mix[n], &dag_nodes[n]);								\
+		}																	\
+	}
+
+typedef struct ethash_kernels {
+	void (*dag_parents)(node* ret, uint32_t node_index, node const* cache_nodes, uint32_t num_parent_nodes);
+	void (*mix_accesses)(node* s_mix, node const* full_nodes, ethash_light_t light, unsigned num_full_pages);
+} ethash_kernels_t;
+
+static inline void ethash_fnv_node_scalar(node* mix, node const* data)
+{
+	for (unsigned w = 0; w != NODE_WORDS; ++w) {
+		mix->words[w] = fnv_hash(mix->words[w], data->words[w]);
+	}
+}
+
+static void ethash_dag_parents_scalar(node* ret, uint32_t node_index, node const* cache_nodes, uint32_t num_parent_nodes)
+{
+	ETHASH_DAG_PARENTS_LOOP(ethash_fnv_node_scalar)
+}
+
+static void ethash_mix_accesses_scalar(node* s_mix, node const* full_nodes, ethash_light_t light, unsigned num_full_pages)
+{
+	ETHASH_MIX_ACCESSES_LOOP(ethash_fnv_node_scalar)
+}
+
+#if defined(ETHASH_SIMD_X86)
+ETHASH_TARGET("sse4.1")
+static inline void ethash_fnv_node_sse41(node* mix, node const* data)
+{
+	__m128i const fnv_prime = _mm_set1_epi32(FNV_PRIME);
+	for (unsigned w = 0; w != NODE_WORDS; w += 4) {
+		__m128i* const m = (__m128i*)&mix->words[w];
+		__m128i const d = _mm_loadu_si128((__m128i const*)&data->words[w]);
+		_mm_storeu_si128(m, _mm_xor_si128(_mm_mullo_epi32(_mm_loadu_si128(m), fnv_prime), d));
+	}
+}
+
+ETHASH_TARGET("sse4.1")
+static void ethash_dag_parents_sse41(node* ret, uint32_t node_index, node const* cache_nodes, uint32_t num_parent_nodes)
+{
+	ETHASH_DAG_PARENTS_LOOP(ethash_fnv_node_sse41)
+}
+
+ETHASH_TARGET("sse4.1")
+static void ethash_mix_accesses_sse41(node* s_mix, node const* full_nodes, ethash_light_t light, unsigned num_full_pages)
+{
+	ETHASH_MIX_ACCESSES_LOOP(ethash_fnv_node_sse41)
+}
+#endif
+
+static ethash_kernels_t const ethash_kernels_scalar = {
+	ethash_dag_parents_scalar, ethash_mix_accesses_scalar
+};
+#if defined(ETHASH_SIMD_X86)
+static ethash_kernels_t const ethash_kernels_sse41 = {
+	ethash_dag_parents_sse41, ethash_mix_accesses_sse41
+};
+#endif
+
+static ethash_kernels_t const* ethash_kernels_select(void)
+{
+#if defined(ETHASH_SIMD_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	if (info[2] & (1 << 19)) {
+		return &ethash_kernels_sse41;
+	}
+#elif defined(ETHASH_SIMD_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.1")) {
+		return &ethash_kernels_sse41;
+	}
+#endif
+	return &ethash_kernels_scalar;
+}
+
+// picked once on first use, the once call publishes them to every thread
+static ethash_kernels_t const* ethash_kernels_best = NULL;
+static ethash_kernels_t const* ethash_kernels_impl = NULL;
+
+#if defined(_WIN32)
+static INIT_ONCE ethash_kernels_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK ethash_kernels_init(PINIT_ONCE once, PVOID param, PVOID* context)
+{
+	(void)once;
+	(void)param;
+	(void)context;
+	ethash_kernels_best = ethash_kernels_select();
+	ethash_kernels_impl = ethash_kernels_best;
+	return TRUE;
+}
+#else
+static pthread_once_t ethash_kernels_once = PTHREAD_ONCE_INIT;
+
+static void ethash_kernels_init(void)
+{
+	ethash_kernels_best = ethash_kernels_select();
+	ethash_kernels_impl = ethash_kernels_best;
+}
+#endif
+
+static inline ethash_kernels_t const* ethash_kernels(void)
+{
+#if defined(_WIN32)
+	InitOnceExecuteOnce(&ethash_kernels_once, ethash_kernels_init, NULL, NULL);
+#else
+	pthread_once(&ethash_kernels_once, ethash_kernels_init);
+#endif
+	return ethash_kernels_impl;
+}
+
+bool ethash_select_isa(ethash_isa_t isa)
+{
+	ethash_kernels();
+	ethash_kernels_t const* kernels = &ethash_kernels_scalar;
+#if defined(ETHASH_SIMD_X86)
+	if (isa == ETHASH_ISA_SSE41) {
+		if (ethash_kernels_best == &ethash_kernels_scalar) {
+			return false;
+		}
+		kernels = &ethash_kernels_sse41;
+	}
+#else
+	if (isa != ETHASH_ISA_SCALAR) {
+		return false;
+	}
+#endif
+	ethash_kernels_impl = kernels;
+	return true;
+}
+
 void ethash_calculate_dag_item(
 	node* const ret,
 	uint32_t node_index,
@@ -102,39 +283,14 @@ void ethash_calculate_dag_item(
 	memcpy(ret, init, sizeof(node));
 	ret->words[0] ^= node_index;
 	SHA3_512(ret->bytes, ret->bytes, sizeof(node));
-#if defined(_M_X64) && ENABLE_SSE
-	__m128i const fnv_prime = _mm_set1_epi32(FNV_PRIME);
-	__m128i xmm0 = ret->xmm[0];
-	__m128i xmm1 = ret->xmm[1];
-	__m128i xmm2 = ret->xmm[2];
-	__m128i xmm3 = ret->xmm[3];
-#elif defined(__MIC__)
+#if defined(__MIC__)
 	__m512i const fnv_prime = _mm512_set1_epi32(FNV_PRIME);
 	__m512i zmm0 = ret->zmm[0];
-#endif
 
 	for (uint32_t i = 0; i != ETHASH_DATASET_PARENTS; ++i) {
 		uint32_t parent_index = fnv_hash(node_index ^ i, ret->words[i % NODE_WORDS]) % num_parent_nodes;
 		node const *parent = &cache_nodes[parent_index];
 
-#if defined(_M_X64) && ENABLE_SSE
-		{
-			xmm0 = _mm_mullo_epi32(xmm0, fnv_prime);
-			xmm1 = _mm_mullo_epi32(xmm1, fnv_prime);
-			xmm2 = _mm_mullo_epi32(xmm2, fnv_prime);
-			xmm3 = _mm_mullo_epi32(xmm3, fnv_prime);
-			xmm0 = _mm_xor_si128(xmm0, parent->xmm[0]);
-			xmm1 = _mm_xor_si128(xmm1, parent->xmm[1]);
-			xmm2 = _mm_xor_si128(xmm2, parent->xmm[2]);
-			xmm3 = _mm_xor_si128(xmm3, parent->xmm[3]);
-
-			// have to write to ret as values are used to compute index
-			ret->xmm[0] = xmm0;
-			ret->xmm[1] = xmm1;
-			ret->xmm[2] = xmm2;
-			ret->xmm[3] = xmm3;
-		}
-		#elif defined(__MIC__)
 		{
 			zmm0 = _mm512_mullo_epi32(zmm0, fnv_prime);
 
@@ -142,17 +298,77 @@ void ethash_calculate_dag_item(
 			zmm0 = _mm512_xor_si512(zmm0, parent->zmm[0]);
 			ret->zmm[0] = zmm0;
 		}
-		#else
-		{
-			for (unsigned w = 0; w != NODE_WORDS; ++w) {
-				ret->words[w] = fnv_hash(ret->words[w], parent->words[w]);
-			}
-		}
-#endif
 	}
+#else
+	ethash_kernels()->dag_parents(ret, node_index, cache_nodes, num_parent_nodes);
+#endif
 	SHA3_512(ret->bytes, ret->bytes, sizeof(node));
 }
 
+// DAG items are handed out to the generating threads in chunks of this size
+#define ETHASH_DAG_CHUNK_ITEMS 4096
+
+#if defined(_WIN32)
+#define ethash_fetch_add(ptr_, value_) \
+	((uint32_t)InterlockedExchangeAdd((LONG volatile*)(ptr_), (LONG)(value_)))
+#else
+#define ethash_fetch_add(ptr_, value_) __sync_fetch_and_add((ptr_), (value_))
+#endif
+
+static unsigned ethash_dag_threads = 1;
+
+void ethash_set_dag_threads(unsigned threads)
+{
+	ethash_dag_threads = threads ? threads : 1;
+}
+
+unsigned ethash_get_dag_threads(void)
+{
+	return ethash_dag_threads;
+}
+
+typedef struct ethash_dag_job {
+	node* full_nodes;
+	ethash_light_t light;
+	uint32_t max_n;
+	volatile uint32_t next;
+	volatile uint32_t done;
+	volatile int aborted;
+} ethash_dag_job_t;
+
+// computes the next unclaimed chunk of the DAG, false once there is none left
+static bool ethash_dag_job_step(ethash_dag_job_t* job)
+{
+	if (job->aborted) {
+		return false;
+	}
+	uint32_t const begin = ethash_fetch_add(&job->next, ETHASH_DAG_CHUNK_ITEMS);
+	if (begin >= job->max_n) {
+		return false;
+	}
+	uint32_t const end = job->max_n - begin > ETHASH_DAG_CHUNK_ITEMS ?
+		begin + ETHASH_DAG_CHUNK_ITEMS : job->max_n;
+	for (uint32_t n = begin; n != end; ++n) {
+		ethash_calculate_dag_item(&(job->full_nodes[n]), n, job->light);
+	}
+	ethash_fetch_add(&job->done, end - begin);
+	return true;
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI ethash_dag_worker(LPVOID arg)
+{
+	while (ethash_dag_job_step((ethash_dag_job_t*)arg)) {}
+	return 0;
+}
+#else
+static void* ethash_dag_worker(void* arg)
+{
+	while (ethash_dag_job_step((ethash_dag_job_t*)arg)) {}
+	return NULL;
+}
+#endif
+
 bool ethash_compute_full_data(
 	void* mem,
 	uint64_t full_size,
@@ -164,22 +380,60 @@ bool ethash_compute_full_data(
 		(full_size % sizeof(node)) != 0) {
 		return false;
 	}
-	uint32_t const max_n = (uint32_t)(full_size / sizeof(node));
-	node* full_nodes = mem;
-	double const progress_change = 1.0f / max_n;
-	double progress = 0.0f;
-	// now compute full nodes
-	for (uint32_t n = 0; n != max_n; ++n) {
-		if (callback &&
-			n % (max_n / 100) == 0 &&
-			callback((unsigned int)(ceil(progress * 100.0f))) != 0) {
+	ethash_dag_job_t job;
+	job.full_nodes = mem;
+	job.light = light;
+	job.max_n = (uint32_t)(full_size / sizeof(node));
+	job.next = 0;
+	job.done = 0;
+	job.aborted = 0;
+	if (callback && callback(0) != 0) {
+		return false;
+	}
 
-			return false;
+	// the calling thread takes part in the work, so a failed thread creation
+	// only costs parallelism
+	unsigned const workers = ethash_dag_threads - 1;
+	unsigned started = 0;
+#if defined(_WIN32)
+	HANDLE* threads = workers ? calloc(workers, sizeof(HANDLE)) : NULL;
+	for (; threads && started != workers; ++started) {
+		threads[started] = CreateThread(NULL, 0, ethash_dag_worker, &job, 0, NULL);
+		if (!threads[started]) {
+			break;
 		}
-		progress += progress_change;
-		ethash_calculate_dag_item(&(full_nodes[n]), n, light);
 	}
-	return true;
+#else
+	pthread_t* threads = workers ? calloc(workers, sizeof(pthread_t)) : NULL;
+	for (; threads && started != workers; ++started) {
+		if (pthread_create(&threads[started], NULL, ethash_dag_worker, &job) != 0) {
+			break;
+		}
+	}
+#endif
+
+	// now compute full nodes, progress is only reported from this thread
+	unsigned reported = 0;
+	while (ethash_dag_job_step(&job)) {
+		unsigned const progress = (unsigned)((uint64_t)job.done * 100 / job.max_n);
+		if (callback && progress != reported) {
+			reported = progress;
+			if (callback(progress) != 0) {
+				job.aborted = 1;
+			}
+		}
+	}
+
+	for (unsigned i = 0; i != started; ++i) {
+#if defined(_WIN32)
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+#else
+		pthread_join(threads[i], NULL);
+#endif
+	}
+	free(threads);
+	return !job.aborted;
 }
 
 static bool ethash_hash(
@@ -213,49 +467,30 @@ static bool ethash_hash(
 	unsigned const page_size = sizeof(uint32_t) * MIX_WORDS;
 	unsigned const num_full_pages = (unsigned) (full_size / page_size);
 
+#if defined(__MIC__)
 	for (unsigned i = 0; i != ETHASH_ACCESSES; ++i) {
 		uint32_t const index = fnv_hash(s_mix->words[0] ^ i, mix->words[i % MIX_WORDS]) % num_full_pages;
 
 		for (unsigned n = 0; n != MIX_NODES; ++n) {
 			node const* dag_node;
+			node tmp_node;
 			if (full_nodes) {
 				dag_node = &full_nodes[MIX_NODES * index + n];
 			} else {
-				node tmp_node;
 				ethash_calculate_dag_item(&tmp_node, index * MIX_NODES + n, light);
 				dag_node = &tmp_node;
 			}
 
-#if defined(_M_X64) && ENABLE_SSE
-			{
-				__m128i fnv_prime = _mm_set1_epi32(FNV_PRIME);
-				__m128i xmm0 = _mm_mullo_epi32(fnv_prime, mix[n].xmm[0]);
-				__m128i xmm1 = _mm_mullo_epi32(fnv_prime, mix[n].xmm[1]);
-				__m128i xmm2 = _mm_mullo_epi32(fnv_prime, mix[n].xmm[2]);
-				__m128i xmm3 = _mm_mullo_epi32(fnv_prime, mix[n].xmm[3]);
-				mix[n].xmm[0] = _mm_xor_si128(xmm0, dag_node->xmm[0]);
-				mix[n].xmm[1] = _mm_xor_si128(xmm1, dag_node->xmm[1]);
-				mix[n].xmm[2] = _mm_xor_si128(xmm2, dag_node->xmm[2]);
-				mix[n].xmm[3] = _mm_xor_si128(xmm3, dag_node->xmm[3]);
-			}
-			#elif defined(__MIC__)
-			{
-				// __m512i implementation via union
-				//	Each vector register (zmm) can store sixteen 32-bit integer numbers
-				__m512i fnv_prime = _mm512_set1_epi32(FNV_PRIME);
-				__m512i zmm0 = _mm512_mullo_epi32(fnv_prime, mix[n].zmm[0]);
-				mix[n].zmm[0] = _mm512_xor_si512(zmm0, dag_node->zmm[0]);
-			}
-			#else
-			{
-				for (unsigned w = 0; w != NODE_WORDS; ++w) {
-					mix[n].words[w] = fnv_hash(mix[n].words[w], dag_node->words[w]);
-				}
-			}
-#endif
+			// __m512i implementation via union
+			//	Each vector register (zmm) can store sixteen 32-bit integer numbers
+			__m512i fnv_prime = _mm512_set1_epi32(FNV_PRIME);
+			__m512i zmm0 = _mm512_mullo_epi32(fnv_prime, mix[n].zmm[0]);
+			mix[n].zmm[0] = _mm512_xor_si512(zmm0, dag_node->zmm[0]);
 		}
-
 	}
+#else
+	ethash_kernels()->mix_accesses(s_mix, full_nodes, light, num_full_pages);
+#endif
 
 // Workaround for a GCC regression which causes a bogus -Warray-bounds warning.
 // The regression was introduced in GCC 4.8.4, fixed in GCC 5.0.0 and backported to GCC 4.9.3 but
@@ -4,11 +4,7 @@
 #include "ethash.h"
 #include <stdio.h>
 
-#define ENABLE_SSE 0
-
-#if defined(_M_X64) && ENABLE_SSE
-#include <smmintrin.h>
-#elif defined(__MIC__)
+#if defined(__MIC__)
 #include <immintrin.h>
 #endif
 
@@ -27,9 +23,7 @@ typedef union node {
 	uint32_t words[NODE_WORDS];
 	uint64_t double_words[NODE_WORDS / 2];
 
-#if defined(_M_X64) && ENABLE_SSE
-	__m128i xmm[NODE_WORDS/4];
-#elif defined(__MIC__)
+#if defined(__MIC__)
 	__m512i zmm[NODE_WORDS/16];
 #endif
 
@@ -146,6 +140,22 @@ ethash_full_t ethash_full_new_internal(
 	ethash_callback_t callback
 );
 
+/// Instruction sets of the FNV loops, the best one the CPU supports is
+/// picked on first use.
+typedef enum ethash_isa {
+	ETHASH_ISA_SCALAR,
+	ETHASH_ISA_SSE41
+} ethash_isa_t;
+
+/**
+ * Use the FNV loops of an instruction set, for comparing them in tests.
+ * Must not be called while hashes are being computed.
+ *
+ * @param isa            The instruction set
+ * @return               false if the CPU does not support it
+ */
+bool ethash_select_isa(ethash_isa_t isa);
+
 void ethash_calculate_dag_item(
 	node* const ret,
 	uint32_t node_index,
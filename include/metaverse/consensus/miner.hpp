@@ -72,8 +72,8 @@ public:
         exit_
     };
 
-    bool start(const wallet::payment_address& pay_address, uint16_t number = 0);
-    bool start(const std::string& pay_public_key, uint16_t number = 0);
+    bool start(const wallet::payment_address& pay_address, uint16_t number = 0, uint16_t threads = 0);
+    bool start(const std::string& pay_public_key, uint16_t number = 0, uint16_t threads = 0);
     bool stop();
     static block_ptr create_genesis_block(bool is_mainnet);
     bool script_hash_signature_operations_count(size_t &count, const chain::input::list& inputs,
@@ -113,6 +113,7 @@ private:
     mutable state state_;
     uint16_t new_block_number_;
     uint16_t new_block_limit_;
+    uint16_t threads_;
 
     block_ptr new_block_;
     wallet::payment_address pay_address_;
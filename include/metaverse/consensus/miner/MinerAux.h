@@ -1,12 +1,20 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 #include <thread>
 #include <metaverse/consensus/libethash/ethash.h>
 #include <metaverse/consensus/libdevcore/Log.h>
 #include <metaverse/consensus/libdevcore/BasicType.h>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/bitcoin/utility/FixedHash.h>
+#include <metaverse/bitcoin/utility/threadpool.hpp>
 #include <metaverse/consensus/libdevcore/Guards.h>
 
 namespace libbitcoin
@@ -23,23 +31,51 @@ public:
 	static void setMixHash(chain::header& _bi, h256& _v){_bi.mixhash = (FixedHash<32>::Arith)_v; }
 	static LightType get_light(h256& _seedHash);
 	static FullType get_full(h256& _seedHash);
+	/// Generate the DAG of the epoch after _header's in the background.
+	static void prepare_next(chain::header& _header);
+	static void set_dag_threads(unsigned _threads);
+	static void set_dag_pregenerate(bool _enable) { get()->m_pregenerate = _enable; }
+	/// Abort DAG generation, join the background preparations and refuse
+	/// new ones, called once at shutdown.
+	static void stop();
+	static bool stopped() { return get()->m_stopped; }
 	static bool verifySeal(chain::header& header,chain::header& _parent);
-	static bool search(chain::header& header, std::function<bool (void)> is_exit);
+	enum class Seal : uint8_t { unchecked, valid, invalid };
+	/// Verify (header, parent) pairs on the pool and the calling thread,
+	/// a pair whose check threw is left unchecked.
+	static std::vector<Seal> verifySeals(threadpool& _pool, const std::vector<std::pair<chain::header*, chain::header*>>& _items);
+	/// Search the nonce space of header on the given number of threads,
+	/// is_exit is polled from the calling thread only.
+	static bool search(chain::header& header, std::function<bool (void)> is_exit, unsigned threads = 1);
     static uint64_t getRate(){ return get()->m_rate; }
 
 
 
 private:
-	MinerAux() {m_rate = 0;}
+	MinerAux() {m_rate = 0; m_pregenerate = false; m_stopped = false;}
+	static FullType load_full(h256& _seedHash, bool _next);
+	static void warm_light(h256 _seedHash);
+	/// Run _job on a tracked thread, false once stopped.
+	static bool spawn(std::function<void()> _job);
+	/// Light caches kept around: syncing, mining and the next epoch.
+	static constexpr size_t c_maxLights = 4;
     static MinerAux* s_this;
     SharedMutex x_lights;
     std::unordered_map<h256, std::shared_ptr<LightAllocation>> m_lights;
+    std::deque<h256> m_lightOrder;
+    std::unordered_set<h256> m_lightsWarming;
     Mutex x_fulls;
     std::condition_variable m_fullsChanged;
     std::unordered_map<h256, std::weak_ptr<FullAllocation>> m_fulls;
+    std::unordered_set<h256> m_generating;
     FullType m_lastUsedFull;
+    FullType m_nextFull;
+    std::atomic<bool> m_pregenerate;
+    Mutex x_workers;
+    std::vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> m_workers;
+    std::atomic<bool> m_stopped;
    // uint64_t m_hashCount;
-    uint64_t m_rate;
+    std::atomic<uint64_t> m_rate;
 
 
 
@@ -24,11 +24,15 @@
 #include <metaverse/database/databases/spend_database.hpp>
 #include <metaverse/database/databases/stealth_database.hpp>
 #include <metaverse/database/databases/transaction_database.hpp>
+#include <metaverse/database/databases/utxo_database.hpp>
+#include <metaverse/database/databases/address_balance_database.hpp>
 #include <metaverse/database/memory/accessor.hpp>
 #include <metaverse/database/memory/allocator.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/memory/write_journal.hpp>
 #include <metaverse/database/primitives/hash_table_header.hpp>
+#include <metaverse/database/primitives/lock_stripes.hpp>
 #include <metaverse/database/primitives/record_hash_table.hpp>
 #include <metaverse/database/primitives/record_list.hpp>
 #include <metaverse/database/primitives/record_manager.hpp>
@@ -22,8 +22,10 @@
 #define MVS_DATABASE_DATA_BASE_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -57,6 +59,9 @@
 #include <metaverse/database/databases/blockchain_mit_database.hpp>
 #include <metaverse/database/databases/address_mit_database.hpp>
 #include <metaverse/database/databases/mit_history_database.hpp>
+#include <metaverse/database/databases/utxo_database.hpp>
+#include <metaverse/database/databases/address_balance_database.hpp>
+#include <metaverse/database/memory/write_journal.hpp>
 
 using namespace libbitcoin::wallet;
 using namespace libbitcoin::chain;
@@ -82,8 +87,15 @@ public:
         bool certs_exist() const;
         bool touch_mits() const;
         bool mits_exist() const;
+        bool touch_utxos() const;
+        bool utxos_exist() const;
+        bool touch_balances() const;
+        bool balances_exist() const;
+        bool touch_journal() const;
+        bool journal_exists() const;
 
         path database_lock;
+        path journal;
         path blocks_lookup;
         path blocks_index;
         path history_lookup;
@@ -91,6 +103,10 @@ public:
         path stealth_rows;
         path spends_lookup;
         path transactions_lookup;
+        path utxos_lookup;
+        path balances_lookup;
+        path balances_outputs;
+        path balances_rows;
         /* begin database for account, asset, address_asset, did relationship */
         path accounts_lookup;
         path assets_lookup;
@@ -158,6 +174,8 @@ public:
     bool create_dids();
     bool create_certs();
     bool create_mits();
+    bool create_utxos();
+    bool create_balances();
 
     /// Start all databases.
     bool start();
@@ -177,6 +195,9 @@ public:
     bool is_read_valid(handle handle);
     bool is_write_locked(handle handle);
 
+    /// Block until the write that locked the handle has ended.
+    void wait_write(handle handle);
+
     // Push and pop.
     // ------------------------------------------------------------------------
 
@@ -316,6 +337,9 @@ private:
     static bool initialize_dids(const path& prefix);
     static bool initialize_certs(const path& prefix);
     static bool initialize_mits(const path& prefix);
+    static bool initialize_utxos(const path& prefix);
+    static bool initialize_balances(const path& prefix);
+    static bool initialize_journal(const path& prefix);
 
     static void uninitialize_lock(const path& lock);
     static file_lock initialize_lock(const path& lock);
@@ -325,12 +349,20 @@ private:
     void synchronize_certs();
     void synchronize_mits();
 
+    void presize(const chain::block& block, size_t height);
     void push_inputs(const hash_digest& tx_hash, size_t height,
         const inputs& inputs);
     void push_outputs(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
     void push_stealth(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
+    void push_utxos(const chain::transaction& tx, const hash_digest& tx_hash,
+        size_t height);
+    void pop_utxos(const chain::transaction& tx);
+    void push_balances(const chain::transaction& tx,
+        const hash_digest& tx_hash, size_t height);
+    void pop_balances(const chain::transaction& tx);
+    bool index_balances();
     void pop_inputs(const inputs& inputs, size_t height);
     void pop_outputs(const outputs& outputs, size_t height);
 
@@ -341,6 +373,10 @@ private:
     // Atomic counter for implementing the sequential lock pattern.
     sequential_lock sequential_lock_;
 
+    // Wakes readers waiting on a write as soon as it ends.
+    std::mutex write_mutex_;
+    std::condition_variable write_completed_;
+
     // Allows us to restrict database access to our process (or fail).
     std::shared_ptr<file_lock> file_lock_;
 
@@ -350,6 +386,9 @@ private:
     // temp block timestamp
     uint32_t timestamp_;
 
+    // Undo log of the block write in progress, recovered on start.
+    write_journal journal_;
+
 public:
 
     /// Individual database query engines.
@@ -358,6 +397,8 @@ public:
     spend_database spends;
     stealth_database stealth;
     transaction_database transactions;
+    utxo_database utxos;
+    address_balance_database balances;
     /* begin database for account, asset, address_asset,did relationship */
     account_database accounts;
     blockchain_asset_database assets;
@@ -21,6 +21,7 @@
 #ifndef MVS_DATABASE_ADDRESS_ASSET_DATABASE_HPP
 #define MVS_DATABASE_ADDRESS_ASSET_DATABASE_HPP
 
+#include <functional>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -101,6 +102,12 @@ public:
     std::shared_ptr<business_record::list> get(const std::string& address, const std::string& symbol,
         size_t start_height, size_t end_height, uint64_t limit, uint64_t page_number) const;
     std::shared_ptr<business_record::list> get(size_t idx) const;
+
+    /// Visit the rows of key newest first, until the visitor returns false.
+    /// Rows are added block by block so their heights never increase along
+    /// the list, rows above max_height are skipped on their height alone.
+    void scan(const short_hash& key, size_t max_height,
+        std::function<bool(const business_record&)> visitor) const;
     business_record get_record(size_t idx) const;
 
     business_history::list get_business_history(const short_hash& key, size_t from_height) const;
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_ADDRESS_BALANCE_DATABASE_HPP
+#define MVS_DATABASE_ADDRESS_BALANCE_DATABASE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_hash_table.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+struct BCD_API address_output
+{
+    typedef std::vector<address_output> list;
+
+    /// The address hash the output pays to.
+    short_hash key;
+
+    chain::output_point point;
+
+    /// Height of the block containing the output.
+    uint32_t height;
+
+    uint64_t value;
+
+    /// Height from which the output is spendable, zero if never locked.
+    /// Deposits and coinbase outputs are locked.
+    uint64_t unlock_height;
+};
+
+struct BCD_API address_balance
+{
+    /// Sum of the values of every confirmed output to the address.
+    uint64_t received;
+
+    /// Sum of the values of the confirmed outputs not spent by the chain.
+    uint64_t unspent;
+
+    /// The confirmed unspent outputs that have a lock height.
+    address_output::list locked;
+};
+
+/// This maintains the confirmed balance of each address along with the set
+/// of its unspent outputs, so that a balance is read without expanding the
+/// address history. Outputs are indexed by outpoint, each address chains
+/// its unspent outputs (locked ones separately) in a doubly linked list.
+/// An index created over an existing chain is complete once the confirmed
+/// blocks have been indexed, see complete().
+class BCD_API address_balance_database
+{
+public:
+    /// Construct the database.
+    address_balance_database(const boost::filesystem::path& lookup_filename,
+        const boost::filesystem::path& outputs_filename,
+        const boost::filesystem::path& rows_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~address_balance_database();
+
+    /// Initialize a new balance database, complete if the chain is empty.
+    bool create(bool complete);
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// True if the index covers every block of the chain.
+    bool complete() const;
+
+    /// Record that the blocks preceding the index have been indexed.
+    void set_complete();
+
+    /// Get the confirmed balance of an address, zero if it has none.
+    address_balance get(const short_hash& key) const;
+
+    /// Get a confirmed unspent output, false if not indexed or spent.
+    bool get(const chain::output_point& point, address_output& out) const;
+
+    /// Get the confirmed unspent outputs of an address.
+    address_output::list get_unspent(const short_hash& key) const;
+
+    /// Add a confirmed output of an address.
+    void store(const short_hash& key, const chain::output_point& point,
+        uint32_t height, uint64_t value, uint64_t unlock_height);
+
+    /// Mark a confirmed output spent, ignored if it is not indexed.
+    void spend(const chain::output_point& point);
+
+    /// Revert spend, when popping a block.
+    void unspend(const chain::output_point& point);
+
+    /// Revert store, when popping a block.
+    void remove(const chain::output_point& point);
+
+    /// Synchronise storage with disk so things are consistent.
+    /// Should be done at the end of every block write.
+    void sync();
+
+private:
+    typedef record_hash_table<short_hash> balance_map;
+    typedef record_hash_table<chain::point> output_map;
+
+    array_index find_row(const chain::output_point& point) const;
+    address_output read_row(array_index row) const;
+    bool is_spent(array_index row) const;
+    array_index read_link(array_index row, file_offset offset) const;
+    void append(address_output::list& outputs, array_index first) const;
+
+    void link(const short_hash& key, array_index row, bool locked);
+    void unlink(array_index row);
+    void write_link(array_index row, file_offset offset, array_index value);
+    void write_spent(array_index row, bool spent);
+    void add_unspent(const short_hash& key, int64_t received,
+        int64_t unspent);
+
+    // Hash table of the balance of each address.
+    memory_map lookup_file_;
+    record_hash_table_header lookup_header_;
+    record_manager lookup_manager_;
+    balance_map lookup_map_;
+
+    // Hash table of the row of each indexed output.
+    memory_map outputs_file_;
+    record_hash_table_header outputs_header_;
+    record_manager outputs_manager_;
+    output_map outputs_map_;
+
+    // Output rows, the first row records whether the index is complete.
+    memory_map rows_file_;
+    record_manager rows_manager_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -84,6 +84,9 @@ public:
     chain::history_compact::list get(const short_hash& key, size_t limit,
         size_t from_height) const;
 
+    /// Presize the rows file for count more rows.
+    void reserve(size_t count);
+
     /// Synchonise with disk.
     void sync();
 
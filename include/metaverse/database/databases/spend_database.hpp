@@ -76,6 +76,9 @@ public:
     /// Delete outpoint spend item from database.
     void remove(const chain::output_point& outpoint);
 
+    /// Presize the table for count more spends.
+    void reserve(size_t count);
+
     /// Synchronise storage with disk so things are consistent.
     /// Should be done at the end of every block write.
     void sync();
@@ -70,6 +70,9 @@ public:
     /// Delete a transaction from database.
     void remove(const hash_digest& hash);
 
+    /// Presize the table for count more transactions of size total bytes.
+    void reserve(size_t count, size_t size);
+
     /// Synchronise storage with disk so things are consistent.
     /// Should be done at the end of every block write.
     void sync();
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_UTXO_DATABASE_HPP
+#define MVS_DATABASE_UTXO_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/primitives/slab_hash_table.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+struct BCD_API unspent_output
+{
+    /// False if the outpoint is not in the unspent output set.
+    bool valid;
+
+    /// Height of the block containing the output.
+    uint32_t height;
+
+    /// True if the output belongs to a coinbase transaction.
+    bool coinbase;
+
+    /// The output, including its attachment.
+    chain::output output;
+};
+
+/// This enables you to lookup the confirmed unspent outputs of the chain
+/// without loading and deserializing the whole previous transaction.
+/// Recently used entries are kept deserialized in memory; writes go through
+/// to the memory map, which is flushed to disk by sync.
+/// The set only covers outputs confirmed since the table was created, so a
+/// missing entry does not imply that the output is spent.
+class BCD_API utxo_database
+{
+public:
+    static const size_t default_cache_capacity;
+
+    /// Construct the database.
+    utxo_database(const boost::filesystem::path& filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr,
+        size_t cache_capacity=default_cache_capacity);
+
+    /// Close the database (all threads must first be stopped).
+    ~utxo_database();
+
+    /// Initialize a new utxo database.
+    bool create();
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Get the unspent output of an output point.
+    unspent_output get(const chain::output_point& outpoint) const;
+
+    /// Store an unspent output in the database.
+    void store(const chain::output_point& outpoint, uint32_t height,
+        bool coinbase, const chain::output& output);
+
+    /// Delete an output from the set, returns false if it was not present.
+    bool remove(const chain::output_point& outpoint);
+
+    /// Presize the table for count more outputs of size total bytes.
+    void reserve(size_t count, size_t size);
+
+    /// Synchronise storage with disk so things are consistent.
+    /// Should be done at the end of every block write.
+    void sync();
+
+private:
+    typedef slab_hash_table<chain::point> slab_map;
+    typedef std::pair<chain::output_point, unspent_output> cache_entry;
+    typedef std::list<cache_entry> cache_list;
+    typedef std::unordered_map<chain::output_point, cache_list::iterator>
+        cache_index;
+
+    void cache(const unspent_output& entry,
+        const chain::output_point& outpoint) const;
+    void uncache(const chain::output_point& outpoint);
+
+    // Hash table used for looking up unspent outputs by outpoint.
+    memory_map lookup_file_;
+    slab_hash_table_header lookup_header_;
+    slab_manager lookup_manager_;
+    slab_map lookup_map_;
+
+    // Most recently used entries first, the generation advances on writes.
+    const size_t cache_capacity_;
+    mutable cache_list cache_list_;
+    mutable cache_index cache_index_;
+    mutable uint64_t cache_generation_;
+    mutable unique_mutex cache_mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
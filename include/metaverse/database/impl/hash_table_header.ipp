@@ -35,24 +35,45 @@ template <typename IndexType, typename ValueType>
 const ValueType hash_table_header<IndexType, ValueType>::empty =
     (ValueType)bc::max_uint64;
 
+template <typename IndexType, typename ValueType>
+const IndexType hash_table_header<IndexType, ValueType>::version_flag =
+    IndexType(1) << (sizeof(IndexType) * byte_bits - 1);
+
+//  [ version:4 ][ buckets ][ entries:8 ][ item ][ segments ]
+template <typename IndexType, typename ValueType>
+const size_t hash_table_header<IndexType, ValueType>::directory_size =
+    sizeof(uint32_t) + sizeof(IndexType) + sizeof(uint64_t) +
+    sizeof(ValueType) + max_segments * sizeof(file_offset);
+
+template <typename IndexType, typename ValueType>
+const double hash_table_header<IndexType, ValueType>::load_factor = 0.75;
+
+static constexpr uint32_t hash_table_header_version = 1;
+
 template <typename IndexType, typename ValueType>
 hash_table_header<IndexType, ValueType>::hash_table_header(memory_map& file,
     IndexType buckets)
-  : file_(file), buckets_(buckets)
+  : file_(file),
+    buckets_(buckets),
+    size_(buckets),
+    growable_(false),
+    entries_(0),
+    directory_(0)
 {
     BITCOIN_ASSERT_MSG(empty == (ValueType)0xffffffffffffffff,
         "Unexpected value for empty sentinel.");
 
     static_assert(std::is_unsigned<ValueType>::value,
         "Hash table header requires unsigned type.");
+
+    segments_.fill(0);
 }
 
 template <typename IndexType, typename ValueType>
 bool hash_table_header<IndexType, ValueType>::create()
 {
     // Cannot create zero-sized hash table.
-    // If buckets_ == 0 we trust what is read from the file.
-    if (buckets_ == 0)
+    if (buckets_ == 0 || (buckets_ & version_flag) != 0)
         return false;
 
     // Calculate the minimum file size.
@@ -79,10 +100,8 @@ bool hash_table_header<IndexType, ValueType>::create()
 template <typename IndexType, typename ValueType>
 bool hash_table_header<IndexType, ValueType>::start()
 {
-    const auto minimum_file_size = item_position(buckets_);
-
     // Header file is too small.
-    if (minimum_file_size > file_.size())
+    if (sizeof(IndexType) > file_.size())
         return false;
 
     // The accessor must remain in scope until the end of the block.
@@ -90,52 +109,319 @@ bool hash_table_header<IndexType, ValueType>::start()
     const auto buckets_address = REMAP_ADDRESS(memory);
 
     // Does not require atomicity (no concurrency during start).
-    const auto buckets = from_little_endian_unsafe<IndexType>(buckets_address);
+    const auto value = from_little_endian_unsafe<IndexType>(buckets_address);
+    const auto buckets = static_cast<IndexType>(value & ~version_flag);
+
+    // Header file is too small.
+    if (buckets == 0 || item_position(buckets) > file_.size())
+        return false;
 
-    // If buckets_ == 0 we trust what is read from the file.
-    return buckets_ == 0 || buckets == buckets_;
+    // The size in the file supersedes the size used for creation.
+    buckets_ = buckets;
+    size_ = buckets;
+    entries_ = 0;
+    directory_ = 0;
+    segments_.fill(0);
+    growable_ = (value & version_flag) != 0;
+    return true;
 }
 
 template <typename IndexType, typename ValueType>
-ValueType hash_table_header<IndexType, ValueType>::read(IndexType index) const
+bool hash_table_header<IndexType, ValueType>::growable() const
 {
-    // This is not runtime safe but test is avoided as an optimization.
-    BITCOIN_ASSERT(index < buckets_);
-    
+    return growable_;
+}
+
+template <typename IndexType, typename ValueType>
+ValueType hash_table_header<IndexType, ValueType>::directory() const
+{
+    BITCOIN_ASSERT(growable_);
+
     // The accessor must remain in scope until the end of the block.
     const auto memory = file_.access();
-    const auto value_address = REMAP_ADDRESS(memory) + item_position(index);
+    const auto address = REMAP_ADDRESS(memory) + item_position(0);
+    return from_little_endian_unsafe<ValueType>(address);
+}
+
+template <typename IndexType, typename ValueType>
+bool hash_table_header<IndexType, ValueType>::load(file_offset offset)
+{
+    if (!growable_ || offset + directory_size > file_.size())
+        return false;
+
+    std::array<file_offset, max_segments> segments;
+
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = file_.access();
+    auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory) + offset);
+    const auto version = deserial.read_4_bytes_little_endian();
+    const auto buckets = deserial.template read_little_endian<IndexType>();
+    const auto entries = deserial.read_8_bytes_little_endian();
+    deserial.template read_little_endian<ValueType>();
+
+    for (auto& segment: segments)
+        segment = deserial.read_8_bytes_little_endian();
+
+    if (version != hash_table_header_version || buckets < buckets_ ||
+        (buckets & version_flag) != 0)
+        return false;
+
+    // Every bucket below the size must be in an attached segment.
+    for (uint64_t first = buckets_, slot = 0; first < buckets;
+        first *= 2, ++slot)
+    {
+        const auto end = segments[slot] + first * sizeof(ValueType);
+        if (segments[slot] == 0 || end > file_.size())
+            return false;
+    }
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(mutex_);
-    return from_little_endian_unsafe<ValueType>(value_address);
+    unique_lock lock(mutex_);
+
+    entries_ = entries;
+    directory_ = offset;
+    segments_ = segments;
+    size_ = buckets;
+    return true;
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// The directory is written and its position published last, an interruption
+// leaves an unreferenced directory and the version 0 header intact.
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::upgrade(ValueType position,
+    file_offset offset, uint64_t entries)
+{
+    BITCOIN_ASSERT(!growable_);
+    BITCOIN_ASSERT(offset + directory_size <= file_.size());
+
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = file_.access();
+    const auto start = REMAP_ADDRESS(memory);
+    const auto first = from_little_endian_unsafe<ValueType>(
+        start + item_position(0));
+
+    auto directory = make_serializer(start + offset);
+    directory.write_4_bytes_little_endian(hash_table_header_version);
+    directory.template write_little_endian<IndexType>(buckets_);
+    directory.write_8_bytes_little_endian(entries);
+    directory.template write_little_endian<ValueType>(first);
+
+    for (size_t slot = 0; slot < max_segments; ++slot)
+        directory.write_8_bytes_little_endian(0);
+
+    auto header = make_serializer(start);
+    header.template write_little_endian<IndexType>(buckets_ | version_flag);
+    header.template write_little_endian<ValueType>(position);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    growable_ = true;
+    entries_ = entries;
+    directory_ = offset;
+    segments_.fill(0);
+    size_ = buckets_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename IndexType, typename ValueType>
+ValueType hash_table_header<IndexType, ValueType>::read(IndexType index) const
+{
+    // This is not runtime safe but test is avoided as an optimization.
+    BITCOIN_ASSERT(index < size_);
+    
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = file_.access();
+    const auto value_address = REMAP_ADDRESS(memory) + item_offset(index);
+    return from_little_endian_unsafe<ValueType>(value_address);
+}
+
 template <typename IndexType, typename ValueType>
 void hash_table_header<IndexType, ValueType>::write(IndexType index,
     ValueType value)
 {
     // This is not runtime safe but test is avoided as an optimization.
-    BITCOIN_ASSERT(index < buckets_);
+    BITCOIN_ASSERT(index < size_);
     
     // The accessor must remain in scope until the end of the block.
     const auto memory = file_.access();
-    const auto value_address = REMAP_ADDRESS(memory) + item_position(index);
+    const auto value_address = REMAP_ADDRESS(memory) + item_offset(index);
+    file_.preserve(value_address, sizeof(ValueType));
     auto serial = make_serializer(value_address);
+    serial.template write_little_endian<ValueType>(value);
+}
+
+template <typename IndexType, typename ValueType>
+IndexType hash_table_header<IndexType, ValueType>::size() const
+{
+    return size_;
+}
+
+template <typename IndexType, typename ValueType>
+IndexType hash_table_header<IndexType, ValueType>::bucket(size_t hash) const
+{
+    return bucket(hash, size_);
+}
+
+template <typename IndexType, typename ValueType>
+uint64_t hash_table_header<IndexType, ValueType>::entries() const
+{
+    return entries_;
+}
+
+// The count is persisted by sync, once per block, or the next split.
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::add_entry()
+{
+    ++entries_;
+}
+
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::remove_entry()
+{
+    BITCOIN_ASSERT(entries_ > 0);
+    --entries_;
+}
+
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::sync()
+{
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = file_.access();
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     unique_lock lock(mutex_);
-    serial.template write_little_endian<ValueType>(value);
+    write_directory(REMAP_ADDRESS(memory));
     ///////////////////////////////////////////////////////////////////////////
 }
 
 template <typename IndexType, typename ValueType>
-IndexType hash_table_header<IndexType, ValueType>::size() const
+bool hash_table_header<IndexType, ValueType>::overloaded() const
+{
+    const uint64_t buckets = size_;
+
+    // The size must remain distinguishable from the version flag.
+    if (directory_ == 0 || buckets + 1 >= version_flag)
+        return false;
+
+    return entries_ > load_factor * buckets;
+}
+
+template <typename IndexType, typename ValueType>
+size_t hash_table_header<IndexType, ValueType>::segment_size() const
+{
+    IndexType first;
+    const auto slot = segment(size_, first);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return segments_[slot] == 0 ? first * sizeof(ValueType) : 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::add_segment(file_offset offset)
+{
+    IndexType first;
+    const auto slot = segment(size_, first);
+    BITCOIN_ASSERT(offset + first * sizeof(ValueType) <= file_.size());
+
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = file_.access();
+    const auto start = REMAP_ADDRESS(memory);
+
+    // The segment is new, it is not journaled.
+    memset(start + offset, 0xff, first * sizeof(ValueType));
+
+    const auto segments_position = sizeof(uint32_t) + sizeof(IndexType) +
+        sizeof(uint64_t) + sizeof(ValueType);
+    const auto slot_address = start + directory_ + segments_position +
+        slot * sizeof(file_offset);
+    file_.preserve(slot_address, sizeof(file_offset));
+    auto serial = make_serializer(slot_address);
+    serial.write_8_bytes_little_endian(offset);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    segments_[slot] = offset;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename IndexType, typename ValueType>
+IndexType hash_table_header<IndexType, ValueType>::split_bucket() const
+{
+    const uint64_t buckets = size_;
+    uint64_t round = buckets_;
+
+    while (round * 2 <= buckets)
+        round *= 2;
+
+    return static_cast<IndexType>(buckets - round);
+}
+
+template <typename IndexType, typename ValueType>
+IndexType hash_table_header<IndexType, ValueType>::split_target(
+    size_t hash) const
+{
+    return bucket(hash, size_ + 1);
+}
+
+// The new bucket is written before it is addressable, readers of the split
+// bucket may miss entries until the split is complete (see hash tables).
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::split(ValueType low,
+    ValueType high)
+{
+    BITCOIN_ASSERT(segment_size() == 0);
+    const IndexType buckets = size_;
+    const auto bucket = split_bucket();
+
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        // The accessor must remain in scope until the end of the block.
+        const auto memory = file_.access();
+        const auto start = REMAP_ADDRESS(memory);
+
+        // Critical Section
+        unique_lock lock(mutex_);
+
+        const auto high_address = start + item_offset(buckets);
+        file_.preserve(high_address, sizeof(ValueType));
+        auto high_serial = make_serializer(high_address);
+        high_serial.template write_little_endian<ValueType>(high);
+
+        size_ = buckets + 1;
+
+        const auto low_address = start + item_offset(bucket);
+        file_.preserve(low_address, sizeof(ValueType));
+        auto low_serial = make_serializer(low_address);
+        low_serial.template write_little_endian<ValueType>(low);
+
+        write_directory(start);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+template <typename IndexType, typename ValueType>
+IndexType hash_table_header<IndexType, ValueType>::bucket(size_t hash,
+    IndexType buckets) const
 {
-    return buckets_;
+    // Linear hashing, the hash modulo twice the size of the current round
+    // unless that bucket has not yet been split off in this round.
+    uint64_t round = buckets_;
+
+    while (round * 2 <= buckets)
+        round *= 2;
+
+    const uint64_t index = hash % (round * 2);
+    return static_cast<IndexType>(index < buckets ? index : hash % round);
 }
 
 template <typename IndexType, typename ValueType>
@@ -145,6 +431,58 @@ file_offset hash_table_header<IndexType, ValueType>::item_position(
     return sizeof(IndexType) + index * sizeof(ValueType);
 }
 
+template <typename IndexType, typename ValueType>
+file_offset hash_table_header<IndexType, ValueType>::item_offset(
+    IndexType index) const
+{
+    // The first item of a version 1 header is moved to the directory.
+    if (directory_ == 0 || (index != 0 && index < buckets_))
+        return item_position(index);
+
+    if (index == 0)
+        return directory_ + sizeof(uint32_t) + sizeof(IndexType) +
+            sizeof(uint64_t);
+
+    IndexType first;
+    const auto slot = segment(index, first);
+    BITCOIN_ASSERT(segments_[slot] != 0);
+    return segments_[slot] + (index - first) * sizeof(ValueType);
+}
+
+template <typename IndexType, typename ValueType>
+size_t hash_table_header<IndexType, ValueType>::segment(IndexType index,
+    IndexType& first) const
+{
+    BITCOIN_ASSERT(index >= buckets_);
+    uint64_t start = buckets_;
+    size_t slot = 0;
+
+    while (index >= start * 2)
+    {
+        start *= 2;
+        ++slot;
+    }
+
+    BITCOIN_ASSERT(slot < max_segments);
+    first = static_cast<IndexType>(start);
+    return slot;
+}
+
+template <typename IndexType, typename ValueType>
+void hash_table_header<IndexType, ValueType>::write_directory(
+    uint8_t* start)
+{
+    if (directory_ == 0)
+        return;
+
+    const auto address = start + directory_ + sizeof(uint32_t);
+
+    file_.preserve(address, sizeof(IndexType) + sizeof(uint64_t));
+    auto serial = make_serializer(address);
+    serial.template write_little_endian<IndexType>(size_);
+    serial.write_8_bytes_little_endian(entries_);
+}
+
 } // namespace database
 } // namespace libbitcoin
 
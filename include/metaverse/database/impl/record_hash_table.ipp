@@ -21,8 +21,10 @@
 #ifndef MVS_DATABASE_RECORD_HASH_TABLE_IPP
 #define MVS_DATABASE_RECORD_HASH_TABLE_IPP
 
+#include <functional>
 #include <string>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include "record_row.ipp"
 #include "remainder.ipp"
@@ -33,10 +35,51 @@ namespace database {
 template <typename KeyType>
 record_hash_table<KeyType>::record_hash_table(
     record_hash_table_header& header, record_manager& manager)
-  : header_(header), manager_(manager)
+  : header_(header), manager_(manager), sequence_(0)
 {
 }
 
+template <typename KeyType>
+bool record_hash_table<KeyType>::create()
+{
+    return header_.create() && manager_.create();
+}
+
+template <typename KeyType>
+bool record_hash_table<KeyType>::start()
+{
+    if (!header_.start())
+        return false;
+
+    // The records follow the header, which is sized by the file.
+    manager_.set_header_size(record_hash_table_header_size(header_.size()));
+
+    if (!manager_.start())
+        return false;
+
+    if (header_.growable())
+    {
+        const auto index = header_.directory();
+        return index < manager_.count() &&
+            header_.load(manager_.file_position(index));
+    }
+
+    // Records are never reused, each is an entry stored in the table.
+    const uint64_t entries = manager_.count();
+
+    // The directory is referenced only once its allocation is synchronized.
+    const auto index = allocate(record_hash_table_header::directory_size);
+    manager_.sync();
+    header_.upgrade(index, manager_.file_position(index), entries);
+
+    if (entries != 0)
+        log::info(LOG_DATABASE)
+            << "Upgraded hash table header of " << header_.size()
+            << " buckets and " << entries << " entries.";
+
+    return true;
+}
+
 // This is not limited to storing unique key values. If duplicate keyed values
 // are store then retrieval and unlinking will fail as these multiples cannot
 // be differentiated.
@@ -44,21 +87,46 @@ template <typename KeyType>
 void record_hash_table<KeyType>::store(const KeyType& key,
     const write_function write)
 {
-	mutex_.lock();
-    // Store current bucket value.
-    const auto old_begin = read_bucket_value(key);
+    // The record is not reachable until linked, so it is written unlocked.
     record_row<KeyType> item(manager_, 0);
-    const auto new_begin = item.create(key, old_begin);
+    const auto new_begin = item.create(key, header_.empty);
     write(item.data());
 
-    // Link record to header.
-    link(key, new_begin);
-    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        // Critical Section
+        shared_lock table(mutex_);
+        const auto bucket = bucket_index(key);
+        scoped_lock lock(stripes_.mutex(stripes_.stripe(bucket)));
+
+        // Chain the current bucket value and link record to header.
+        item.write_next_index(header_.read(bucket));
+        header_.write(bucket, new_begin);
+        header_.add_entry();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    grow();
 }
 
 // This is limited to returning the first of multiple matching key values.
 template <typename KeyType>
 const memory_ptr record_hash_table<KeyType>::find(const KeyType& key) const
+{
+    while (true)
+    {
+        const size_t sequence = sequence_;
+        const auto memory = find_first(key);
+
+        // A key moved by a concurrent split may have been missed.
+        if (memory || unchanged(sequence))
+            return memory;
+    }
+}
+
+template <typename KeyType>
+const memory_ptr record_hash_table<KeyType>::find_first(
+    const KeyType& key) const
 {
     // Find start item...
     auto current = read_bucket_value(key);
@@ -120,14 +188,21 @@ std::shared_ptr<std::vector<memory_ptr>> record_hash_table<KeyType>::find(array_
 template <typename KeyType>
 bool record_hash_table<KeyType>::unlink(const KeyType& key)
 {
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock table(mutex_);
+    const auto bucket = bucket_index(key);
+    scoped_lock lock(stripes_.mutex(stripes_.stripe(bucket)));
+
     // Find start item...
-    const auto begin = read_bucket_value(key);
+    const auto begin = header_.read(bucket);
     const record_row<KeyType> begin_item(manager_, begin);
 
     // If start item has the key then unlink from buckets.
     if (begin_item.compare(key))
     {
-        link(key, begin_item.next_index());
+        header_.write(bucket, begin_item.next_index());
+        header_.remove_entry();
         return true;
     }
 
@@ -144,6 +219,7 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
         if (item.compare(key))
         {
             release(item, previous);
+            header_.remove_entry();
             return true;
         }
 
@@ -160,11 +236,104 @@ bool record_hash_table<KeyType>::unlink(const KeyType& key)
     return false;
 }
 
+template <typename KeyType>
+void record_hash_table<KeyType>::preserve(const uint8_t* address, size_t size)
+{
+    manager_.preserve(address, size);
+}
+
+template <typename KeyType>
+void record_hash_table<KeyType>::grow()
+{
+    if (!header_.overloaded())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Another writer may have split while this one waited. Two splits per
+    // store outpace the 4/3 buckets required per entry, so a table that has
+    // fallen behind (an upgraded header) catches up gradually.
+    for (auto splits = 0; splits < 2 && header_.overloaded(); ++splits)
+        split();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename KeyType>
+void record_hash_table<KeyType>::split()
+{
+    const auto segment = header_.segment_size();
+
+    // Segments are allocated as records, remapping before any row is read.
+    if (segment != 0)
+    {
+        const auto index = allocate(segment);
+        header_.add_segment(manager_.file_position(index));
+    }
+
+    const auto bucket = header_.split_bucket();
+    auto low = header_.empty;
+    auto high = header_.empty;
+    auto low_tail = header_.empty;
+    auto high_tail = header_.empty;
+    auto low_next = header_.empty;
+    auto high_next = header_.empty;
+
+    ++sequence_;
+
+    // Partition the chain preserving order, rewriting only changed links.
+    for (auto current = header_.read(bucket); current != header_.empty;)
+    {
+        const record_row<KeyType> item(manager_, current);
+        const auto next = item.next_index();
+        const auto hash = std::hash<KeyType>()(item.key());
+        const auto moves = header_.split_target(hash) != bucket;
+
+        auto& head = moves ? high : low;
+        auto& tail = moves ? high_tail : low_tail;
+        auto& tail_next = moves ? high_next : low_next;
+
+        if (tail == header_.empty)
+            head = current;
+        else if (tail_next != current)
+            record_row<KeyType>(manager_, tail).write_next_index(current);
+
+        tail = current;
+        tail_next = next;
+        current = next;
+    }
+
+    if (low_tail != header_.empty && low_next != header_.empty)
+        record_row<KeyType>(manager_, low_tail).write_next_index(
+            header_.empty);
+
+    if (high_tail != header_.empty && high_next != header_.empty)
+        record_row<KeyType>(manager_, high_tail).write_next_index(
+            header_.empty);
+
+    header_.split(low, high);
+    ++sequence_;
+}
+
+template <typename KeyType>
+bool record_hash_table<KeyType>::unchanged(size_t sequence) const
+{
+    return sequence % 2 == 0 && sequence == sequence_;
+}
+
+template <typename KeyType>
+array_index record_hash_table<KeyType>::allocate(size_t size)
+{
+    const auto record_size = manager_.record_size();
+    return manager_.new_records((size + record_size - 1) / record_size);
+}
+
 template <typename KeyType>
 array_index record_hash_table<KeyType>::bucket_index(
     const KeyType& key) const
 {
-    const auto bucket = remainder(key, header_.size());
+    const auto bucket = header_.bucket(std::hash<KeyType>()(key));
     BITCOIN_ASSERT(bucket < header_.size());
     return bucket;
 }
@@ -178,13 +347,6 @@ array_index record_hash_table<KeyType>::read_bucket_value(
     return value;
 }
 
-template <typename KeyType>
-void record_hash_table<KeyType>::link(const KeyType& key,
-    const array_index begin)
-{
-    header_.write(bucket_index(key), begin);
-}
-
 template <typename KeyType>
 template <typename ListItem>
 void record_hash_table<KeyType>::release(const ListItem& item,
@@ -21,8 +21,10 @@
 #ifndef MVS_DATABASE_RECORD_MULTIMAP_IPP
 #define MVS_DATABASE_RECORD_MULTIMAP_IPP
 
+#include <functional>
 #include <string>
 #include <metaverse/database/memory/memory.hpp>
+#include "remainder.ipp"
 
 namespace libbitcoin {
 namespace database {
@@ -42,13 +44,7 @@ array_index record_multimap<KeyType>::lookup(const KeyType& key) const
     if (!start_info)
         return records_.empty;
 
-    const auto address = REMAP_ADDRESS(start_info);
-
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
-    return from_little_endian_unsafe<array_index>(address);
-    ///////////////////////////////////////////////////////////////////////////
+    return read_start(stripe(key), REMAP_ADDRESS(start_info));
 }
 
 template <typename KeyType>
@@ -56,15 +52,16 @@ std::shared_ptr<std::vector<array_index>> record_multimap<KeyType>::lookup(array
 {
 	auto sh_ret_vec = std::make_shared<std::vector<array_index>>();
     auto sh_vec = map_.find(index);
-	
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
+
 	for(auto each : *sh_vec) {
     	const auto address = REMAP_ADDRESS(each);
-		sh_ret_vec->push_back(from_little_endian_unsafe<array_index>(address));
+
+        // The key precedes the start index in its record row.
+        KeyType key;
+        read_key(key, address - record_row<KeyType>::value_begin);
+		sh_ret_vec->push_back(read_start(stripe(key), address));
 	}
-    ///////////////////////////////////////////////////////////////////////////
+
     return sh_ret_vec;
 }
 
@@ -72,6 +69,12 @@ template <typename KeyType>
 void record_multimap<KeyType>::add_row(const KeyType& key,
     write_function write)
 {
+    const auto key_stripe = stripe(key);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(stripes_.mutex(key_stripe));
+
     const auto start_info = map_.find(key);
 
     if (!start_info)
@@ -81,39 +84,36 @@ void record_multimap<KeyType>::add_row(const KeyType& key,
     }
 
     // This forwards a memory object.
-    add_to_list(start_info, write);
+    add_to_list(key_stripe, start_info, write);
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 template <typename KeyType>
-void record_multimap<KeyType>::add_to_list(memory_ptr start_info,
-    write_function write)
+void record_multimap<KeyType>::add_to_list(size_t stripe,
+    memory_ptr start_info, write_function write)
 {
     const auto address = REMAP_ADDRESS(start_info);
 
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_shared();
+    // Only the writer of the stripe changes the start index.
     const auto old_begin = from_little_endian_unsafe<array_index>(address);
-    mutex_.unlock_shared();
-    ///////////////////////////////////////////////////////////////////////////
-
     const auto new_begin = records_.insert(old_begin);
 
     // The records_ and start_info remap safe pointers are in distinct files.
     write(records_.get(new_begin));
 
-    auto serial = make_serializer(address);
-
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
-    serial.template write_little_endian<array_index>(new_begin);
-    ///////////////////////////////////////////////////////////////////////////
+    map_.preserve(address, sizeof(array_index));
+    write_start(stripe, address, new_begin);
 }
 
 template <typename KeyType>
 void record_multimap<KeyType>::delete_last_row(const KeyType& key)
 {
+    const auto key_stripe = stripe(key);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(stripes_.mutex(key_stripe));
+
     const auto start_info = map_.find(key);
     if (!start_info) {
         return;
@@ -122,12 +122,8 @@ void record_multimap<KeyType>::delete_last_row(const KeyType& key)
 
     auto address = REMAP_ADDRESS(start_info);
 
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_shared();
+    // Only the writer of the stripe changes the start index.
     const auto old_begin = from_little_endian_unsafe<array_index>(address);
-    mutex_.unlock_shared();
-    ///////////////////////////////////////////////////////////////////////////
 
     BITCOIN_ASSERT(old_begin != records_.empty);
     const auto new_begin = records_.next(old_begin);
@@ -142,12 +138,8 @@ void record_multimap<KeyType>::delete_last_row(const KeyType& key)
         return;
     }
 
-    auto serial = make_serializer(address);
-
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
-    serial.template write_little_endian<array_index>(new_begin);
+    map_.preserve(address, sizeof(array_index));
+    write_start(key_stripe, address, new_begin);
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -158,19 +150,45 @@ void record_multimap<KeyType>::create_new(const KeyType& key,
     const auto first = records_.create();
     write(records_.get(first));
 
-    const auto write_start_info = [this, first](memory_ptr data)
+    // The start index is not reachable until the key is linked.
+    const auto write_start_info = [first](memory_ptr data)
     {
         auto serial = make_serializer(REMAP_ADDRESS(data));
-
-        // Critical Section
-        ///////////////////////////////////////////////////////////////////////////
-        unique_lock lock(mutex_);
         serial.template write_little_endian<array_index>(first);
-        ///////////////////////////////////////////////////////////////////////////
     };
     map_.store(key, write_start_info);
 }
 
+template <typename KeyType>
+size_t record_multimap<KeyType>::stripe(const KeyType& key) const
+{
+    return stripes_.stripe(std::hash<KeyType>()(key));
+}
+
+template <typename KeyType>
+array_index record_multimap<KeyType>::read_start(size_t stripe,
+    const uint8_t* address) const
+{
+    while (true)
+    {
+        const auto sequence = stripes_.sequence(stripe);
+        const auto start = from_little_endian_unsafe<array_index>(address);
+
+        if (sequence % 2 == 0 && sequence == stripes_.sequence(stripe))
+            return start;
+    }
+}
+
+template <typename KeyType>
+void record_multimap<KeyType>::write_start(size_t stripe, uint8_t* address,
+    array_index start)
+{
+    auto serial = make_serializer(address);
+    stripes_.begin_write(stripe);
+    serial.template write_little_endian<array_index>(start);
+    stripes_.end_write(stripe);
+}
+
 } // namespace database
 } // namespace libbitcoin
 
@@ -22,6 +22,7 @@
 #define MVS_DATABASE_RECORD_ROW_IPP
 
 #include <metaverse/database/memory/memory.hpp>
+#include "remainder.ipp"
 
 namespace libbitcoin {
 namespace database {
@@ -48,6 +49,9 @@ public:
     /// Does this match?
     bool compare(const KeyType& key) const;
 
+    /// The key of this item.
+    KeyType key() const;
+
     /// The actual user data.
     const memory_ptr data() const;
 
@@ -107,6 +111,16 @@ bool record_row<KeyType>::compare(const KeyType& key) const
     return std::equal(key.begin(), key.end(), REMAP_ADDRESS(memory));
 }
 
+template <typename KeyType>
+KeyType record_row<KeyType>::key() const
+{
+    // Key data is at the start.
+    const auto memory = raw_data(0);
+    KeyType key;
+    read_key(key, REMAP_ADDRESS(memory));
+    return key;
+}
+
 template <typename KeyType>
 const memory_ptr record_row<KeyType>::data() const
 {
@@ -131,6 +145,7 @@ template <typename KeyType>
 void record_row<KeyType>::write_next_index(array_index next)
 {
     const auto memory = raw_next_data();
+    manager_.preserve(REMAP_ADDRESS(memory), index_size);
     auto serial = make_serializer(REMAP_ADDRESS(memory));
 
     // Critical Section
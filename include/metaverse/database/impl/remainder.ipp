@@ -21,6 +21,7 @@
 #ifndef MVS_DATABASE_REMAINDER_IPP
 #define MVS_DATABASE_REMAINDER_IPP
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <metaverse/bitcoin.hpp>
@@ -35,6 +36,19 @@ Divisor remainder(const KeyType& key, const Divisor divisor)
     return divisor == 0 ? 0 : std::hash<KeyType>()(key) % divisor;
 }
 
+/// Read a key as it is stored at the start of a table row.
+template <size_t Size>
+void read_key(byte_array<Size>& out, const uint8_t* data)
+{
+    std::copy(data, data + Size, out.begin());
+}
+
+inline void read_key(chain::point& out, const uint8_t* data)
+{
+    auto deserial = make_deserializer_unsafe(data);
+    out.from_data(deserial);
+}
+
 } // namespace database
 } // namespace libbitcoin
 
@@ -21,7 +21,10 @@
 #ifndef MVS_DATABASE_SLAB_HASH_TABLE_IPP
 #define MVS_DATABASE_SLAB_HASH_TABLE_IPP
 
+#include <algorithm>
+#include <functional>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include "remainder.ipp"
 #include "slab_row.ipp"
@@ -32,10 +35,81 @@ namespace database {
 template <typename KeyType>
 slab_hash_table<KeyType>::slab_hash_table(slab_hash_table_header& header,
     slab_manager& manager)
-  : header_(header), manager_(manager)
+  : header_(header), manager_(manager), sequence_(0)
 {
 }
 
+template <typename KeyType>
+bool slab_hash_table<KeyType>::create()
+{
+    return header_.create() && manager_.create();
+}
+
+template <typename KeyType>
+bool slab_hash_table<KeyType>::start()
+{
+    if (!header_.start())
+        return false;
+
+    // The slabs follow the header, which is sized by the file.
+    manager_.set_header_size(slab_hash_table_header_size(header_.size()));
+
+    if (!manager_.start())
+        return false;
+
+    if (header_.growable())
+    {
+        const auto position = header_.directory();
+        return position + slab_hash_table_header::directory_size <=
+            manager_.payload_size() &&
+            header_.load(manager_.file_position(position));
+    }
+
+    // Count the entries of the fixed size header, walking every chain once.
+    uint64_t entries = 0;
+    const auto buckets = header_.size();
+    const auto step = std::max<array_index>(buckets / 10, 1);
+    for (array_index bucket = 0; bucket < buckets; ++bucket)
+    {
+        // Large tables take minutes to walk, report every tenth of them.
+        if (entries != 0 && bucket % step == 0)
+            log::info(LOG_DATABASE)
+                << "Upgrading hash table header, " << entries
+                << " entries in " << bucket << " of " << buckets
+                << " buckets.";
+
+        auto current = header_.read(bucket);
+
+        while (current != header_.empty)
+        {
+            const slab_row<KeyType> item(manager_, current);
+
+            if (item.out_of_memory())
+                return false;
+
+            ++entries;
+            const auto previous = current;
+            current = item.next_position();
+
+            if (previous == current)
+                return false;
+        }
+    }
+
+    // The directory is referenced only once its allocation is synchronized.
+    const auto position = manager_.new_slab(
+        slab_hash_table_header::directory_size);
+    manager_.sync();
+    header_.upgrade(position, manager_.file_position(position), entries);
+
+    if (entries != 0)
+        log::info(LOG_DATABASE)
+            << "Upgraded hash table header of " << header_.size()
+            << " buckets and " << entries << " entries.";
+
+    return true;
+}
+
 // This is not limited to storing unique key values. If duplicate keyed values
 // are store then retrieval and unlinking will fail as these multiples cannot
 // be differentiated. Therefore the database is not currently able to support
@@ -44,17 +118,26 @@ template <typename KeyType>
 file_offset slab_hash_table<KeyType>::store(const KeyType& key,
     write_function write, const size_t value_size)
 {
-	mutex_.lock();
-    // Store current bucket value.
-    const auto old_begin = read_bucket_value(key);
+    // The slab is not reachable until linked, so it is written unlocked.
     slab_row<KeyType> item(manager_, 0);
-    const auto new_begin = item.create(key, value_size, old_begin);
+    const auto new_begin = item.create(key, value_size, header_.empty);
     write(item.data());
 
-    // Link record to header.
-    link(key, new_begin);
-    
-    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        // Critical Section
+        shared_lock table(mutex_);
+        const auto bucket = bucket_index(key);
+        scoped_lock lock(stripes_.mutex(stripes_.stripe(bucket)));
+
+        // Chain the current bucket value and link record to header.
+        item.write_next_position(header_.read(bucket));
+        header_.write(bucket, new_begin);
+        header_.add_entry();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    grow();
 
     // Return position,
     return new_begin + item.value_begin;
@@ -68,118 +151,113 @@ template <typename KeyType>
 file_offset slab_hash_table<KeyType>::restore(const KeyType& key,
     write_function write, const size_t value_size)
 {
-	mutex_.lock();
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock table(mutex_);
+    const auto bucket = bucket_index(key);
+    scoped_lock lock(stripes_.mutex(stripes_.stripe(bucket)));
+
     // Store current bucket value.
-    const auto old_begin = read_bucket_value(key);
+    const auto old_begin = header_.read(bucket);
     slab_row<KeyType> item(manager_, old_begin);
-    //const auto new_begin = item.create(key, value_size, old_begin);
     write(item.data());
 
-    // Link record to header.
-    //link(key, new_begin);
-    
-    mutex_.unlock();
-
     // Return position,
     return old_begin + item.value_begin;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // This is limited to returning the first of multiple matching key values.
 template <typename KeyType>
 const memory_ptr slab_hash_table<KeyType>::find(const KeyType& key) const
 {
-    // Find start item...
-    auto current = read_bucket_value(key);
-
-    // Iterate through list...
-    while (current != header_.empty)
+    while (true)
     {
-        const slab_row<KeyType> item(manager_, current);
-
-        if(item.out_of_memory())
-            break;
-
-        // Found.
-        if (item.compare(key))
-            return item.data();
-
-        const auto previous = current;
-        current = item.next_position();
+        const size_t sequence = sequence_;
+        const auto memory = find_first(key);
 
-        // This may otherwise produce an infinite loop here.
-        // It indicates that a write operation has interceded.
-        // So we must return gracefully vs. looping forever.
-        if (previous == current)
-            return nullptr;
+        // A key moved by a concurrent split may have been missed.
+        if (memory || unchanged(sequence))
+            return memory;
     }
-
-    return nullptr;
 }
 
 // This is limited to returning the last of multiple matching key values.
 template <typename KeyType>
 const memory_ptr slab_hash_table<KeyType>::rfind(const KeyType& key) const
 {
-    memory_ptr ret;
-    // Find start item...
-    auto current = read_bucket_value(key);
-
-    // Iterate through list...
-    while (current != header_.empty)
+    // Repeat a walk that raced a split, it may have missed matches.
+    while (true)
     {
-        const slab_row<KeyType> item(manager_, current);
+        const size_t sequence = sequence_;
+        memory_ptr ret;
+        // Find start item...
+        auto current = read_bucket_value(key);
 
-        if(item.out_of_memory())
-            return nullptr;
+        // Iterate through list...
+        while (current != header_.empty)
+        {
+            const slab_row<KeyType> item(manager_, current);
 
-        // Found.
-        if (item.compare(key))
-            ret = item.data();
+            if(item.out_of_memory())
+                return nullptr;
 
-        const auto previous = current;
-        current = item.next_position();
+            // Found.
+            if (item.compare(key))
+                ret = item.data();
 
-        // This may otherwise produce an infinite loop here.
-        // It indicates that a write operation has interceded.
-        // So we must return gracefully vs. looping forever.
-        if (previous == current)
-            break;
-    }
+            const auto previous = current;
+            current = item.next_position();
+
+            // This may otherwise produce an infinite loop here.
+            // It indicates that a write operation has interceded.
+            // So we must return gracefully vs. looping forever.
+            if (previous == current)
+                break;
+        }
 
-    return ret;
+        if (unchanged(sequence))
+            return ret;
+    }
 }
 
 // This is returning all of multiple matching key values.
 template <typename KeyType>
 std::vector<memory_ptr> slab_hash_table<KeyType>::finds(const KeyType& key) const
 {
-    std::vector<memory_ptr> ret;
-    // Find start item...
-    auto current = read_bucket_value(key);
-
-    // Iterate through list...
-    while (current != header_.empty)
+    // Repeat a walk that raced a split, it may have missed matches.
+    while (true)
     {
-        const slab_row<KeyType> item(manager_, current);
+        const size_t sequence = sequence_;
+        std::vector<memory_ptr> ret;
+        // Find start item...
+        auto current = read_bucket_value(key);
 
-        if(item.out_of_memory())
-            break;
+        // Iterate through list...
+        while (current != header_.empty)
+        {
+            const slab_row<KeyType> item(manager_, current);
 
-        // Found.
-        if (item.compare(key))
-            ret.push_back(item.data());
+            if(item.out_of_memory())
+                break;
 
-        const auto previous = current;
-        current = item.next_position();
+            // Found.
+            if (item.compare(key))
+                ret.push_back(item.data());
 
-        // This may otherwise produce an infinite loop here.
-        // It indicates that a write operation has interceded.
-        // So we must return gracefully vs. looping forever.
-        if (previous == current)
-            break;
-    }
+            const auto previous = current;
+            current = item.next_position();
 
-    return ret;
+            // This may otherwise produce an infinite loop here.
+            // It indicates that a write operation has interceded.
+            // So we must return gracefully vs. looping forever.
+            if (previous == current)
+                break;
+        }
+
+        if (unchanged(sequence))
+            return ret;
+    }
 }
 
 // This is limited to returning all the item in the special index.
@@ -220,8 +298,14 @@ std::shared_ptr<std::vector<memory_ptr>> slab_hash_table<KeyType>::find(uint64_t
 template <typename KeyType>
 bool slab_hash_table<KeyType>::unlink(const KeyType& key)
 {
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock table(mutex_);
+    const auto bucket = bucket_index(key);
+    scoped_lock lock(stripes_.mutex(stripes_.stripe(bucket)));
+
     // Find start item...
-    const auto begin = read_bucket_value(key);
+    const auto begin = header_.read(bucket);
     const slab_row<KeyType> begin_item(manager_, begin);
     
     if (begin_item.out_of_memory())
@@ -230,7 +314,8 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
     // If start item has the key then unlink from buckets.
     if (begin_item.compare(key))
     {
-        link(key, begin_item.next_position());
+        header_.write(bucket, begin_item.next_position());
+        header_.remove_entry();
         return true;
     }
 
@@ -250,6 +335,7 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
         if (item.compare(key))
         {
             release(item, previous);
+            header_.remove_entry();
             return true;
         }
 
@@ -266,10 +352,122 @@ bool slab_hash_table<KeyType>::unlink(const KeyType& key)
     return false;
 }
 
+template <typename KeyType>
+void slab_hash_table<KeyType>::grow()
+{
+    if (!header_.overloaded())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Another writer may have split while this one waited. Two splits per
+    // store outpace the 4/3 buckets required per entry, so a table that has
+    // fallen behind (an upgraded header) catches up gradually.
+    for (auto splits = 0; splits < 2 && header_.overloaded(); ++splits)
+        split();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+template <typename KeyType>
+void slab_hash_table<KeyType>::split()
+{
+    const auto segment = header_.segment_size();
+
+    // Segments are allocated as slabs, remapping before any row is read.
+    if (segment != 0)
+    {
+        const auto position = manager_.new_slab(segment);
+        header_.add_segment(manager_.file_position(position));
+    }
+
+    const auto bucket = header_.split_bucket();
+    auto low = header_.empty;
+    auto high = header_.empty;
+    auto low_tail = header_.empty;
+    auto high_tail = header_.empty;
+    auto low_next = header_.empty;
+    auto high_next = header_.empty;
+
+    ++sequence_;
+
+    // Partition the chain preserving order, rewriting only changed links.
+    for (auto current = header_.read(bucket); current != header_.empty;)
+    {
+        const slab_row<KeyType> item(manager_, current);
+        const auto next = item.next_position();
+        const auto hash = std::hash<KeyType>()(item.key());
+        const auto moves = header_.split_target(hash) != bucket;
+
+        auto& head = moves ? high : low;
+        auto& tail = moves ? high_tail : low_tail;
+        auto& tail_next = moves ? high_next : low_next;
+
+        if (tail == header_.empty)
+            head = current;
+        else if (tail_next != current)
+            slab_row<KeyType>(manager_, tail).write_next_position(current);
+
+        tail = current;
+        tail_next = next;
+        current = next;
+    }
+
+    if (low_tail != header_.empty && low_next != header_.empty)
+        slab_row<KeyType>(manager_, low_tail).write_next_position(
+            header_.empty);
+
+    if (high_tail != header_.empty && high_next != header_.empty)
+        slab_row<KeyType>(manager_, high_tail).write_next_position(
+            header_.empty);
+
+    header_.split(low, high);
+    ++sequence_;
+}
+
+template <typename KeyType>
+const memory_ptr slab_hash_table<KeyType>::find_first(
+    const KeyType& key) const
+{
+    // Find start item...
+    auto current = read_bucket_value(key);
+
+    // Iterate through list...
+    while (current != header_.empty)
+    {
+        const slab_row<KeyType> item(manager_, current);
+
+        if(item.out_of_memory())
+            break;
+
+        // Found.
+        if (item.compare(key))
+            return item.data();
+
+        const auto previous = current;
+        current = item.next_position();
+
+        // This may otherwise produce an infinite loop here.
+        // It indicates that a write operation has interceded.
+        // So we must return gracefully vs. looping forever.
+        if (previous == current)
+            return nullptr;
+    }
+
+    return nullptr;
+}
+
+template <typename KeyType>
+bool slab_hash_table<KeyType>::unchanged(size_t sequence) const
+{
+    return sequence % 2 == 0 && sequence == sequence_;
+}
+
 template <typename KeyType>
 array_index slab_hash_table<KeyType>::bucket_index(const KeyType& key) const
 {
-    const auto bucket = remainder(key, header_.size());
+    const auto bucket = header_.bucket(std::hash<KeyType>()(key));
     BITCOIN_ASSERT(bucket < header_.size());
     return bucket;
 }
@@ -283,13 +481,6 @@ file_offset slab_hash_table<KeyType>::read_bucket_value(
     return value;
 }
 
-template <typename KeyType>
-void slab_hash_table<KeyType>::link(const KeyType& key,
-    const file_offset begin)
-{
-    header_.write(bucket_index(key), begin);
-}
-
 template <typename KeyType>
 template <typename ListItem>
 void slab_hash_table<KeyType>::release(const ListItem& item,
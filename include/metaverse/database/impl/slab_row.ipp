@@ -22,6 +22,7 @@
 #define MVS_DATABASE_SLAB_LIST_IPP
 
 #include <metaverse/database/memory/memory.hpp>
+#include "remainder.ipp"
 
 namespace libbitcoin {
 namespace database {
@@ -49,6 +50,9 @@ public:
     /// Does this match?
     bool compare(const KeyType& key) const;
 
+    /// The key of this item.
+    KeyType key() const;
+
     /// The actual user data.
     const memory_ptr data() const;
 
@@ -82,7 +86,7 @@ template <typename KeyType>
 file_offset slab_row<KeyType>::create(const KeyType& key,
     const size_t value_size, const file_offset next)
 {
-    const file_offset info_size = key.size() + position_size;
+    const file_offset info_size = key_size + position_size;
 
     // Create new slab.
     //   [ KeyType  ]
@@ -114,6 +118,16 @@ bool slab_row<KeyType>::compare(const KeyType& key) const
     return std::equal(key.begin(), key.end(), REMAP_ADDRESS(memory));
 }
 
+template <typename KeyType>
+KeyType slab_row<KeyType>::key() const
+{
+    // Key data is at the start.
+    const auto memory = raw_data(0);
+    KeyType key;
+    read_key(key, REMAP_ADDRESS(memory));
+    return key;
+}
+
 template <typename KeyType>
 const memory_ptr slab_row<KeyType>::data() const
 {
@@ -138,6 +152,7 @@ template <typename KeyType>
 void slab_row<KeyType>::write_next_position(file_offset next)
 {
     const auto memory = raw_next_data();
+    manager_.preserve(REMAP_ADDRESS(memory), position_size);
     auto serial = make_serializer(REMAP_ADDRESS(memory));
 
     // Critical Section
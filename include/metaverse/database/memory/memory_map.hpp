@@ -37,6 +37,8 @@
 namespace libbitcoin {
 namespace database {
 
+class write_journal;
+
 /// This class is thread safe, allowing concurent read and write.
 /// A change to the size of the memory map waits on and locks read and write.
 class BCD_API memory_map
@@ -73,6 +75,13 @@ public:
     memory_ptr reserve(size_t size);
     memory_ptr reserve(size_t size, size_t growth_ratio);
 
+    /// Grow the file to at least size bytes, the logical size is unchanged.
+    void preallocate(size_t size);
+
+    /// Journal size bytes at address (in this map) before they are written
+    /// in place, if a write journal is active on the calling thread.
+    void preserve(const uint8_t* address, size_t size);
+
 private:
     static size_t file_size(int file_handle);
     static int open_file(const boost::filesystem::path& filename);
@@ -91,6 +100,9 @@ private:
     void log_resizing(size_t size);
     void log_unmapped();
 
+    // Record where existing data ends on the first touch of a journaled write.
+    size_t track(const write_journal& journal);
+
     // Optionally guard against concurrent remap.
     mutex_ptr remap_mutex_;
 
@@ -105,6 +117,11 @@ private:
     std::atomic<bool> closed_;
     std::atomic<bool> stopped_;
     mutable upgrade_mutex mutex_;
+
+    // Writers of the active write journal may be concurrent.
+    boost::mutex journal_mutex_;
+    size_t journal_epoch_;
+    size_t watermark_;
 };
 
 } // namespace database
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_WRITE_JOURNAL_HPP
+#define MVS_DATABASE_WRITE_JOURNAL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// An undo journal for block writes across the memory mapped tables.
+/// While a block is pushed or popped, any bytes the write overwrites in data
+/// that existed before the write are first copied to the journal with their
+/// file and offset. Data appended past a table's logical size is not
+/// journaled, restoring the table's (journaled) size discards it.
+/// The journal is itself memory mapped so it survives a process crash, it
+/// does not protect against the loss of unflushed pages on power failure.
+/// This class is thread safe.
+class BCD_API write_journal
+{
+public:
+    enum class operation : uint8_t
+    {
+        none = 0,
+        push = 1,
+        pop = 2
+    };
+
+    /// The journal of the write in progress on the calling thread, if any.
+    static write_journal* active();
+
+    /// Construct the journal, tables are expected in the same directory.
+    write_journal(const boost::filesystem::path& filename);
+
+    /// Close the journal (all threads must first be stopped).
+    ~write_journal();
+
+    /// Initialize a new journal.
+    bool create();
+
+    /// Call before using the journal.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Restore the tables if the last write was interrupted. The tables
+    /// must not be mapped yet. Returns false if the tables cannot be restored.
+    bool recover();
+
+    /// Start journaling the write of the block at height on this thread.
+    void begin(operation op, size_t height);
+
+    /// Discard the journal once the write is complete and synchronized.
+    void commit();
+
+    /// Identifies the write in progress, changes with each begin.
+    size_t epoch() const;
+
+    /// Save size bytes at offset in file before they are overwritten.
+    void preserve(const boost::filesystem::path& file, file_offset offset,
+        const uint8_t* data, size_t size);
+
+private:
+    void write_header(operation op, uint64_t height, file_offset size);
+
+    memory_map file_;
+    const boost::filesystem::path directory_;
+
+    // Read by the memory maps while the mutex is held (by preserve).
+    std::atomic<size_t> epoch_;
+
+    // Protected by mutex.
+    file_offset size_;
+    mutable unique_mutex mutex_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
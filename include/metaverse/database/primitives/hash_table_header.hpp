@@ -21,6 +21,8 @@
 #ifndef MVS_DATABASE_HASH_TABLE_HEADER_HPP
 #define MVS_DATABASE_HASH_TABLE_HEADER_HPP
 
+#include <array>
+#include <atomic>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
 
@@ -38,13 +40,33 @@ namespace database {
  *  [ [      ...       ] ]
  *
  * Empty elements are represented by the value hash_table_header.empty
+ *
+ * A version 1 header grows by linear hashing. Its size is flagged and the
+ * first item holds the position of a directory, allocated by the manager of
+ * the table, which holds the first item and the segments that extend the
+ * array past its size:
+ *
+ *  [ version:4        ]
+ *  [ buckets:IndexType ]
+ *  [ entries:8        ]
+ *  [ item:ValueType   ]
+ *  [ [ segment:8 ]    ] x 32
+ *
+ * Segment k is the file offset of the items [size * 2^k, size * 2^(k+1)).
+ * Version 0 (fixed size) headers are upgraded in place by the hash tables.
  */
 template <typename IndexType, typename ValueType>
 class hash_table_header
 {
 public:
     static const ValueType empty;
+    static const size_t directory_size;
+
+    /// Split a bucket while entries exceed this multiple of the buckets.
+    static const double load_factor;
 
+    /// The bucket count is used only to create the header, a started header
+    /// uses the size found in the file.
     hash_table_header(memory_map& file, IndexType buckets);
 
     // Copy.
@@ -61,22 +83,92 @@ public:
     /// Must be called before use. Loads the size from the file.
     bool start();
 
-    /// Read item's value.
+    /// True if the header is version 1, call load before use.
+    bool growable() const;
+
+    /// The manager position of the directory of a version 1 header.
+    ValueType directory() const;
+
+    /// Load the version 1 directory at the given file offset.
+    bool load(file_offset offset);
+
+    /// Upgrade to version 1 with a directory allocated by the manager.
+    void upgrade(ValueType position, file_offset offset, uint64_t entries);
+
+    /// Read item's value, without locking.
     ValueType read(IndexType index) const;
 
-    /// Write value to item.
+    /// Write value to item, the table serializes writes to each bucket.
     void write(IndexType index, ValueType value);
 
     /// The hash table size (bucket count).
     IndexType size() const;
 
+    /// The bucket of a key hash.
+    IndexType bucket(size_t hash) const;
+
+    /// The number of entries stored in the table (version 1 only).
+    uint64_t entries() const;
+
+    /// Count an entry stored or unlinked by the table, the count is
+    /// persisted by sync or the next split.
+    void add_entry();
+    void remove_entry();
+
+    /// Write the entry count to the directory, with the table's sync.
+    void sync();
+
+    /// True if the load factor is exceeded and a bucket can be split.
+    bool overloaded() const;
+
+    /// The size of the segment to allocate before the next split, or zero.
+    size_t segment_size() const;
+
+    /// Attach a segment allocated for the next split at the file offset.
+    void add_segment(file_offset offset);
+
+    /// The bucket that is split next, its entries move to itself or size().
+    IndexType split_bucket() const;
+
+    /// The bucket of a key hash once the next split is complete.
+    IndexType split_target(size_t hash) const;
+
+    /// Complete the split with the two resulting chains.
+    void split(ValueType low, ValueType high);
+
 private:
+    static const IndexType version_flag;
+    static constexpr size_t max_segments = 32;
+
+    // The bucket of a hash for the given bucket count.
+    IndexType bucket(size_t hash, IndexType buckets) const;
 
     // Locate the item in the memory map.
     file_offset item_position(IndexType index) const;
 
+    // Locate any item of a version 1 header, a segment is attached before
+    // the size that addresses it is published.
+    file_offset item_offset(IndexType index) const;
+
+    // The segment of an item past the fixed size, and its first item.
+    size_t segment(IndexType index, IndexType& first) const;
+
+    // Write the counters of the directory, the mutex must be held.
+    void write_directory(uint8_t* start);
+
     memory_map& file_;
     IndexType buckets_;
+
+    // The current size, read without the mutex for bucket addressing.
+    std::atomic<IndexType> size_;
+
+    // Version 1 state, zero directory offset is version 0 or not loaded.
+    bool growable_;
+    std::atomic<uint64_t> entries_;
+    file_offset directory_;
+    std::array<file_offset, max_segments> segments_;
+
+    // Guards the directory and segments, never taken by bucket access.
     mutable shared_mutex mutex_;
 };
 
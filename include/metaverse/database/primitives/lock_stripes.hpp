@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_LOCK_STRIPES_HPP
+#define MVS_DATABASE_LOCK_STRIPES_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// A fixed set of mutexes that guard the buckets of a table, writers of
+/// buckets in distinct stripes do not contend. Each stripe also carries a
+/// sequence that is odd while its writer modifies a value in place, so that
+/// readers can retry a torn read instead of taking the lock.
+class BCD_API lock_stripes
+{
+public:
+    static constexpr size_t size = 64;
+
+    lock_stripes();
+
+    /// The stripe of a bucket or hash.
+    size_t stripe(size_t hash) const;
+
+    /// The mutex that guards writes to the stripe.
+    boost::mutex& mutex(size_t stripe);
+
+    /// The sequence of the stripe, odd while a writer updates in place.
+    size_t sequence(size_t stripe) const;
+
+    /// Bracket an in-place update, the stripe mutex must be held.
+    void begin_write(size_t stripe);
+    void end_write(size_t stripe);
+
+private:
+    struct stripe_lock
+    {
+        boost::mutex mutex;
+        std::atomic<size_t> sequence;
+    };
+
+    std::array<stripe_lock, size> stripes_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -21,11 +21,13 @@
 #ifndef MVS_DATABASE_RECORD_HASH_TABLE_HPP
 #define MVS_DATABASE_RECORD_HASH_TABLE_HPP
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <tuple>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/primitives/hash_table_header.hpp>
+#include <metaverse/database/primitives/lock_stripes.hpp>
 #include <metaverse/database/primitives/record_manager.hpp>
 
 namespace libbitcoin {
@@ -58,6 +60,11 @@ typedef hash_table_header<array_index, array_index> record_hash_table_header;
  * By using the record_manager instead of slabs, we can have smaller
  * indexes avoiding reading/writing extra bytes to the file.
  * Using fixed size records is therefore faster.
+ *
+ * The header grows by linear hashing, a store that raises the load factor
+ * above the header's splits one bucket, allocating its segments as records.
+ *
+ * Writers lock only the stripe of their bucket, as in slab_hash_table.
  */
 template <typename KeyType>
 class record_hash_table
@@ -67,6 +74,12 @@ public:
 
     record_hash_table(record_hash_table_header& header, record_manager& manager);
 
+    /// Create the header and manager, the file must be started.
+    bool create();
+
+    /// Start the header and manager, upgrading a fixed size header in place.
+    bool start();
+
     /// Store a value. The provided write() function must write the correct
     /// number of bytes (record_size - key_size - sizeof(array_index)).
     void store(const KeyType& key, write_function write);
@@ -78,23 +91,44 @@ public:
     /// Delete a key-value pair from the hashtable by unlinking the node.
     bool unlink(const KeyType& key);
 
+    /// Journal an in-place write to the value of a found record.
+    void preserve(const uint8_t* address, size_t size);
+
 private:
+    // Split the next bucket of the header if the table is overloaded.
+    void grow();
+
+    // Split the next bucket of the header, all writers must be excluded.
+    void split();
+
+    // Find the record of the key, may miss a key moved by a split.
+    const memory_ptr find_first(const KeyType& key) const;
+
+    // True if no split has started since the sequence was read.
+    bool unchanged(size_t sequence) const;
+
+    // Allocate records spanning size bytes.
+    array_index allocate(size_t size);
+
     // What is the bucket given a hash.
     array_index bucket_index(const KeyType& key) const;
 
     // What is the record start index for a chain.
     array_index read_bucket_value(const KeyType& key) const;
 
-    // Link a new chain into the bucket header.
-    void link(const KeyType& key, const array_index begin);
-
     // Release node from linked chain.
     template <typename ListItem>
     void release(const ListItem& item, const file_offset previous);
 
     record_hash_table_header& header_;
     record_manager& manager_;
+
+    // Held shared by bucket writers and exclusively by a split.
     shared_mutex mutex_;
+    lock_stripes stripes_;
+
+    // Odd while a split is relinking chains, readers retry across it.
+    std::atomic<size_t> sequence_;
 };
 
 } // namespace database
@@ -54,21 +54,37 @@ public:
     /// Prepare manager for usage.
     bool start();
 
+    /// Set the size of the header preceding the records, call before start.
+    /// Hash table headers are sized from the file, not the construction size.
+    void set_header_size(file_offset header_size);
+
     /// Synchronise to disk.
     void sync();
 
     /// The number of records in this container.
     array_index count() const;
 
+    /// The fixed size of each record.
+    size_t record_size() const;
+
     /// Change the number of records of this container (truncation).
     void set_count(const array_index value);
 
     /// Allocate records and return first logical index, sync() after writing.
     array_index new_records(size_t count);
 
+    /// Grow the file so that count more records fit without remap.
+    void reserve(size_t count);
+
+    /// Journal an in-place write to an existing record.
+    void preserve(const uint8_t* address, size_t size);
+
     /// Return memory object for the record at the specified index.
     const memory_ptr get(array_index record) const;
 
+    /// The offset within the file of the record at the specified index.
+    file_offset file_position(array_index record) const;
+
 private:
 
     // The record index of a disk position.
@@ -85,7 +101,7 @@ private:
 
     // This class is thread and remap safe.
     memory_map& file_;
-    const file_offset header_size_;
+    file_offset header_size_;
 
     // Payload size is protected by mutex.
     array_index record_count_;
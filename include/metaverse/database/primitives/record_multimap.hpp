@@ -25,6 +25,7 @@
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/lock_stripes.hpp>
 #include <metaverse/database/primitives/record_list.hpp>
 #include <metaverse/database/primitives/record_hash_table.hpp>
 
@@ -45,6 +46,10 @@ constexpr size_t hash_table_multimap_record_size()
  * The map links keys to start indexes in the linked records.
  * The linked records are chains of records that can be iterated through
  * given a start index.
+ *
+ * Writers of a key hold the lock stripe of its hash, so writers of keys in
+ * distinct stripes proceed concurrently. Readers take no lock, a start
+ * index read across an update of its stripe is read again.
  */
 template <typename KeyType>
 class record_multimap
@@ -68,14 +73,24 @@ public:
 
 private:
     // Add new value to existing key.
-    void add_to_list(memory_ptr start_info, write_function write);
+    void add_to_list(size_t stripe, memory_ptr start_info,
+        write_function write);
 
     // Create new key with a single value.
     void create_new(const KeyType& key, write_function write);
 
+    // The lock stripe of a key.
+    size_t stripe(const KeyType& key) const;
+
+    // Read the start index of a key, retrying a read torn by its writer.
+    array_index read_start(size_t stripe, const uint8_t* address) const;
+
+    // Write the start index of a key, the stripe must be locked.
+    void write_start(size_t stripe, uint8_t* address, array_index start);
+
     record_hash_table_type& map_;
     record_list& records_;
-    mutable shared_mutex mutex_;
+    lock_stripes stripes_;
 };
 
 } // namespace database
@@ -21,10 +21,12 @@
 #ifndef MVS_DATABASE_SLAB_HASH_TABLE_HPP
 #define MVS_DATABASE_SLAB_HASH_TABLE_HPP
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/primitives/hash_table_header.hpp>
+#include <metaverse/database/primitives/lock_stripes.hpp>
 #include <metaverse/database/primitives/slab_manager.hpp>
 
 namespace libbitcoin {
@@ -51,6 +53,13 @@ typedef hash_table_header<array_index, file_offset> slab_hash_table_header;
  * data can be lost but the hashtable is never corrupted.
  * Instead we prefer speed and batch that operation. The user should
  * call allocator.sync() after a series of store() calls.
+ *
+ * The header grows by linear hashing, a store that raises the load factor
+ * above the header's splits one bucket, allocating its segments as slabs.
+ *
+ * Writers lock only the stripe of their bucket, so stores to distinct
+ * stripes proceed concurrently. A split excludes all writers. Readers take
+ * no lock, retrying only a lookup that raced a split.
  */
 template <typename KeyType>
 class slab_hash_table
@@ -60,6 +69,12 @@ public:
 
     slab_hash_table(slab_hash_table_header& header, slab_manager& manager);
 
+    /// Create the header and manager, the file must be started.
+    bool create();
+
+    /// Start the header and manager, upgrading a fixed size header in place.
+    bool start();
+
     /// Store a value. value_size is the requested size for the value.
     /// The provided write() function must write exactly value_size bytes.
     /// Returns the position of the inserted value in the slab_manager.
@@ -77,6 +92,17 @@ public:
     bool unlink(const KeyType& key);
 
 private:
+    // Split the next bucket of the header if the table is overloaded.
+    void grow();
+
+    // Split the next bucket of the header, all writers must be excluded.
+    void split();
+
+    // Find the first slab of the key, may miss a key moved by a split.
+    const memory_ptr find_first(const KeyType& key) const;
+
+    // True if no split has started since the sequence was read.
+    bool unchanged(size_t sequence) const;
 
     // What is the bucket given a hash.
     array_index bucket_index(const KeyType& key) const;
@@ -84,16 +110,19 @@ private:
     // What is the slab start position for a chain.
     file_offset read_bucket_value(const KeyType& key) const;
 
-    // Link a new chain into the bucket header.
-    void link(const KeyType& key, const file_offset begin);
-
     // Release node from linked chain.
     template <typename ListItem>
     void release(const ListItem& item, const file_offset previous);
 
     slab_hash_table_header& header_;
     slab_manager& manager_;
+
+    // Held shared by bucket writers and exclusively by a split.
     shared_mutex mutex_;
+    lock_stripes stripes_;
+
+    // Odd while a split is relinking chains, readers retry across it.
+    std::atomic<size_t> sequence_;
 };
 
 } // namespace database
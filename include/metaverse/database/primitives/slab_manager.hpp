@@ -50,15 +50,28 @@ public:
     /// Prepare manager for use.
     bool start();
 
+    /// Set the size of the header preceding the payload, call before start.
+    /// Hash table headers are sized from the file, not the construction size.
+    void set_header_size(file_offset header_size);
+
     /// Synchronise the payload size to disk.
     void sync() const;
 
     /// Allocate a slab and return its position, sync() after writing.
     file_offset new_slab(size_t size);
 
+    /// Grow the file so that slabs totalling size bytes fit without remap.
+    void reserve(size_t size);
+
+    /// Journal an in-place write to an existing slab.
+    void preserve(const uint8_t* address, size_t size);
+
     /// Return memory object for the slab at the specified position.
     const memory_ptr get(file_offset position) const;
 
+    /// The offset within the file of the slab at the specified position.
+    file_offset file_position(file_offset position) const;
+
 //protected:
 
     /// Get the size of all slabs and size prefix (excludes header).
@@ -74,7 +87,7 @@ private:
 
     // This class is thread and remap safe.
     memory_map& file_;
-    const file_offset header_size_;
+    file_offset header_size_;
 
     // Payload size is protected by mutex.
     file_offset payload_size_;
@@ -69,6 +69,22 @@ BCX_API console_result dispatch_command(int argc, const char* argv[],
     Json::Value& jv_output, 
     bc::server::server_node& node, uint8_t api_version = 1);
 
+/**
+ * Invoke the command of a json-rpc v2 call bound from its params directly,
+ * skipping argv and program_options.
+ * @param[in]  target The command symbolic name.
+ * @param[in]  params The json-rpc params of the call.
+ * @param[in]  node server_node instance.
+ * @param[in]  command version.
+ * @param[out] result The appropriate console return code { -1, 0, 1 }.
+ * @return            False if the command has no json binder or does not
+ *                    bind the params, the call is then parsed from argv.
+ */
+BCX_API bool dispatch_json_command(const std::string& target,
+    const Json::Value& params, Json::Value& jv_output,
+    bc::server::server_node& node, uint8_t api_version,
+    console_result& result);
+
 } // namespace explorer
 } // namespace libbitcoin
 
@@ -23,6 +23,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/explorer/define.hpp>
 #include <metaverse/explorer/command.hpp>
@@ -173,7 +174,60 @@ public:
         return console_result::failure;
     }
 
+    /**
+     * Bind json-rpc v2 params straight to the command, skipping argv and
+     * program_options. Returns false to go through the parser instead,
+     * which also reports malformed params.
+     */
+    virtual bool bind_json(const Json::Value& params)
+    {
+        return false;
+    }
+
+    /**
+     * Declare whether the command reads chain state only, no account data.
+     * Json-rpc runs these concurrently, every other command in one lane.
+     */
+    virtual bool reads_chain_only()
+    {
+        return false;
+    }
+
 protected:
+    // Collect the positional params, false if any option is given or a
+    // param is not a scalar.
+    static bool json_arguments(const Json::Value& params,
+        std::vector<std::string>& arguments)
+    {
+        for (const auto& param : params) {
+            if (param.isObject() && param.empty())
+                continue;
+            if (param.isObject() || param.isArray())
+                return false;
+            const auto argument = param.asString();
+            if (!argument.empty() && argument[0] == '-')
+                return false;
+            arguments.push_back(argument);
+        }
+        return true;
+    }
+
+    // Bind the name and auth positional params.
+    bool bind_json_auth(const Json::Value& params, bool required)
+    {
+        std::vector<std::string> arguments;
+        if (!json_arguments(params, arguments) || arguments.size() > 2)
+            return false;
+        if (required && arguments.size() != 2)
+            return false;
+
+        if (arguments.size() > 0)
+            auth_.name = arguments[0];
+        if (arguments.size() > 1)
+            auth_.auth = arguments[1];
+        return true;
+    }
+
     struct argument_base
     {
         std::string name;
@@ -35,6 +35,9 @@ std::string formerly_extension(const std::string& former);
 
 std::shared_ptr<command> find_extension(const std::string& symbol);
 
+// True if the command reads chain state only, see reads_chain_only.
+bool readonly_extension(const std::string& symbol);
+
 void broadcast_extension(const std::function<void(std::shared_ptr<command>)> func, std::ostream& os);
 
 
@@ -39,6 +39,7 @@ public:
     const char* name() override { return symbol();}
     bool category(int bs) override { return (ex_online & bs ) == bs; }
     const char* description() override { return "getaddressasset "; }
+    bool reads_chain_only() override { return true; }
 
     arguments_metadata& load_arguments() override
     {
@@ -43,6 +43,7 @@ public:
     const char* name() override { return symbol();}
     bool category(int bs) override { return (ctgy_extension & bs ) == bs; }
     const char* description() override { return "getblockheader, alias as fetch-header/getbestblockhash/getbestblockheader."; }
+    bool reads_chain_only() override { return true; }
 
     arguments_metadata& load_arguments() override
     {
@@ -83,6 +83,11 @@ public:
     {
     }
 
+    bool bind_json(const Json::Value& params) override
+    {
+        return bind_json_auth(params, false);
+    }
+
     console_result invoke (Json::Value& jv_output,
          libbitcoin::server::server_node& node) override;
 
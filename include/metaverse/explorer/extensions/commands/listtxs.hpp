@@ -100,6 +100,11 @@ public:
             value<uint64_t>(&argument_.index)->default_value(1),
             "Page index."
         )
+        (
+            "cursor,c",
+            value<std::string>(&option_.cursor),
+            "Page cursor, read the page after it instead of the page index. Empty for the first page, then the next_cursor of the previous page."
+        )
         ;
 
 
@@ -108,6 +113,7 @@ public:
 
     void set_defaults_from_config (po::variables_map& variables) override
     {
+        option_.use_cursor = variables.count("cursor") > 0;
     }
 
     console_result invoke (Json::Value& jv_output,
@@ -125,9 +131,11 @@ public:
 
     struct option
     {
-    	option():height(0, 0)
+    	option():height(0, 0), use_cursor(false)
 		{};
     	libbitcoin::explorer::commands::colon_delimited2_item<uint64_t, uint64_t> height;
+        std::string cursor;
+        bool use_cursor;
     } option_;
 
 };
@@ -84,6 +84,11 @@ public:
             "number,n",
             value<uint16_t>(&option_.number)->default_value(0),
             "The number of mining blocks, useful for testing. Defaults to 0, means no limit."
+        )
+        (
+            "threads,t",
+            value<uint16_t>(&option_.threads)->default_value(0),
+            "The number of mining threads. Defaults to 0, means one per CPU core."
         );
 
         return options;
@@ -104,6 +109,7 @@ public:
     {
         std::string address;
         uint16_t number;
+        uint16_t threads;
     } option_;
 
 };
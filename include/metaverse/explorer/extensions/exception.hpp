@@ -209,6 +209,7 @@ DEFINE_STD_JSONRPC_EXCEPTION(jsonrpc_invalid_request, -32600, "jsonrpc invalid r
 DEFINE_STD_JSONRPC_EXCEPTION(jsonrpc_method_not_found, -32601, "jsonrpc method not found");
 DEFINE_STD_JSONRPC_EXCEPTION(jsonrpc_invalid_params, -32602, "jsonrpc invalid params");
 DEFINE_STD_JSONRPC_EXCEPTION(jsonrpc_internal_error, -32603, "jsonrpc internal error");
+DEFINE_STD_JSONRPC_EXCEPTION(jsonrpc_server_busy, -32000, "jsonrpc server busy");
 
 } //namespace explorer
 } //namespace libbitcoin
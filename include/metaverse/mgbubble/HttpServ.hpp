@@ -1,6 +1,16 @@
 
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include <metaverse/mgbubble/Mongoose.hpp>
 #include <metaverse/mgbubble/MgServer.hpp>
+#include <metaverse/mgbubble/RpcCache.hpp>
+#include <metaverse/mgbubble/RpcJobs.hpp>
+#include <metaverse/mgbubble/RpcWorkers.hpp>
 #include <metaverse/mgbubble/utility/Stream_buf.hpp>
 #include <metaverse/mgbubble/utility/Tokeniser.hpp>
 #include <metaverse/mgbubble/exception/Instances.hpp>
@@ -21,14 +31,11 @@ using namespace bc;
 
 class HttpServ : public MgServer
 {
+    typedef bc::chain::point::indexes index_list;
+    typedef bc::message::block_message::ptr_list block_list;
     typedef MgServer base;
 public:
-    explicit HttpServ(const char* webroot, libbitcoin::server::server_node &node, const std::string& srv_addr)
-        : node_(node), MgServer(srv_addr)
-    {
-        document_root_ = webroot;
-        set_document_root(document_root_.c_str());
-    }
+    explicit HttpServ(const char* webroot, libbitcoin::server::server_node &node, const std::string& srv_addr);
     ~HttpServ() noexcept { stop(); };
 
     // Copy.
@@ -39,16 +46,20 @@ public:
     HttpServ(HttpServ&&) = delete;
     HttpServ& operator=(HttpServ&&) = delete;
 
-    void rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version = 1);
-    void ws_request(mg_connection& nc, WebsocketMessage ws);
+    void rpc_request(mg_connection& nc, std::shared_ptr<HttpMessage> data, uint8_t rpc_version = 1);
+    void ws_request(mg_connection& nc, std::shared_ptr<WebsocketMessage> ws);
 
 public:
     void reset(HttpMessage& data) noexcept;
 
     bool start() override;
+    void stop() override;
 
     void spawn_to_mongoose(const std::function<void(uint64_t)>&& handler);
 
+    // Background jobs of the calls submitted with "async": true.
+    RpcJobs& jobs() { return jobs_; }
+
 protected:
     void run() override;
 
@@ -56,6 +67,8 @@ protected:
     void on_notify_handler(struct mg_connection& nc, struct mg_event& ev) override;
     void on_ws_handshake_done_handler(struct mg_connection& nc) override;
     void on_ws_frame_handler(struct mg_connection& nc, struct websocket_message& msg) override;
+    void on_poll_handler(struct mg_connection& nc, time_t now) override;
+    void on_close_handler(struct mg_connection& nc) override;
 
 private:
     enum : int {
@@ -76,6 +89,46 @@ private:
 
     bool isSet(int bs) const noexcept { return (state_ & bs) == bs; }
 
+    // A response slot, responses are sent in the order of the requests.
+    struct Pending {
+        uint64_t id;
+        bool websocket;
+        bool close;
+        std::shared_ptr<std::string> response;
+    };
+
+    // The calls of a json-rpc v2 batch, results keep the order of the calls.
+    struct Batch {
+        std::vector<Json::Value> results;
+        std::vector<bool> notifications;
+        std::atomic<size_t> remaining;
+    };
+
+    // True if the call may run alongside others, the lane running it.
+    static bool concurrent(const std::string& method);
+    RpcWorkers& lane(const std::string& method);
+
+    void rpc_batch(mg_connection& nc, uint64_t id, HttpMessage& data, uint8_t rpc_version);
+    void rpc_job(mg_connection& nc, uint64_t id, std::shared_ptr<HttpMessage> data, uint8_t rpc_version);
+
+    // Called on worker threads.
+    std::string rpc_response(HttpMessage& data, uint8_t rpc_version,
+        std::exception_ptr error = nullptr, int status = 200);
+    Json::Value jsonrpc_result(HttpMessage& data, uint8_t rpc_version,
+        std::exception_ptr error = nullptr);
+    console_result dispatch(HttpMessage& data, uint8_t rpc_version, Json::Value& jv_output);
+    std::string http_response(int status, bool keep_alive, Encoding encoding,
+        const std::function<void()>& write_body);
+    std::string ws_response(WebsocketMessage& ws, std::exception_ptr error = nullptr);
+
+    // Invalidate the cached results.
+    bool handle_transaction_pool(const bc::code& ec, const index_list&, bc::message::transaction_message::ptr tx);
+    bool handle_blockchain_reorganization(const bc::code& ec, uint64_t fork_point, const block_list& new_blocks, const block_list&);
+
+    // Called on mongoose thread.
+    uint64_t enqueue(mg_connection& nc, bool websocket, bool close = false);
+    void complete(mg_connection* nc, uint64_t id, std::shared_ptr<std::string> response);
+
     // config
     static thread_local OStream out_;
     static thread_local Tokeniser<'/'> uri_;
@@ -83,6 +136,17 @@ private:
     const char* const servername_{"Metaverse " MVS_VERSION};
     libbitcoin::server::server_node &node_;
     string document_root_;
+
+    RpcWorkers workers_;
+    RpcWorkers serial_;
+    RpcCache cache_;
+    RpcJobs jobs_;
+    const time_t idle_timeout_;
+    const size_t compress_threshold_;
+
+    // Only touched on mongoose thread.
+    std::unordered_map<mg_connection*, std::deque<Pending>> pending_;
+    uint64_t request_id_{0};
 };
 
 } // mgbubble
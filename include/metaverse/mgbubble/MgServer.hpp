@@ -45,6 +45,10 @@ public:
         {
             nc_->flags |= MG_F_USER_1; // mark as listen socket
             mg_set_protocol_http_websocket(nc_);
+
+            // accepted connections inherit the protocol handler
+            http_handler_ = nc_->proto_handler;
+            nc_->proto_handler = ev_http_pipeline;
         }
 
         notify_sock_[0] = notify_sock_[1] = INVALID_SOCKET;
@@ -124,6 +128,7 @@ protected:
     virtual void on_ws_frame_handler(struct mg_connection& nc, websocket_message& msg);
     virtual void on_ws_ctrlf_handler(struct mg_connection& nc, websocket_message& msg);
     virtual void on_timer_handler(struct mg_connection& nc);
+    virtual void on_poll_handler(struct mg_connection& nc, time_t now);
     virtual void on_close_handler(struct mg_connection& nc);
     virtual void on_send_handler(struct mg_connection& nc, int bytes_transfered);
     virtual void on_notify_handler(struct mg_connection& nc, struct mg_event& ev);
@@ -138,6 +143,11 @@ protected:
     static void ev_handler(struct mg_connection *nc, int ev, void *ev_data);
     static void ev_notify_handler(struct mg_connection *nc, int ev, void *ev_data);
 
+    // mongoose handles one http request per read, this one keeps handling the
+    // requests a client pipelined into the same read.
+    static void ev_http_pipeline(struct mg_connection *nc, int ev, void *ev_data);
+    static mg_event_handler_t http_handler_;
+
 private:
     struct mg_mgr mgr_;
     struct mg_connection *nc_;
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_RPC_CACHE_HPP
+#define MVSD_RPC_CACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <json/json.h>
+
+namespace mgbubble {
+
+/// Bounded cache of the results of commands that only change with the chain
+/// (getblock, getblockheader) or with the chain and the transaction pool
+/// (gettx, getasset, listassets). It is cleared on reorganization, pool
+/// dependent results also on every new pool transaction. The least recently
+/// used results are dropped beyond the capacity. This class is thread safe.
+class RpcCache
+{
+public:
+    typedef std::shared_ptr<const Json::Value> result_ptr;
+
+    /// A cacheable call, value is empty when the call is not cacheable.
+    /// Generations are taken before running the command, so a result read
+    /// before an invalidation is not stored after it.
+    struct Key
+    {
+        std::string value;
+        bool pool;
+        uint64_t chain_generation;
+        uint64_t pool_generation;
+
+        bool empty() const { return value.empty(); }
+    };
+
+    /// Capacity in bytes of rendered results, 0 disables the cache.
+    explicit RpcCache(size_t capacity);
+
+    // Copy.
+    RpcCache(const RpcCache& rhs) = delete;
+    RpcCache& operator=(const RpcCache& rhs) = delete;
+
+    /// The key of a call, from its method and json-rpc params.
+    Key key(const std::string& command, const Json::Value& params,
+        uint8_t api_version) const;
+
+    /// The cached result of the call, nullptr on miss.
+    result_ptr find(const Key& key);
+    void store(const Key& key, const Json::Value& result);
+
+    /// The chain was reorganized.
+    void clear();
+
+    /// A transaction entered the pool.
+    void clear_pool();
+
+private:
+    struct Entry
+    {
+        result_ptr result;
+        size_t size;
+        bool pool;
+        std::list<std::string>::iterator used;
+    };
+
+    void erase(std::unordered_map<std::string, Entry>::iterator it);
+
+    const size_t capacity_;
+
+    // These are protected by mutex.
+    size_t size_;
+    uint64_t chain_generation_;
+    uint64_t pool_generation_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> used_;
+    mutable std::mutex mutex_;
+};
+
+} // mgbubble
+
+#endif
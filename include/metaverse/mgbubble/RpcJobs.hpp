@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_RPC_JOBS_HPP
+#define MVSD_RPC_JOBS_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <json/json.h>
+#include <metaverse/mgbubble/RpcWorkers.hpp>
+
+namespace mgbubble {
+
+/// Json-RPC calls run in the background for the clients asking not to wait
+/// (long wallet operations, mining). A call answers with a job id at once,
+/// its state is fetched with getjob and pushed to the listener on every
+/// change. The latest finished jobs are kept up to the retention limit.
+/// This class is thread safe.
+class RpcJobs
+{
+public:
+    /// Returns the json-rpc response of the call, with "result" or "error".
+    typedef std::function<Json::Value()> Work;
+    typedef std::function<void(const Json::Value& job)> Listener;
+
+    /// Jobs not run concurrently go to the serial lane, shared with the
+    /// calls answered at once.
+    RpcJobs(RpcWorkers& serial, size_t threads, size_t queue_limit,
+        size_t command_limit, size_t retention);
+
+    // Copy.
+    RpcJobs(const RpcJobs& rhs) = delete;
+    RpcJobs& operator=(const RpcJobs& rhs) = delete;
+
+    void start();
+    void stop();
+
+    /// Called on the job threads, set before start.
+    void set_listener(Listener&& listener);
+
+    /// Queue the call, its job id or empty if the queue is full.
+    std::string submit(const std::string& command, bool concurrent,
+        Work&& work);
+
+    /// The state of the job, null for an unknown or expired job.
+    Json::Value get(const std::string& id) const;
+
+private:
+    enum class Status { queued, running, done, failed };
+
+    struct Job
+    {
+        std::string command;
+        Status status;
+        Json::Value response;
+    };
+
+    static Json::Value to_json(const std::string& id, const Job& job);
+
+    void update(const std::string& id, Status status,
+        Json::Value&& response = Json::Value());
+
+    RpcWorkers workers_;
+    RpcWorkers& serial_;
+    const size_t retention_;
+    Listener listener_;
+
+    // These are protected by mutex.
+    std::unordered_map<std::string, Job> jobs_;
+    std::deque<std::string> finished_;
+    mutable std::mutex mutex_;
+};
+
+} // mgbubble
+
+#endif
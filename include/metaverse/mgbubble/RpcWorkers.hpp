@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_RPC_WORKERS_HPP
+#define MVSD_RPC_WORKERS_HPP
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <metaverse/bitcoin/utility/threadpool.hpp>
+
+namespace mgbubble {
+
+/// Bounded pool executing rpc commands off the mongoose event loop.
+/// Jobs of one command beyond its concurrency limit wait for a running one
+/// to finish, jobs beyond the queue limit are refused. This class is thread
+/// safe.
+class RpcWorkers
+{
+public:
+    typedef std::function<void()> Job;
+
+    RpcWorkers(size_t threads, size_t queue_limit, size_t command_limit);
+    ~RpcWorkers() noexcept { stop(); }
+
+    // Copy.
+    RpcWorkers(const RpcWorkers& rhs) = delete;
+    RpcWorkers& operator=(const RpcWorkers& rhs) = delete;
+
+    void start();
+    void stop();
+
+    /// Queue a job of the command, false if the queue is full.
+    bool submit(const std::string& command, Job&& job);
+
+private:
+    struct Command
+    {
+        size_t running;
+        std::deque<Job> waiting;
+    };
+
+    void post(const std::string& command, Job&& job);
+    void run(const std::string& command, const Job& job);
+
+    const size_t threads_;
+    const size_t queue_limit_;
+    const size_t command_limit_;
+    bc::threadpool pool_;
+
+    // These are protected by mutex.
+    size_t queued_;
+    bool stopped_;
+    std::unordered_map<std::string, Command> commands_;
+    std::mutex mutex_;
+};
+
+} // mgbubble
+
+#endif
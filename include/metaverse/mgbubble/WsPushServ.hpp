@@ -23,8 +23,10 @@
 #include <mutex>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/mgbubble/MgServer.hpp>
+#include <metaverse/mgbubble/WsSubscriptions.hpp>
 
 namespace libbitcoin {
     namespace server {
@@ -80,6 +82,9 @@ public:
 
     void spawn_to_mongoose(const std::function<void(uint64_t)>&& handler);
 
+    // Push the state of a background job to its subscribers.
+    void notify_job(const Json::Value& job);
+
 protected:
     bool handle_blockchain_reorganization(const bc::code& ec, uint64_t fork_point, const block_list& new_blocks, const block_list&);
     bool handle_transaction_pool(const bc::code& ec, const index_list&, bc::message::transaction_message::ptr tx);
@@ -89,11 +94,19 @@ protected:
 
     void notify_transaction(uint32_t height, const bc::hash_digest& block_hash, const bc::chain::transaction& tx);
 
+protected:
+    // A serialized event and the connection it goes to.
+    typedef std::vector<std::pair<std::weak_ptr<mg_connection>, std::shared_ptr<std::string>>> frame_list;
+
+    void append_transaction(uint32_t height, const bc::chain::transaction& tx, frame_list& frames);
+    void send_frames(frame_list&& frames);
+
 protected:
     void send_bad_response(struct mg_connection& nc, const char* message = nullptr, int code = 1000001, Json::Value data = Json::nullValue);
     void send_response(struct mg_connection& nc, const std::string& event, const std::string& channel);
 
-    void refresh_connections();
+    // Called with subscribers_lock_ held.
+    void unsubscribe_jobs(mg_connection* nc);
 
 protected:
     void run() override;
@@ -108,7 +121,10 @@ protected:
 private:
     libbitcoin::server::server_node& node_;
     std::unordered_map<void*, std::shared_ptr<mg_connection>> map_connections_;
-    std::map<std::weak_ptr<mg_connection>, std::vector<size_t>, std::owner_less<std::weak_ptr<mg_connection>>> subscribers_;
+
+    // These are protected by subscribers_lock_.
+    WsSubscriptions subscriptions_;
+    std::unordered_map<std::string, std::unordered_map<mg_connection*, std::weak_ptr<mg_connection>>> job_subscribers_;
     std::mutex subscribers_lock_;
 };
 }
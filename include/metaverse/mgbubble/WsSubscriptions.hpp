@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_WS_SUBSCRIPTIONS_HPP
+#define MVSD_WS_SUBSCRIPTIONS_HPP
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <mongoose/mongoose.h>
+
+namespace mgbubble {
+
+/// The transaction subscriptions of the websocket connections, indexed by
+/// address hash so that a transaction costs one lookup per address. A
+/// connection subscribes to some addresses or to every address. This class
+/// is not thread safe.
+class WsSubscriptions
+{
+public:
+    typedef std::weak_ptr<mg_connection> connection_ptr;
+
+    /// Subscribe nc to address_hash, 0 for every address. Subscribing to
+    /// every address drops the addresses, subscribing to an address drops
+    /// every address. False if nc is already subscribed to address_hash.
+    bool subscribe(mg_connection* nc, const connection_ptr& connection,
+        size_t address_hash);
+
+    /// Drop every subscription of nc.
+    void unsubscribe(mg_connection* nc);
+
+    bool empty() const { return subscribers_.empty(); }
+
+    /// The connections subscribed to one of the addresses or to every
+    /// address, each connection once.
+    std::vector<connection_ptr> match(
+        const std::vector<size_t>& address_hashes) const;
+
+private:
+    struct Subscriber {
+        connection_ptr connection;
+        // address hashes, empty for every address
+        std::unordered_set<size_t> addresses;
+    };
+
+    void drop_addresses(mg_connection* nc, Subscriber& subscriber);
+
+    std::unordered_map<mg_connection*, Subscriber> subscribers_;
+    std::unordered_map<size_t, std::unordered_set<mg_connection*>> address_subscribers_;
+    std::unordered_set<mg_connection*> all_subscribers_;
+};
+
+} // mgbubble
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_COMPRESS_HPP
+#define MVSD_COMPRESS_HPP
+
+#include <string>
+#include <metaverse/mgbubble/utility/String.hpp>
+
+/**
+ * @addtogroup Util
+ * @{
+ */
+
+namespace mgbubble {
+
+enum class Encoding { identity, gzip, deflate };
+
+/**
+ * The preferred content coding of an Accept-Encoding header value, gzip over
+ * deflate, identity when neither is accepted or compression is not built in.
+ */
+Encoding acceptEncoding(string_view header) noexcept;
+
+/**
+ * Value of the Content-Encoding header.
+ */
+const char* encodingName(Encoding encoding) noexcept;
+
+/**
+ * Compress size bytes of data into out, false if the data could not be
+ * compressed, the response is then sent as is.
+ */
+bool compress(Encoding encoding, const char* data, size_t size, std::string& out);
+
+} // mgbubble
+
+/** @} */
+
+#endif // MVSD_COMPRESS_HPP
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_JSON_WRITER_HPP
+#define MVSD_JSON_WRITER_HPP
+
+#include <ostream>
+#include <string>
+#include <json/json.h>
+
+/**
+ * @addtogroup Util
+ * @{
+ */
+
+namespace mgbubble {
+
+/**
+ * Serialize the value straight into the stream, without rendering it to an
+ * intermediate string. Output is compact unless pretty is set, which is kept
+ * for v1 clients.
+ */
+void writeJson(std::ostream& os, const Json::Value& value, bool pretty = false);
+
+/**
+ * Compact or pretty rendering of the value, for frames that need a string.
+ */
+std::string toJson(const Json::Value& value, bool pretty = false);
+
+} // mgbubble
+
+/** @} */
+
+#endif // MVSD_JSON_WRITER_HPP
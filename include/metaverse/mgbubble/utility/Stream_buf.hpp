@@ -75,7 +75,11 @@ class OStream : public std::ostream {
   {
     return static_cast<StreamBuf*>(std::ostream::rdbuf(sb));
   }
-  void reset(int status, const char* reason,const char *content_type = "text/plain",const char *charset = "utf-8") noexcept;
+  const char_type* body() const noexcept { return data() + headSize_; }
+  std::streamsize bodySize() const noexcept { return size() - headSize_; }
+  // Headers are complete lines, each ending with CRLF.
+  void reset(int status, const char* reason,const char *content_type = "text/plain",const char *charset = "utf-8",
+      const char* headers = "") noexcept;
   void setContentLength() noexcept;
 
  private:
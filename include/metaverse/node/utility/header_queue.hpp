@@ -36,8 +36,9 @@ public:
     /// True if the specified hash is marked as removed.
     static bool valid(const hash_digest& hash);
 
-    /// Construct a block hash list with specified height offset.
-    header_queue(const config::checkpoint::list& checkpoints);
+    /// Construct a block hash list with specified height offset, seals are
+    /// verified on the pool.
+    header_queue(threadpool& pool, const config::checkpoint::list& checkpoints);
 
     /// True if the list is empty.
     bool empty() const;
@@ -66,9 +67,14 @@ public:
     /// Clear the queue and populate the hash at the given height.
     void initialize(const config::checkpoint& check);
 
-    /// Clear the queue and populate the hash at the given height.
+    /// Clear the queue and populate the hash at the given height, headers
+    /// are rejected until initialized with the header itself.
     void initialize(const hash_digest& hash, size_t height);
 
+    /// Clear the queue and populate the header at the given height, so the
+    /// seal and difficulty of its successor can be validated.
+    void initialize(const chain::header& header, size_t height);
+
     /// Mark the heights if they exist.
     void invalidate(size_t first_height, size_t count);
 
@@ -85,22 +91,36 @@ private:
     // Roll back the list to the last checkpoint.
     void rollback();
 
+    // Make the retained header with the hash the last one, if kept.
+    void retain(const hash_digest& hash);
+
+    // The number of leading headers with a valid seal and difficulty.
+    size_t validate(const chain::header::list& headers) const;
+
     // Merge a list of block hashes to the list, validating linkage.
-    bool merge(const chain::header::list& headers);
+    bool merge(const chain::header::list& headers, size_t valid);
 
     // Determine if the hash violates a checkpoint.
     bool check(const hash_digest& hash, size_t height) const;
 
+    // Determine if the hash is the checkpoint at the height.
+    bool is_checkpoint(const hash_digest& hash, size_t height) const;
+
     // Determine if the hash is linked to the give (preceding) header.
     bool linked(const chain::header& header, const hash_digest& hash) const;
 
     // The list of checkpoints that determines the sync range.
     const config::checkpoint::list& checkpoints_;
 
+    // Shared with the block organizer.
+    threadpool& pool_;
+
     // protected by mutex.
     size_t height_;
     hash_list list_;
     hash_list::iterator head_;
+    chain::header last_header_;
+    chain::header::list retained_;
     mutable upgrade_mutex mutex_;
 };
 
@@ -35,6 +35,7 @@
 #include <metaverse/server/services/query_service.hpp>
 #include <metaverse/server/services/transaction_service.hpp>
 #include <metaverse/server/utility/authenticator.hpp>
+#include <metaverse/server/utility/query_statistics.hpp>
 #include <metaverse/server/workers/notification_worker.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/consensus/miner.hpp>
@@ -105,6 +106,9 @@ public:
     /// Get miner.
     virtual consensus::miner& miner();
 
+    /// Latency counters of the query workers.
+    virtual server::query_statistics& query_statistics();
+
     bool is_blockchain_sync() const { return under_blockchain_sync_.load(std::memory_order_relaxed); }
 
 private:
@@ -126,6 +130,7 @@ private:
     static boost::filesystem::path webpage_path_;
 
     consensus::miner miner_;
+    server::query_statistics query_statistics_;
     boost::shared_ptr<mgbubble::HttpServ> rest_server_;
     boost::shared_ptr<mgbubble::WsPushServ> push_server_;
     // These are thread safe.
@@ -45,6 +45,14 @@ public:
     uint32_t subscription_expiration_minutes;
     uint32_t subscription_limit;
     std::string mongoose_listen;
+    uint16_t rpc_workers;
+    uint32_t rpc_queue_limit;
+    uint16_t rpc_command_concurrency;
+    uint32_t rpc_idle_timeout_seconds;
+    uint32_t rpc_compress_threshold;
+    uint32_t rpc_cache_megabytes;
+    uint16_t rpc_job_workers;
+    uint32_t rpc_job_retention;
     std::string websocket_listen;
     std::string log_level;
     bool administrator_required;
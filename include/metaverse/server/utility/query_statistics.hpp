@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SERVER_QUERY_STATISTICS_HPP
+#define MVS_SERVER_QUERY_STATISTICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <metaverse/server/define.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+/// Latency counters of the query interfaces, shared by all query workers.
+/// The latency of a query runs from its receipt to its response.
+/// This class is thread safe.
+class BCS_API query_statistics
+{
+public:
+    struct latency
+    {
+        uint64_t queries;
+        uint64_t total_microseconds;
+        uint64_t max_microseconds;
+    };
+
+    query_statistics();
+
+    /// Count a query, the interface is the command prefix (address.*).
+    void record(const std::string& command, uint64_t microseconds);
+
+    /// Counters of the interface (address, blockchain, transaction_pool,
+    /// protocol), all zero for an unknown interface.
+    latency get(const std::string& interface) const;
+
+    /// Log the counters of every interface that served a query.
+    void log_summary() const;
+
+private:
+    struct counter
+    {
+        std::atomic<uint64_t> queries;
+        std::atomic<uint64_t> total_microseconds;
+        std::atomic<uint64_t> max_microseconds;
+    };
+
+    static size_t index(const std::string& command);
+
+    std::array<counter, 5> counters_;
+};
+
+} // namespace server
+} // namespace libbitcoin
+
+#endif
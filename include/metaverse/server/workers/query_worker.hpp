@@ -23,6 +23,7 @@
 #include <memory>
 #include <functional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <metaverse/protocol.hpp>
 #include <metaverse/server/define.hpp>
@@ -58,6 +59,7 @@ protected:
     virtual bool connect(socket& router);
     virtual bool disconnect(socket& router);
     virtual void query(socket& router);
+    virtual void notify(message& response);
 
     // Implement the worker.
     virtual void work();
@@ -70,6 +72,9 @@ private:
     server_node& node_;
     bc::protocol::zmq::authenticator& authenticator_;
 
+    // This is only written before the work loop starts.
+    std::thread::id thread_;
+
     // This is protected by base class mutex.
     command_map command_handlers_;
 };
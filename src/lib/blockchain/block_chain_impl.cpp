@@ -20,6 +20,7 @@
  */
 #include <metaverse/blockchain/block_chain_impl.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -34,6 +35,7 @@
 #include <metaverse/blockchain/block.hpp>
 #include <metaverse/blockchain/block_fetcher.hpp>
 #include <metaverse/blockchain/organizer.hpp>
+#include <metaverse/blockchain/script_cache.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/blockchain/validate_transaction.hpp>
@@ -41,7 +43,7 @@
 namespace libbitcoin {
 namespace blockchain {
 
-////#define NAME "blockchain"
+#define NAME "blockchain"
 
 using namespace bc::chain;
 using namespace bc::database;
@@ -55,7 +57,7 @@ block_chain_impl::block_chain_impl(threadpool& pool,
   : stopped_(true),
     settings_(chain_settings),
     organizer_(pool, *this, chain_settings),
-    ////read_dispatch_(pool, NAME),
+    read_dispatch_(pool, NAME),
     ////write_dispatch_(pool, NAME),
     transaction_pool_(pool, *this, chain_settings),
     database_(database_settings)
@@ -105,6 +107,8 @@ bool block_chain_impl::start()
     if (!stopped() || !database_.start())
         return false;
 
+    script_cache::instance().set_capacity(settings_.script_cache_capacity);
+
     stopped_ = false;
     organizer_.start();
     transaction_pool_.start();
@@ -255,6 +259,13 @@ bool block_chain_impl::get_transaction(transaction& out_transaction,
     return true;
 }
 
+bool block_chain_impl::get_unspent_output(database::unspent_output& out_output,
+    const output_point& outpoint) const
+{
+    out_output = database_.utxos.get(outpoint);
+    return out_output.valid;
+}
+
 // This is safe to call concurrently (but with no other methods).
 bool block_chain_impl::import(block::ptr block, uint64_t height)
 {
@@ -382,68 +393,45 @@ void block_chain_impl::do_store(message::block_message::ptr block,
 // The callback model is preserved currently in order to limit downstream changes.
 // This change allows the caller to manage worker threads.
 void block_chain_impl::fetch_serial(perform_read_functor perform_read)
+{
+    // Initiate serial read operation.
+    do_fetch(perform_read);
+}
+
+void block_chain_impl::fetch_parallel(perform_read_functor perform_read)
+{
+    // Initiate async read operation.
+    read_dispatch_.concurrent(&block_chain_impl::do_fetch, this,
+        perform_read);
+}
+
+// Reads are ordered across all callers, so each channel sees its own in order.
+void block_chain_impl::fetch_ordered(perform_read_functor perform_read)
+{
+    // Initiate async read operation.
+    read_dispatch_.ordered(&block_chain_impl::do_fetch, this, perform_read);
+}
+
+void block_chain_impl::do_fetch(perform_read_functor perform_read)
 {
     // Post IBD writes are ordered on the strand, so never concurrent.
     // Reads are unordered and concurrent, but effectively blocked by writes.
-    const auto try_read = [this, perform_read]()
+    while (true)
     {
         const auto handle = database_.begin_read();
-        return (!database_.is_write_locked(handle) && perform_read(handle));
-    };
 
-    const auto do_read = [try_read]()
-    {
-        // Sleep while waiting for write to complete.
-        while (!try_read())
-            std::this_thread::sleep_for(asio::milliseconds(10));
-    };
+        // Wait for the write to complete, waking as soon as it ends.
+        if (database_.is_write_locked(handle))
+        {
+            database_.wait_write(handle);
+            continue;
+        }
 
-    // Initiate serial read operation.
-    do_read();
-}
-
-////void block_chain_impl::fetch_parallel(perform_read_functor perform_read)
-////{
-////    // Post IBD writes are ordered on the strand, so never concurrent.
-////    // Reads are unordered and concurrent, but effectively blocked by writes.
-////    const auto try_read = [this, perform_read]()
-////    {
-////        const auto handle = database_.begin_read();
-////        return (!database_.is_write_locked(handle) && perform_read(handle));
-////    };
-////
-////    const auto do_read = [this, try_read]()
-////    {
-////        // Sleep while waiting for write to complete.
-////        while (!try_read())
-////            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-////    };
-////
-////    // Initiate async read operation.
-////    read_dispatch_.concurrent(do_read);
-////}
-
-////// TODO: This should be ordered on the channel's strand, not across channels.
-////void block_chain_impl::fetch_ordered(perform_read_functor perform_read)
-////{
-////    // Writes are ordered on the strand, so never concurrent.
-////    // Reads are unordered and concurrent, but effectively blocked by writes.
-////    const auto try_read = [this, perform_read]() -> bool
-////    {
-////        const auto handle = database_.begin_read();
-////        return (!database_.is_write_locked(handle) && perform_read(handle));
-////    };
-////
-////    const auto do_read = [this, try_read]()
-////    {
-////        // Sleep while waiting for write to complete.
-////        while (!try_read())
-////            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-////    };
-////
-////    // Initiate async read operation.
-////    read_dispatch_.ordered(do_read);
-////}
+        // A read invalidated by an intervening write is repeated.
+        if (perform_read(handle))
+            return;
+    }
+}
 
 // block_chain (formerly fetch_ordered)
 // ----------------------------------------------------------------------------
@@ -487,7 +475,7 @@ void block_chain_impl::fetch_block_locator(block_locator_fetch_handler handler)
 
         return finish_fetch(slock, handler, error::success, locator);
     };
-    fetch_serial(do_fetch);
+    fetch_ordered(do_fetch);
 }
 
 // Fetch start-base-stop|top+1(max 500)
@@ -555,7 +543,7 @@ void block_chain_impl::fetch_locator_block_hashes(
 
         return finish_fetch(slock, handler, error::success, hashes);
     };
-    fetch_serial(do_fetch);
+    fetch_ordered(do_fetch);
 }
 
 void block_chain_impl::fetch_locator_block_headers(
@@ -624,7 +612,7 @@ void block_chain_impl::fetch_locator_block_headers(
 
         return finish_fetch(slock, handler, error::success, headers);
     };
-    fetch_serial(do_fetch);
+    fetch_ordered(do_fetch);
 }
 
 // This may execute up to 500 queries.
@@ -727,7 +715,7 @@ void block_chain_impl::fetch_block_header(uint64_t height,
             finish_fetch(slock, handler, error::success, header) :
             finish_fetch(slock, handler, error::not_found, chain::header());
     };
-    fetch_serial(do_fetch);
+    fetch_parallel(do_fetch);
 }
 
 void block_chain_impl::fetch_block_header(const hash_digest& hash,
@@ -756,7 +744,7 @@ void block_chain_impl::fetch_block_header(const hash_digest& hash,
             finish_fetch(slock, handler, error::success, header) :
             finish_fetch(slock, handler, error::not_found, chain::header());
     };
-    fetch_serial(do_fetch);
+    fetch_parallel(do_fetch);
 }
 
 void block_chain_impl::fetch_merkle_block(uint64_t height,
@@ -801,7 +789,7 @@ void block_chain_impl::fetch_block_transaction_hashes(uint64_t height,
             finish_fetch(slock, handler, error::success, hashes) :
             finish_fetch(slock, handler, error::not_found, hash_list());
     };
-    fetch_serial(do_fetch);
+    fetch_parallel(do_fetch);
 }
 
 void block_chain_impl::fetch_block_transaction_hashes(const hash_digest& hash,
@@ -830,7 +818,7 @@ void block_chain_impl::fetch_block_transaction_hashes(const hash_digest& hash,
             finish_fetch(slock, handler, error::success, hashes) :
             finish_fetch(slock, handler, error::not_found, hash_list());
     };
-    fetch_serial(do_fetch);
+    fetch_parallel(do_fetch);
 }
 
 void block_chain_impl::fetch_block_height(const hash_digest& hash,
@@ -1640,6 +1628,92 @@ std::shared_ptr<business_record::list> block_chain_impl::get_address_business_re
     return database_.address_assets.get(address, symbol, start_height, end_height, limit, page_number);
 }
 
+std::shared_ptr<business_record::list> block_chain_impl::get_address_business_record_page(
+    const std::vector<std::string>& addresses, const std::string& symbol,
+    size_t start_height, size_t end_height, size_t limit, std::string& cursor)
+{
+    // The cursor is the height and hash of the last transaction sent.
+    static constexpr size_t cursor_size = sizeof(uint32_t) + hash_size;
+
+    size_t cursor_height = max_size_t;
+    hash_digest cursor_hash = null_hash;
+    bool has_cursor = false;
+    if (!cursor.empty()) {
+        data_chunk token;
+        if (!decode_base16(token, cursor) || token.size() != cursor_size)
+            return nullptr;
+
+        auto deserial = make_deserializer(token.begin(), token.end());
+        cursor_height = deserial.read_4_bytes_little_endian();
+        cursor_hash = deserial.read_hash();
+        has_cursor = true;
+    }
+
+    auto max_height = cursor_height;
+    if (end_height > 0)
+        max_height = std::min(max_height, end_height - 1);
+
+    // Newest first, then by hash so that a height shared by several pages
+    // splits at a stable place.
+    typedef std::pair<uint64_t, hash_digest> position;
+    const auto newer = [](const position& lhs, const position& rhs) {
+        return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+    };
+    std::map<position, business_record, decltype(newer)> page(newer);
+
+    // Taking limit + 1 transactions of every address, completed to the end of
+    // their last height, is enough to find the first limit + 1 of all of them.
+    const auto wanted = limit + 1;
+
+    for (const auto& addr : addresses) {
+        std::set<hash_digest> seen;
+        bool filled = false;
+        uint64_t filled_height = 0;
+
+        database_.address_assets.scan(get_short_hash(addr), max_height,
+            [&](const business_record& row) {
+                if (row.height < start_height || (filled && row.height < filled_height))
+                    return false;
+
+                const auto& hash = row.point.hash;
+                if (has_cursor && row.height == cursor_height && !(cursor_hash < hash))
+                    return true;
+
+                if (!symbol.empty() && symbol != get_asset_symbol_from_business_data(row.data))
+                    return true;
+
+                if (seen.insert(hash).second) {
+                    page.emplace(position{ row.height, hash }, row);
+                    if (!filled && seen.size() == wanted) {
+                        filled = true;
+                        filled_height = row.height;
+                    }
+                }
+                return true;
+            });
+    }
+
+    auto result = std::make_shared<business_record::list>();
+    for (const auto& entry : page) {
+        if (result->size() == limit)
+            break;
+        result->push_back(entry.second);
+    }
+
+    cursor.clear();
+    if (page.size() > limit && !result->empty()) {
+        const auto& last = result->back();
+        data_chunk token;
+        token.reserve(cursor_size);
+        auto serial = make_serializer(std::back_inserter(token));
+        serial.write_4_bytes_little_endian(static_cast<uint32_t>(last.height));
+        serial.write_hash(last.point.hash);
+        cursor = encode_base16(token);
+    }
+
+    return result;
+}
+
 // get special assets of the account/name, just used for asset_detail/asset_transfer
 std::shared_ptr<business_history::list> block_chain_impl::get_address_business_history(const std::string& addr,
     business_kind kind, uint8_t confirmed)
@@ -2415,6 +2489,119 @@ bool block_chain_impl::get_history(const wallet::payment_address& address,
     return true;
 }
 
+bool block_chain_impl::get_pool_history(const wallet::payment_address& address,
+    chain::spend_info::list& spends, chain::output_info::list& outputs)
+{
+    if (stopped())
+        return false;
+
+    boost::mutex mutex;
+
+    mutex.lock();
+    auto f = [&spends, &outputs, &mutex](const code& ec,
+        const chain::spend_info::list& spends_,
+        const chain::output_info::list& outputs_) -> void
+    {
+        if ((code)error::success == ec)
+        {
+            spends = spends_;
+            outputs = outputs_;
+        }
+        mutex.unlock();
+    };
+
+    // Obtain payment address history from the transaction pool only.
+    pool().fetch_index_history(address, f);
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return true;
+}
+
+bool block_chain_impl::get_address_balance(
+    const wallet::payment_address& address, address_balance& balance)
+{
+    if (stopped() || !database_.balances.complete())
+        return false;
+
+    const auto do_fetch = [this, &address, &balance](size_t slock)
+    {
+        balance = database_.balances.get(address.hash());
+        return database_.is_read_valid(slock);
+    };
+    fetch_serial(do_fetch);
+    return true;
+}
+
+bool block_chain_impl::get_address_output(const chain::output_point& point,
+    address_output& output)
+{
+    if (stopped() || !database_.balances.complete())
+        return false;
+
+    auto found = false;
+    const auto do_fetch = [this, &point, &output, &found](size_t slock)
+    {
+        found = database_.balances.get(point, output);
+        return database_.is_read_valid(slock);
+    };
+    fetch_serial(do_fetch);
+    return found;
+}
+
+bool block_chain_impl::get_address_unspent(
+    const wallet::payment_address& address, history::list& rows)
+{
+    if (stopped() || !database_.balances.complete())
+        return false;
+
+    address_output::list confirmed;
+    const auto do_fetch = [this, &address, &confirmed](size_t slock)
+    {
+        confirmed = database_.balances.get_unspent(address.hash());
+        return database_.is_read_valid(slock);
+    };
+    fetch_serial(do_fetch);
+
+    chain::spend_info::list spends;
+    chain::output_info::list outputs;
+    get_pool_history(address, spends, outputs);
+
+    const auto pool_spent = [&spends](const output_point& point) {
+        return std::any_of(spends.begin(), spends.end(),
+            [&point](const chain::spend_info& spend) {
+                return spend.previous_output == point;
+            });
+    };
+
+    const auto add_row = [&rows](const output_point& point, uint64_t height,
+        uint64_t value) {
+        history row;
+        row.output = point;
+        row.output_height = height;
+        row.value = value;
+        row.spend = { null_hash, max_uint32 };
+        row.temporary_checksum = point.checksum();
+        rows.emplace_back(row);
+    };
+
+    rows.clear();
+    rows.reserve(confirmed.size() + outputs.size());
+
+    for (const auto& output: confirmed) {
+        if (!pool_spent(output.point)) {
+            add_row(output.point, output.height, output.value);
+        }
+    }
+
+    // Outputs in the transaction pool have no height.
+    for (const auto& output: outputs) {
+        if (!pool_spent(output.point)) {
+            add_row(output.point, 0, output.value);
+        }
+    }
+
+    return true;
+}
+
 bool block_chain_impl::get_tx_inputs_etp_value (chain::transaction& tx, uint64_t& etp_val)
 {
     chain::transaction tx_temp;
@@ -38,7 +38,9 @@ block_detail::block_detail(block_ptr actual_block)
     processed_(false),
     height_(orphan_height),
     actual_block_(actual_block),
-    is_checked_work_proof_(false)
+    is_checked_work_proof_(false),
+    is_checked_seal_(false),
+    is_valid_seal_(false)
 {
 }
 
@@ -84,6 +86,23 @@ bool block_detail::get_is_checked_work_proof() const
     return is_checked_work_proof_.load();
 }
 
+// The result is stored first, so it is visible once the check is.
+void block_detail::set_checked_seal(bool is_valid)
+{
+    is_valid_seal_.store(is_valid);
+    is_checked_seal_.store(true);
+}
+
+bool block_detail::get_is_checked_seal() const
+{
+    return is_checked_seal_.load();
+}
+
+bool block_detail::get_is_valid_seal() const
+{
+    return is_valid_seal_.load();
+}
+
 void block_detail::set_error(const code& code)
 {
     code_.store(code);
@@ -33,6 +33,7 @@
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
 #include <metaverse/blockchain/validate_block_impl.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/node/protocols/protocol_block_out.hpp>
 #include <metaverse/bitcoin/wallet/payment_address.hpp>
@@ -49,6 +50,7 @@ using namespace bc::config;
 organizer::organizer(threadpool& pool, block_chain_impl& chain,
     const settings& settings)
   : stopped_(true),
+    pool_(pool),
     use_testnet_rules_(settings.use_testnet_rules),
     checkpoints_(checkpoint::sort(settings.checkpoints)),
     chain_(chain),
@@ -109,7 +111,7 @@ code organizer::verify(uint64_t fork_point,
     };
 
     // Validates current_block
-    validate_block_impl validate(chain_, fork_point, orphan_chain,
+    validate_block_impl validate(pool_, chain_, fork_point, orphan_chain,
         orphan_index, height, *current_block, use_testnet_rules_, checkpoints_,
             callback);
 
@@ -233,6 +235,45 @@ void organizer::process(block_detail::ptr process_block)
     }
 }
 
+// Checks the seals of the not yet verified blocks of the chain on the pool,
+// verify() then uses the recorded result instead of checking again.
+void organizer::prevalidate_work(uint64_t fork_index,
+    const block_detail::list& orphan_chain)
+{
+    std::vector<std::pair<chain::header*, chain::header*>> items;
+    std::vector<size_t> indexes;
+    chain::header fork_header;
+
+    for (size_t orphan = 0; orphan < orphan_chain.size(); ++orphan)
+    {
+        const auto& detail = orphan_chain[orphan];
+        if (detail->get_is_checked_work_proof() || detail->get_is_checked_seal())
+            continue;
+
+        chain::header* parent = nullptr;
+        if (orphan != 0)
+            parent = &orphan_chain[orphan - 1]->actual()->header;
+        else if (chain_.get_header(fork_header, fork_index))
+            parent = &fork_header;
+
+        if (parent == nullptr)
+            continue;
+
+        items.emplace_back(&detail->actual()->header, parent);
+        indexes.push_back(orphan);
+    }
+
+    // A single block gains nothing from the thread hand-off.
+    if (items.size() < 2)
+        return;
+
+    const auto seals = MinerAux::verifySeals(pool_, items);
+    for (size_t item = 0; item < items.size(); ++item)
+        if (seals[item] != MinerAux::Seal::unchecked)
+            orphan_chain[indexes[item]]->set_checked_seal(
+                seals[item] == MinerAux::Seal::valid);
+}
+
 /*********************************************************************
  * this set include blocks which cause consensus validation problems.
  ********************************************************************/
@@ -250,6 +291,8 @@ void organizer::replace_chain(uint64_t fork_index,
 {
     u256 orphan_work = 0;
 
+    prevalidate_work(fork_index, orphan_chain);
+
     for (uint64_t orphan = 0; orphan < orphan_chain.size(); ++orphan)
     {
         // This verifies the block at orphan_chain[orphan]->actual()
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/script_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+const size_t script_cache::default_capacity = 100000;
+
+script_cache& script_cache::instance()
+{
+    static script_cache instance;
+    return instance;
+}
+
+script_cache::script_cache()
+  : capacity_(default_capacity)
+{
+}
+
+hash_digest script_cache::to_key(const hash_digest& tx_hash,
+    uint32_t input_index, const data_chunk& prevout_script)
+{
+    const auto index = to_little_endian(input_index);
+    const auto preimage = build_chunk({ tx_hash, index, prevout_script });
+    return sha256_hash(preimage);
+}
+
+void script_cache::set_capacity(size_t capacity)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    capacity_ = capacity;
+    while (order_.size() > capacity_)
+    {
+        entries_.erase(order_.front());
+        order_.pop_front();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool script_cache::contains(const hash_digest& tx_hash, uint32_t input_index,
+    const data_chunk& prevout_script, uint32_t flags) const
+{
+    const auto key = to_key(tx_hash, input_index, prevout_script);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    const auto it = entries_.find(key);
+    return it != entries_.end() && (flags & ~it->second) == 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void script_cache::store(const hash_digest& tx_hash, uint32_t input_index,
+    const data_chunk& prevout_script, uint32_t flags)
+{
+    const auto key = to_key(tx_hash, input_index, prevout_script);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    if (capacity_ == 0)
+        return;
+
+    const auto it = entries_.find(key);
+    if (it != entries_.end())
+    {
+        // Keep the strictest flag set the script is known to pass.
+        if ((it->second & ~flags) == 0)
+            it->second = flags;
+
+        return;
+    }
+
+    // Evict in insertion order, blocks confirm pool txs roughly in order.
+    if (order_.size() >= capacity_)
+    {
+        entries_.erase(order_.front());
+        order_.pop_front();
+    }
+
+    entries_.emplace(key, flags);
+    order_.push_back(key);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void script_cache::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    entries_.clear();
+    order_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -33,7 +33,10 @@ settings::settings()
   : block_pool_capacity(5000),
     transaction_pool_capacity(4096),
     transaction_pool_consistency(false),
-    use_testnet_rules(false)
+    script_cache_capacity(100000),
+    use_testnet_rules(false),
+    dag_threads(0),
+    dag_pregenerate(false)
 {
 }
 
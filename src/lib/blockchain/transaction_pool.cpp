@@ -393,6 +393,13 @@ void transaction_pool::fetch_history(const payment_address& address,
     index_.fetch_all_history(address, limit, from_height, handler);
 }
 
+void transaction_pool::fetch_index_history(const payment_address& address,
+    transaction_pool_index::query_handler handler)
+{
+    // This reads the pool only, confirmed history is left to the caller.
+    index_.fetch_index_history(address, handler);
+}
+
 // TODO: use hash table pool to eliminate this O(n^2) search.
 void transaction_pool::filter(get_data_ptr message, result_handler handler)
 {
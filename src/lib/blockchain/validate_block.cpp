@@ -94,9 +94,11 @@ static const auto time_stamp_window = asio::seconds(2 * 60 * 60);
 static const auto time_stamp_window_future_blocktime_fix = asio::seconds(24);
 
 // The nullptr option is for backward compatibility only.
-validate_block::validate_block(size_t height, const block& block, bool testnet,
+validate_block::validate_block(threadpool& pool, size_t height,
+                               const block& block, bool testnet,
                                const config::checkpoint::list& checks, stopped_callback callback)
-    : testnet_(testnet),
+    : pool_(pool),
+      testnet_(testnet),
       height_(height),
       activations_(script_context::none_enabled),
       minimum_version_(0),
@@ -568,13 +570,18 @@ code validate_block::connect_block(hash_digest& err_tx) const
         }
     }
 
+    // Script verification dominates, so all inputs are connected up front in
+    // parallel and the results are tallied below in block order.
+    const auto connected = connect_inputs();
+
+    RETURN_IF_STOPPED();
+
     uint64_t fees = 0;
     size_t total_sigops = 0;
     const auto count = transactions.size();
     size_t coinage_reward_coinbase_index = 1;
     size_t get_coinage_reward_tx_count = 0;
 
-    ////////////// TODO: parallelize. //////////////
     for (size_t tx_index = 0; tx_index < count; ++tx_index)
     {
         uint64_t value_in = 0;
@@ -604,7 +611,8 @@ code validate_block::connect_block(hash_digest& err_tx) const
         RETURN_IF_STOPPED();
 
         // Consensus checks here.
-        if (!validate_inputs(tx, tx_index, value_in, total_sigops))
+        if (!validate_inputs(tx, tx_index, connected[tx_index], value_in,
+                             total_sigops))
         {
             err_tx = tx.hash();
             return error::validate_inputs_failed;
@@ -651,21 +659,79 @@ bool validate_block::is_spent_duplicate(const transaction& tx) const
     return true;
 }
 
+std::vector<validate_block::connected_inputs>
+validate_block::connect_inputs() const
+{
+    typedef std::pair<size_t, size_t> input_position;
+
+    const auto& transactions = current_block_.transactions;
+    std::vector<connected_inputs> connected(transactions.size());
+    std::vector<input_position> positions;
+
+    for (size_t tx_index = 0; tx_index < transactions.size(); ++tx_index)
+    {
+        const auto& tx = transactions[tx_index];
+        if (tx.is_coinbase())
+            continue;
+
+        connected[tx_index].resize(tx.inputs.size(), { false, 0, 0 });
+        for (size_t input_index = 0; input_index < tx.inputs.size();
+                ++input_index)
+            positions.emplace_back(tx_index, input_index);
+    }
+
+    // Each transaction is serialized once for the checks of all its inputs.
+    std::vector<validation_context::ptr> contexts(transactions.size());
+    const auto prepare = [&transactions, &contexts](size_t tx_index)
+    {
+        if (!transactions[tx_index].is_coinbase())
+            contexts[tx_index] = std::make_shared<const validation_context>(
+                transactions[tx_index]);
+    };
+
+    parallel_for(pool_, transactions.size(), prepare);
+
+    // Each input is connected in isolation against read-only chain state, so
+    // the per-input value and sigops are independent of scheduling order.
+    const auto connect = [this, &contexts, &positions, &connected](
+        size_t index)
+    {
+        if (stopped())
+            return;
+
+        const auto tx_index = positions[index].first;
+        const auto input_index = positions[index].second;
+        auto& result = connected[tx_index][input_index];
+        result.valid = connect_input(tx_index, *contexts[tx_index],
+            input_index, result.value, result.sigops);
+    };
+
+    parallel_for(pool_, positions.size(), connect);
+    return connected;
+}
+
 bool validate_block::validate_inputs(const transaction& tx,
-                                     size_t index_in_parent, uint64_t& value_in, size_t& total_sigops) const
+                                     size_t index_in_parent, const connected_inputs& connected,
+                                     uint64_t& value_in, size_t& total_sigops) const
 {
     BITCOIN_ASSERT(!tx.is_coinbase());
+    BITCOIN_ASSERT(connected.size() == tx.inputs.size());
 
-    ////////////// TODO: parallelize. //////////////
     for (size_t input_index = 0; input_index < tx.inputs.size(); ++input_index)
-        if (!connect_input(index_in_parent, tx, input_index, value_in,
-                           total_sigops))
+    {
+        const auto& input = connected[input_index];
+        total_sigops += input.sigops;
+        value_in += input.value;
+
+        if (!input.valid || total_sigops > max_block_script_sigops ||
+                value_in > max_money())
         {
             log::warning(LOG_BLOCKCHAIN) << "Invalid input ["
                                          << encode_hash(tx.hash()) << ":"
                                          << input_index << "]";
             return false;
         }
+    }
 
     return true;
 }
@@ -701,28 +767,51 @@ bool validate_block::get_transaction(const hash_digest& tx_hash,
 }
 
 bool validate_block::connect_input(size_t index_in_parent,
-                                   const transaction& current_tx, size_t input_index, uint64_t& value_in,
+                                   const validation_context& context, size_t input_index, uint64_t& value_in,
                                    size_t& total_sigops) const
 {
+    const auto& current_tx = context.tx();
     BITCOIN_ASSERT(input_index < current_tx.inputs.size());
 
     // Lookup previous output
     size_t previous_height;
-    transaction previous_tx;
+    bool previous_coinbase;
+    output previous_tx_out;
     const auto& input = current_tx.inputs[input_index];
     const auto& previous_output = input.previous_output;
 
-    // This searches the blockchain and then the orphan pool up to and
-    // including the current (orphan) block and excluding blocks above fork.
-    if (!fetch_transaction(previous_tx, previous_height, previous_output.hash))
+    // The unspent output set avoids loading the whole previous transaction
+    // and proves that the output is not spent, on a miss fall back to the
+    // transaction and spend lookups.
+    const auto unspent = fetch_unspent_output(previous_tx_out,
+        previous_height, previous_coinbase, previous_output, index_in_parent,
+        input_index);
+
+    if (!unspent)
     {
-        log::warning(LOG_BLOCKCHAIN)
-                << "Failure fetching input transaction ["
-                << encode_hash(previous_output.hash) << "]";
-        return false;
-    }
+        // This searches the blockchain and then the orphan pool up to and
+        // including the current (orphan) block and excluding blocks above fork.
+        transaction previous_tx;
+        if (!fetch_transaction(previous_tx, previous_height,
+            previous_output.hash))
+        {
+            log::warning(LOG_BLOCKCHAIN)
+                    << "Failure fetching input transaction ["
+                    << encode_hash(previous_output.hash) << "]";
+            return false;
+        }
 
-    const auto& previous_tx_out = previous_tx.outputs[previous_output.index];
+        if (previous_output.index >= previous_tx.outputs.size())
+        {
+            log::warning(LOG_BLOCKCHAIN)
+                    << "Input references a missing output of ["
+                    << encode_hash(previous_output.hash) << "]";
+            return false;
+        }
+
+        previous_tx_out = previous_tx.outputs[previous_output.index];
+        previous_coinbase = previous_tx.is_coinbase();
+    }
 
     // Signature operations count if script_hash payment type.
     size_t count;
@@ -749,7 +838,7 @@ bool validate_block::connect_input(size_t index_in_parent,
     }
 
     // Check coinbase maturity has been reached
-    if (previous_tx.is_coinbase())
+    if (previous_coinbase)
     {
         BITCOIN_ASSERT(previous_height <= height_);
         const auto height_difference = height_ - previous_height;
@@ -761,14 +850,15 @@ bool validate_block::connect_input(size_t index_in_parent,
     }
 
     if (!validate_transaction::check_consensus(previous_tx_out.script,
-            current_tx, input_index, activations_))
+            context, input_index, activations_))
     {
         log::warning(LOG_BLOCKCHAIN) << "Input script invalid consensus.";
         return false;
     }
 
     // Search for double spends.
-    if (is_output_spent(previous_output, index_in_parent, input_index))
+    if (!unspent &&
+        is_output_spent(previous_output, index_in_parent, input_index))
     {
         log::warning(LOG_BLOCKCHAIN) << "Double spend attempt.";
         return false;
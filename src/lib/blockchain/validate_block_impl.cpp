@@ -34,12 +34,12 @@ namespace blockchain {
 // Value used to define median time past.
 static constexpr size_t median_time_past_blocks = 11;
 
-validate_block_impl::validate_block_impl(block_chain_impl& chain,
-    size_t fork_index, const block_detail::list& orphan_chain,
-    size_t orphan_index, size_t height, const chain::block& block,
-    bool testnet, const config::checkpoint::list& checks,
-    stopped_callback stopped)
-  : validate_block(height, block, testnet, checks, stopped),
+validate_block_impl::validate_block_impl(threadpool& pool,
+    block_chain_impl& chain, size_t fork_index,
+    const block_detail::list& orphan_chain, size_t orphan_index,
+    size_t height, const chain::block& block, bool testnet,
+    const config::checkpoint::list& checks, stopped_callback stopped)
+  : validate_block(pool, height, block, testnet, checks, stopped),
     chain_(chain),
     height_(height),
     fork_index_(fork_index),
@@ -50,6 +50,11 @@ validate_block_impl::validate_block_impl(block_chain_impl& chain,
 
 bool validate_block_impl::is_valid_proof_of_work(const chain::header& header) const
 {
+    // Already checked (and a failure logged) by the organizer.
+    const auto& detail = orphan_chain_[orphan_index_];
+    if (detail->get_is_checked_seal())
+        return detail->get_is_valid_seal();
+
     chain::header parent_header;
     if(orphan_index_ != 0) {
         parent_header = orphan_chain_[orphan_index_ - 1]->actual()->header;
@@ -210,6 +215,29 @@ bool validate_block_impl::is_output_spent(
     return false;
 }
 
+bool validate_block_impl::fetch_unspent_output(chain::output& out_output,
+    size_t& out_height, bool& out_coinbase,
+    const chain::output_point& previous_output, size_t index_in_parent,
+    size_t input_index) const
+{
+    database::unspent_output unspent;
+    if (!chain_.get_unspent_output(unspent, previous_output))
+        return false;
+
+    // Outputs above the fork are not part of the chain being validated.
+    if (tx_after_fork(unspent.height, fork_index_))
+        return false;
+
+    // The set only covers the chain, the orphan chain may also spend it.
+    if (orphan_is_spent(previous_output, index_in_parent, input_index))
+        return false;
+
+    out_output = std::move(unspent.output);
+    out_height = unspent.height;
+    out_coinbase = unspent.coinbase;
+    return true;
+}
+
 bool validate_block_impl::orphan_is_spent(
     const chain::output_point& previous_output,
     size_t skip_tx, size_t skip_input) const
@@ -26,6 +26,7 @@
 #include <functional>
 #include <memory>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/script_cache.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/blockchain/validate_block.hpp>
 #include <metaverse/consensus/miner.hpp>
@@ -54,6 +55,32 @@ using namespace std::placeholders;
 // Max transaction size is set to max block size (1,000,000).
 static constexpr uint32_t max_transaction_size = 1000000;
 
+validation_context::validation_context(const chain::transaction& tx)
+    : tx_(tx),
+      hash_(tx.hash())
+{
+#ifdef WITH_CONSENSUS
+    const auto data = tx.to_data();
+    prepared_ = std::make_shared<const consensus::prepared_transaction>(
+        data.data(), data.size());
+#endif
+}
+
+const chain::transaction& validation_context::tx() const
+{
+    return tx_;
+}
+
+const hash_digest& validation_context::hash() const
+{
+    return hash_;
+}
+
+const consensus::prepared_transaction* validation_context::prepared() const
+{
+    return prepared_.get();
+}
+
 validate_transaction::validate_transaction(block_chain& chain,
     const chain::transaction& tx, const validate_block& validate_block)
     : blockchain_(static_cast<blockchain::block_chain_impl&>(chain)),
@@ -189,11 +216,27 @@ void validate_transaction::set_last_height(const code& ec,
 void validate_transaction::next_previous_transaction()
 {
     BITCOIN_ASSERT(current_input_ < tx_->inputs.size());
+    const auto& previous_output = tx_->inputs[current_input_].previous_output;
+
+    // A hit in the unspent output set also proves the chain has not spent
+    // the output, so neither the previous tx nor its spend are fetched.
+    database::unspent_output unspent;
+    if (blockchain_.get_unspent_output(unspent, previous_output))
+    {
+        if (!connect_input(unspent.output, unspent.coinbase, unspent.height))
+        {
+            const auto list = point::indexes{ current_input_ };
+            handle_validate_(error::validate_inputs_failed, tx_, list);
+            return;
+        }
+
+        check_double_spend(error::unspent_output, {});
+        return;
+    }
 
     // First we fetch the parent block height for a transaction.
     // Needed for checking the coinbase maturity.
-    blockchain_.fetch_transaction_index(
-        tx_->inputs[current_input_].previous_output.hash,
+    blockchain_.fetch_transaction_index(previous_output.hash,
         dispatch_->unordered_delegate(
             &validate_transaction::previous_tx_index,
             shared_from_this(), _1, _2));
@@ -1466,14 +1509,28 @@ code validate_transaction::check_transaction_basic() const
 bool validate_transaction::check_consensus(const script& prevout_script,
         const transaction& current_tx, size_t input_index, uint32_t flags)
 {
+    const validation_context context(current_tx);
+    return check_consensus(prevout_script, context, input_index, flags);
+}
+
+bool validate_transaction::check_consensus(const script& prevout_script,
+        const validation_context& context, size_t input_index, uint32_t flags)
+{
+    const auto& current_tx = context.tx();
     BITCOIN_ASSERT(input_index <= max_uint32);
     BITCOIN_ASSERT(input_index < current_tx.inputs.size());
     const auto input_index32 = static_cast<uint32_t>(input_index);
 
+    // Inputs verified on pool acceptance are not verified again in the block.
+    auto& cache = script_cache::instance();
+    const auto& tx_hash = context.hash();
+    const auto previous_output_script = prevout_script.to_data(false);
+    if (cache.contains(tx_hash, input_index32, previous_output_script, flags))
+        return true;
+
 #ifdef WITH_CONSENSUS
     using namespace bc::consensus;
-    const auto previous_output_script = prevout_script.to_data(false);
-    data_chunk current_transaction = current_tx.to_data();
+    BITCOIN_ASSERT(context.prepared() != nullptr);
 
     // Convert native flags to libbitcoin-consensus flags.
     uint32_t consensus_flags = verify_flags_none;
@@ -1490,27 +1547,29 @@ bool validate_transaction::check_consensus(const script& prevout_script,
     if ((flags & script_context::attenuation_enabled) != 0)
         consensus_flags |= verify_flags_checkattenuationverify;
 
-    const auto result = verify_script(current_transaction.data(),
-                                      current_transaction.size(), previous_output_script.data(),
-                                      previous_output_script.size(), input_index32, consensus_flags);
+    const auto result = verify_script(*context.prepared(),
+                                      previous_output_script.data(), previous_output_script.size(),
+                                      input_index32, consensus_flags);
 
     const auto valid = (result == verify_result::verify_result_eval_true);
 #else
     // Copy the const prevout script so it can be run.
-    auto previous_output_script = prevout_script;
+    auto previous_script = prevout_script;
     const auto& current_input_script = current_tx.inputs[input_index].script;
 
     const auto valid = script::verify(current_input_script,
-                                      previous_output_script, current_tx, input_index32, flags);
+                                      previous_script, current_tx, input_index32, flags);
 #endif
 
     if (!valid) {
         log::warning(LOG_BLOCKCHAIN)
                 << "Invalid transaction ["
-                << encode_hash(current_tx.hash()) << "]";
+                << encode_hash(tx_hash) << "]";
+        return false;
     }
 
-    return valid;
+    cache.store(tx_hash, input_index32, previous_output_script, flags);
+    return true;
 }
 
 bool validate_transaction::connect_input( const transaction& previous_tx, size_t parent_height)
@@ -1523,7 +1582,13 @@ bool validate_transaction::connect_input( const transaction& previous_tx, size_t
         return false;
     }
 
-    const auto& previous_output = previous_tx.outputs[previous_outpoint.index];
+    return connect_input(previous_tx.outputs[previous_outpoint.index],
+        previous_tx.is_coinbase(), parent_height);
+}
+
+bool validate_transaction::connect_input(const output& previous_output,
+    bool previous_coinbase, size_t parent_height)
+{
     const auto output_value = previous_output.value;
     if (output_value > max_money()) {
         log::debug(LOG_BLOCKCHAIN) << "output etp value exceeds max amount!";
@@ -1597,14 +1662,18 @@ bool validate_transaction::connect_input( const transaction& previous_tx, size_t
         }
     }
 
-    if (previous_tx.is_coinbase()) {
+    if (previous_coinbase) {
         const auto height_difference = last_block_height_ - parent_height;
         if (height_difference < coinbase_maturity) {
             return false;
         }
     }
 
-    if (!check_consensus(previous_output.script, *tx_, current_input_, script_context::all_enabled)) {
+    // Prepared once and reused for the remaining inputs of this transaction.
+    if (!context_)
+        context_ = std::make_shared<const validation_context>(*tx_);
+
+    if (!check_consensus(previous_output.script, *context_, current_input_, script_context::all_enabled)) {
         log::debug(LOG_BLOCKCHAIN) << "check_consensus failed";
         return false;
     }
@@ -8,11 +8,15 @@
 #include <chrono>
 #include <array>
 #include <thread>
+#include <limits>
+#include <mutex>
+#include <vector>
 #include <metaverse/consensus/miner/MinerAux.h>
 #include <random>
 #include <metaverse/consensus/libdevcore/Exceptions.h>
 #include <boost/throw_exception.hpp>
 #include <metaverse/bitcoin/utility/log.hpp>
+#include <metaverse/bitcoin/utility/parallel.hpp>
 
 
 using namespace libbitcoin;
@@ -34,49 +38,178 @@ MinerAux* MinerAux::get()
 
 LightType MinerAux::get_light(h256& _seedHash)
 {
-	UpgradableGuard l(get()->x_lights);
-	if (get()->m_lights.count(_seedHash))
-		return get()->m_lights.at(_seedHash);
-	UpgradeGuard l2(l);
-	return (get()->m_lights[_seedHash] = make_shared<LightAllocation>(_seedHash));
+	{
+		ReadGuard l(get()->x_lights);
+		auto it = get()->m_lights.find(_seedHash);
+		if (it != get()->m_lights.end())
+			return it->second;
+	}
+	// build the cache outside the lock so lookups of other epochs go on
+	auto light = make_shared<LightAllocation>(_seedHash);
+	WriteGuard l(get()->x_lights);
+	auto inserted = get()->m_lights.emplace(_seedHash, light);
+	if (inserted.second)
+	{
+		get()->m_lightOrder.push_back(_seedHash);
+		if (get()->m_lightOrder.size() > c_maxLights)
+		{
+			get()->m_lights.erase(get()->m_lightOrder.front());
+			get()->m_lightOrder.pop_front();
+		}
+	}
+	return inserted.first->second;
+}
+
+void MinerAux::warm_light(h256 _seedHash)
+{
+	{
+		WriteGuard l(get()->x_lights);
+		if (get()->m_lights.count(_seedHash) || !get()->m_lightsWarming.insert(_seedHash).second)
+			return;
+	}
+	const auto started = spawn([_seedHash]() mutable {
+		try {
+			get_light(_seedHash);
+		} catch (...) {
+			log::debug(LOG_MINER) << "failed to prepare light cache\n";
+		}
+		WriteGuard l(get()->x_lights);
+		get()->m_lightsWarming.erase(_seedHash);
+	});
+	if (!started)
+	{
+		WriteGuard l(get()->x_lights);
+		get()->m_lightsWarming.erase(_seedHash);
+	}
+}
+
+bool MinerAux::spawn(std::function<void()> _job)
+{
+	auto done = make_shared<std::atomic<bool>>(false);
+	Guard l(get()->x_workers);
+	if (get()->m_stopped)
+		return false;
+	// join the finished ones so the list stays at the running preparations
+	auto& workers = get()->m_workers;
+	for (auto it = workers.begin(); it != workers.end();)
+	{
+		if (*it->second)
+		{
+			it->first.join();
+			it = workers.erase(it);
+		}
+		else
+			++it;
+	}
+	workers.emplace_back(std::thread([_job, done] {
+		_job();
+		*done = true;
+	}), done);
+	return true;
 }
 
-//static std::function<int(unsigned)> s_dagCallback;
+void MinerAux::stop()
+{
+	std::vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> workers;
+	DEV_GUARDED(get()->x_workers)
+	{
+		get()->m_stopped = true;
+		workers.swap(get()->m_workers);
+	}
+	for (auto& worker: workers)
+		worker.first.join();
+}
 
 static int dagCallbackShim(unsigned _p)
 {
-	return 0;
+	if (_p % 10 == 0)
+		log::debug(LOG_MINER) << "generating dag: " << _p << "%\n";
+	// a non zero return aborts the generation, see ethash_full_new
+	return MinerAux::stopped() ? 1 : 0;
+}
+
+void MinerAux::set_dag_threads(unsigned _threads)
+{
+	if (_threads == 0)
+		_threads = std::thread::hardware_concurrency();
+	ethash_set_dag_threads(_threads);
 }
+
 FullType MinerAux::get_full(h256& _seedHash)
+{
+	return load_full(_seedHash, false);
+}
+
+FullType MinerAux::load_full(h256& _seedHash, bool _next)
 {
 	FullType ret;
 	auto l = get_light(_seedHash);
-	DEV_GUARDED(get()->x_fulls)
-	if ((ret = get()->m_fulls[_seedHash].lock()))
 	{
-		get()->m_lastUsedFull = ret;
-		return ret;
+		// wait for a concurrent generation of the same DAG instead of redoing it
+		std::unique_lock<Mutex> lock(get()->x_fulls);
+		get()->m_fullsChanged.wait(lock, [&]{ return !get()->m_generating.count(_seedHash); });
+		if ((ret = get()->m_fulls[_seedHash].lock()))
+		{
+			(_next ? get()->m_nextFull : get()->m_lastUsedFull) = ret;
+			return ret;
+		}
+		get()->m_generating.insert(_seedHash);
+	}
+	try
+	{
+		ret = make_shared<FullAllocation>(l->light, dagCallbackShim);
+	}
+	catch (...)
+	{
+		DEV_GUARDED(get()->x_fulls)
+		get()->m_generating.erase(_seedHash);
+		get()->m_fullsChanged.notify_all();
+		throw;
 	}
-	//s_dagCallback = _f;
-	ret = make_shared<FullAllocation>(l->light, dagCallbackShim);
 	DEV_GUARDED(get()->x_fulls)
-	get()->m_fulls[_seedHash] = get()->m_lastUsedFull = ret;
+	{
+		get()->m_fulls[_seedHash] = ret;
+		(_next ? get()->m_nextFull : get()->m_lastUsedFull) = ret;
+		get()->m_generating.erase(_seedHash);
+	}
+	get()->m_fullsChanged.notify_all();
 	return ret;
 }
 
-bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (void)> is_exit)
+void MinerAux::prepare_next(libbitcoin::chain::header& _header)
+{
+	libbitcoin::chain::header next(_header);
+	next.number = (_header.number / ETHASH_EPOCH_LENGTH + 1) * ETHASH_EPOCH_LENGTH;
+	h256 seed = HeaderAux::seedHash(next);
+	DEV_GUARDED(get()->x_fulls)
+	if (get()->m_generating.count(seed) || get()->m_fulls[seed].lock())
+		return;
+	spawn([seed]() mutable {
+		log::debug(LOG_MINER) << "start generate next epoch dag\n";
+		try {
+			load_full(seed, true);
+		} catch (const ExternalFunctionFailure&) {
+			if (!stopped())
+				log::error(LOG_MINER) << "failed to generate next epoch dag\n";
+		} catch (const std::exception& e) {
+			log::error(LOG_MINER) << "failed to generate next epoch dag: " << e.what() << "\n";
+		} catch (...) {
+			log::error(LOG_MINER) << "failed to generate next epoch dag\n";
+		}
+	});
+}
+
+bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (void)> is_exit, unsigned threads)
 {
 	auto tid = std::this_thread::get_id();
 	static std::mt19937_64 s_eng((utcTime() + std::hash<decltype(tid)>()(tid)));
 	uint64_t tryNonce = s_eng();
-	ethash_return_value ethashReturn;
 	FullType dag;
 	h256 seed = HeaderAux::seedHash(header);
 	h256 header_hash = HeaderAux::hashHead(header);
 	h256 boundary = HeaderAux::boundary(header);
-    std::chrono::steady_clock::time_point timeStart;
-    uint64_t ms;
-    uint64_t hashCount = 1;
+	std::chrono::steady_clock::time_point timeStart;
+	uint64_t ms;
 
 	while( nullptr == dag)
 	{
@@ -87,31 +220,71 @@ bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (voi
             return false;
         }
 	}
-	log::debug(LOG_MINER) << "Start miner @ height:  "<< header.number << '\n';
-    timeStart = std::chrono::steady_clock::now();
-	for (; ; tryNonce++, hashCount++)
+	if (get()->m_pregenerate)
+		prepare_next(header);
+	log::debug(LOG_MINER) << "Start miner @ height:  "<< header.number << " with " << threads << " thread(s)\n";
+
+	// every worker walks its own slice of the nonce space and only checks the
+	// shared flag, the caller polls is_exit() on behalf of all of them
+	threads = threads ? threads : 1;
+	std::atomic<bool> stop{false};
+	std::atomic<bool> found{false};
+	std::atomic<uint64_t> hashCount{0};
+	uint64_t foundNonce = 0;
+	h256 foundMix;
+	std::mutex mutex;
+	std::condition_variable stopped;
+	auto worker = [&](uint64_t nonce)
 	{
-		ethashReturn = ethash_full_compute(dag->full, *(ethash_h256_t*)header_hash.data(), tryNonce);
-		h256 value = h256((uint8_t*)&ethashReturn.result, h256::ConstructFromPointer);
-		h256 mixhash =h256((uint8_t*)&ethashReturn.mix_hash, h256::ConstructFromPointer);
-		if (value <= boundary )
+		uint64_t count = 0;
+		for (; !stop.load(std::memory_order_relaxed); ++nonce)
 		{
-			MinerAux::setNonce(header, (u64)tryNonce);
-			MinerAux::setMixHash(header, mixhash);
-			log::debug(LOG_MINER) << "find slolution! block height: "<< header.number << '\n';
-			break;
-		}
-		if(is_exit() == true)
-		{
-			ethashReturn.success = false;
-			return ethashReturn.success;
+			ethash_return_value ethashReturn = ethash_full_compute(dag->full, *(ethash_h256_t*)header_hash.data(), nonce);
+			if (++count % 1024 == 0)
+				hashCount += 1024;
+			if (h256((uint8_t*)&ethashReturn.result, h256::ConstructFromPointer) <= boundary)
+			{
+				bool expected = false;
+				if (found.compare_exchange_strong(expected, true))
+				{
+					foundNonce = nonce;
+					foundMix = h256((uint8_t*)&ethashReturn.mix_hash, h256::ConstructFromPointer);
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+				stopped.notify_all();
+			}
 		}
+		hashCount += count % 1024;
+	};
+
+	timeStart = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	uint64_t const stride = std::numeric_limits<uint64_t>::max() / threads;
+	for (unsigned i = 0; i < threads; ++i)
+		workers.emplace_back(worker, tryNonce + i * stride);
+
+	for (std::unique_lock<std::mutex> lock(mutex); !stop; )
+	{
+		if (stopped.wait_for(lock, std::chrono::milliseconds(100), [&]{ return stop.load(); }))
+			break;
+		if (is_exit())
+			stop = true;
+		ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count();
+		get()->m_rate = hashCount * 1000 / (ms ? ms : 1);
 	}
-    ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count();
-    ms = ms? ms : 1;
-    get()->m_rate = hashCount * 1000 / ms;
+	for (auto& thread: workers)
+		thread.join();
+
+	ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count();
+	get()->m_rate = hashCount * 1000 / (ms ? ms : 1);
+	if (!found)
+		return false;
 
-	return ethashReturn.success;
+	MinerAux::setNonce(header, (u64)foundNonce);
+	MinerAux::setMixHash(header, foundMix);
+	log::debug(LOG_MINER) << "find slolution! block height: "<< header.number << '\n';
+	return true;
 }
 
 bool MinerAux::verifySeal(libbitcoin::chain::header& _header, libbitcoin::chain::header& _parent)
@@ -125,30 +298,54 @@ bool MinerAux::verifySeal(libbitcoin::chain::header& _header, libbitcoin::chain:
 		log::error(LOG_MINER) << _header.number<<" block , verify diffculty failed\n";
 		return false;
 	}
+	FullType dag;
 	DEV_GUARDED(get()->x_fulls)
-	if (FullType dag = get()->m_fulls[seedHash].lock())
 	{
-		result = dag->compute(headerHash, nonce);
-
-		if(result.value <= HeaderAux::boundary(_header) && (result.mixHash).hex() == ((h256)_header.mixhash).hex())
-		{
-			//log::debug(LOG_MINER) << _header.number <<" block has been verified (Full)\n";
-			return true;
-		}
-		return false;
+		auto it = get()->m_fulls.find(seedHash);
+		if (it != get()->m_fulls.end())
+			dag = it->second.lock();
 	}
-	result = get()->get_light(seedHash)->compute(headerHash, nonce);
-	if(result.value <= HeaderAux::boundary(_header) && (result.mixHash).hex() == ((h256)_header.mixhash).hex())
-	{
-		//log::debug(LOG_MINER) << _header.number <<" block has been verified (Light)\n";
+	if (dag)
+		result = dag->compute(headerHash, nonce);
+	else
+		result = get_light(seedHash)->compute(headerHash, nonce);
+	if(result.value <= HeaderAux::boundary(_header) && result.mixHash == (h256)_header.mixhash)
 		return true;
-	}
 	log::error(LOG_MINER) << _header.number <<" block  verified failed !\n";
 	return false;
 }
 
+std::vector<MinerAux::Seal> MinerAux::verifySeals(threadpool& _pool, const std::vector<std::pair<chain::header*, chain::header*>>& _items)
+{
+	std::vector<Seal> seals(_items.size(), Seal::unchecked);
+	if (_items.empty())
+		return seals;
 
+	// build the light caches up front instead of once per racing worker,
+	// and the one of the following epoch in the background
+	std::unordered_set<h256> seeds;
+	chain::header* last = _items.front().first;
+	for (auto& item: _items)
+	{
+		seeds.insert(HeaderAux::seedHash(*item.first));
+		if (item.first->number > last->number)
+			last = item.first;
+	}
+	try {
+		for (auto seed: seeds)
+			get_light(seed);
+	} catch (...) {
+		// verifySeal reports the failure per header
+	}
+	warm_light(sha3(HeaderAux::seedHash(*last)));
 
-
-
-
+	parallel_for(_pool, _items.size(), [&](size_t i)
+	{
+		try {
+			seals[i] = verifySeal(*_items[i].first, *_items[i].second) ? Seal::valid : Seal::invalid;
+		} catch (...) {
+			// left unchecked, the block validation checks it again
+		}
+	});
+	return seals;
+}
@@ -179,35 +179,79 @@ unsigned int verify_flags_to_script_flags(unsigned int flags)
     return script_flags;
 }
 
+// Not published, the deserialized transaction shared by all input checks.
+class prepared_transaction::implementation
+{
+public:
+    implementation(const unsigned char* transaction, size_t transaction_size)
+      : status(verify_result_eval_true)
+    {
+        if (transaction_size > 0 && transaction == NULL)
+            throw std::invalid_argument("transaction");
+
+        try
+        {
+            TxInputStream stream(transaction, transaction_size);
+            Unserialize(stream, tx, SER_NETWORK, PROTOCOL_VERSION);
+        }
+        catch (const std::exception& e)
+        {
+            status = verify_result_tx_invalid;
+            return;
+        }
+
+        if (tx.GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION) !=
+            transaction_size)
+            status = verify_result_tx_size_invalid;
+    }
+
+    CTransaction tx;
+    verify_result_type status;
+};
+
+prepared_transaction::prepared_transaction(const unsigned char* transaction,
+    size_t transaction_size)
+  : impl_(std::make_shared<const implementation>(transaction,
+        transaction_size))
+{
+}
+
+verify_result_type prepared_transaction::status() const
+{
+    return impl_->status;
+}
+
+const prepared_transaction::implementation& prepared_transaction::impl() const
+{
+    return *impl_;
+}
+
 // This function is published. The implementation exposes no satoshi internals.
 verify_result_type verify_script(const unsigned char* transaction, 
     size_t transaction_size, const unsigned char* prevout_script, 
     size_t prevout_script_size, unsigned int tx_input_index, 
     unsigned int flags)
 {
-    if (transaction_size > 0 && transaction == NULL)
-        throw std::invalid_argument("transaction");
+    const prepared_transaction prepared(transaction, transaction_size);
+    return verify_script(prepared, prevout_script, prevout_script_size,
+        tx_input_index, flags);
+}
 
+// This function is published. The implementation exposes no satoshi internals.
+verify_result_type verify_script(const prepared_transaction& transaction,
+    const unsigned char* prevout_script, size_t prevout_script_size,
+    unsigned int tx_input_index, unsigned int flags)
+{
     if (prevout_script_size > 0 && prevout_script == NULL)
         throw std::invalid_argument("prevout_script");
 
-    CTransaction tx;
-    try 
-    {
-        TxInputStream stream(transaction, transaction_size);
-        Unserialize(stream, tx, SER_NETWORK, PROTOCOL_VERSION);
-    }
-    catch (const std::exception& e)
-    {
-        return verify_result_tx_invalid;
-    }
+    if (transaction.status() != verify_result_eval_true)
+        return transaction.status();
 
+    const auto& tx = transaction.impl().tx;
     if (tx_input_index >= tx.vin.size())
         return verify_result_tx_input_invalid;
 
-    if (tx.GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION) != transaction_size)
-        return verify_result_tx_size_invalid;
-
     ScriptError_t error;
     TransactionSignatureChecker checker(&tx, tx_input_index);
     const unsigned int script_flags = verify_flags_to_script_flags(flags);
@@ -69,11 +69,15 @@ miner::miner(p2p_node& node)
     , state_(state::init_)
     , new_block_number_(0)
     , new_block_limit_(0)
+    , threads_(1)
     , setting_(node_.chain_impl().chain_settings())
 {
     if (setting_.use_testnet_rules) {
         bc::HeaderAux::set_as_testnet();
     }
+
+    MinerAux::set_dag_threads(setting_.dag_threads);
+    MinerAux::set_dag_pregenerate(setting_.dag_pregenerate);
 }
 
 miner::~miner()
@@ -90,7 +94,13 @@ bool miner::get_input_etp(const transaction& tx, const std::vector<transaction_p
         transaction prev_tx;
         uint64_t prev_height = 0;
         uint64_t input_value = 0;
-        if (block_chain.get_transaction(prev_tx, prev_height, input.previous_output.hash)) {
+        database::unspent_output unspent;
+        if (block_chain.get_unspent_output(unspent, input.previous_output)) {
+            input_value = unspent.output.value;
+            previous_out_map[input.previous_output] =
+                std::make_pair(unspent.height, std::move(unspent.output));
+        }
+        else if (block_chain.get_transaction(prev_tx, prev_height, input.previous_output.hash)) {
             input_value = prev_tx.outputs[input.previous_output.index].value;
             previous_out_map[input.previous_output] =
                 std::make_pair(prev_height, prev_tx.outputs[input.previous_output.index]);
@@ -209,6 +219,11 @@ bool miner::get_transaction(std::vector<transaction_ptr>& transactions,
 bool miner::script_hash_signature_operations_count(size_t &count, const chain::input& input, vector<transaction_ptr>& transactions)
 {
     const auto& previous_output = input.previous_output;
+    database::unspent_output unspent;
+    if (node_.chain_impl().get_unspent_output(unspent, previous_output)) {
+        return blockchain::validate_block::script_hash_signature_operations_count(count, unspent.output.script, input.script);
+    }
+
     transaction previous_tx;
     boost::uint64_t h;
     if (node_.chain_impl().get_transaction(previous_tx, h, previous_output.hash) == false) {
@@ -631,11 +646,12 @@ std::string to_string(_T const& _t)
 
 void miner::work(const wallet::payment_address pay_address)
 {
-    log::info(LOG_HEADER) << "solo miner start with address: " << pay_address.encoded();
+    log::info(LOG_HEADER) << "solo miner start with address: " << pay_address.encoded()
+                          << ", threads: " << threads_;
     while (state_ != state::exit_) {
         block_ptr block = create_new_block(pay_address);
         if (block) {
-            if (MinerAux::search(block->header, std::bind(&miner::is_stop_miner, this, block->header.number))) {
+            if (MinerAux::search(block->header, std::bind(&miner::is_stop_miner, this, block->header.number), threads_)) {
                 boost::uint64_t height = store_block(block);
                 if (height == 0) {
                     continue;
@@ -659,20 +675,21 @@ bool miner::is_stop_miner(uint64_t block_height) const
     return (state_ == state::exit_) || (get_height() > block_height);
 }
 
-bool miner::start(const wallet::payment_address& pay_address, uint16_t number)
+bool miner::start(const wallet::payment_address& pay_address, uint16_t number, uint16_t threads)
 {
     if (!thread_) {
         new_block_limit_ = number;
+        threads_ = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
         thread_.reset(new boost::thread(bind(&miner::work, this, pay_address)));
     }
     return true;
 }
 
-bool miner::start(const std::string& public_key, uint16_t number)
+bool miner::start(const std::string& public_key, uint16_t number, uint16_t threads)
 {
     wallet::payment_address pay_address = libbitcoin::wallet::ec_public(public_key).to_payment_address();
     if (pay_address) {
-        return start(pay_address, number);
+        return start(pay_address, number, threads);
     }
     return false;
 }
@@ -135,6 +135,57 @@ bool data_base::initialize_mits(const path& prefix)
     return instance.stop();
 }
 
+bool data_base::initialize_utxos(const path& prefix)
+{
+    const store paths(prefix);
+    if (paths.utxos_exist())
+        return true;
+    if (!paths.touch_utxos())
+        return false;
+
+    data_base instance(prefix, 0, 0);
+    if (!instance.create_utxos())
+        return false;
+
+    // Outputs confirmed before this upgrade are resolved from the tx table.
+    log::info(LOG_DATABASE)
+        << "Upgrading utxo table is complete.";
+
+    return instance.stop();
+}
+
+bool data_base::initialize_balances(const path& prefix)
+{
+    const store paths(prefix);
+    if (paths.balances_exist())
+        return true;
+    if (!paths.touch_balances())
+        return false;
+
+    // Balances are computed from the address history until the blocks
+    // confirmed before this upgrade are indexed.
+    data_base instance(prefix, 0, 0);
+    if (!instance.create_balances() || !instance.index_balances())
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Upgrading address balance table is complete.";
+
+    return instance.stop();
+}
+
+bool data_base::initialize_journal(const path& prefix)
+{
+    const store paths(prefix);
+    if (paths.journal_exists())
+        return true;
+    if (!paths.touch_journal())
+        return false;
+
+    write_journal journal(paths.journal);
+    return journal.create() && journal.close();
+}
+
 bool data_base::upgrade_version_63(const path& prefix)
 {
     auto metadata_path = prefix / db_metadata::file_name;
@@ -165,6 +216,24 @@ bool data_base::upgrade_version_63(const path& prefix)
         return false;
     }
 
+    if (!initialize_utxos(prefix)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade utxo database.";
+        return false;
+    }
+
+    if (!initialize_balances(prefix)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade address balance database.";
+        return false;
+    }
+
+    if (!initialize_journal(prefix)) {
+        log::error(LOG_DATABASE)
+            << "Failed to create write journal.";
+        return false;
+    }
+
     if (metadata.version_ != db_metadata::current_version) {
         // write new db version to metadata
         metadata = db_metadata(db_metadata::current_version);
@@ -203,6 +272,9 @@ data_base::store::store(const path& prefix)
     history_lookup = prefix / "history_table";
     spends_lookup = prefix / "spend_table";
     transactions_lookup = prefix / "transaction_table";
+    utxos_lookup = prefix / "utxo_table";
+    balances_lookup = prefix / "address_balance_table";
+    balances_outputs = prefix / "address_balance_output_table";
     /* begin database for account, asset, address_asset relationship */
     accounts_lookup = prefix / "account_table";
     assets_lookup = prefix / "asset_table";  // for blockchain assets
@@ -228,10 +300,14 @@ data_base::store::store(const path& prefix)
 
     // One (address) to many (rows).
     history_rows = prefix / "history_rows";
+    balances_rows = prefix / "address_balance_rows";
     stealth_rows = prefix / "stealth_rows";
 
     // Exclusive database access reserved by this process.
     database_lock = prefix / "process_lock";
+
+    // Undo log of the block write in progress.
+    journal = prefix / "write_journal";
 }
 
 bool data_base::store::touch_all() const
@@ -245,6 +321,10 @@ bool data_base::store::touch_all() const
         touch_file(stealth_rows) &&
         touch_file(spends_lookup) &&
         touch_file(transactions_lookup) &&
+        touch_file(utxos_lookup) &&
+        touch_file(balances_lookup) &&
+        touch_file(balances_outputs) &&
+        touch_file(balances_rows) &&
         /* begin database for account, asset, address_asset relationship */
         touch_file(accounts_lookup) &&
         touch_file(assets_lookup) &&
@@ -263,7 +343,8 @@ bool data_base::store::touch_all() const
         touch_file(address_mits_lookup) &&
         touch_file(address_mits_rows) &&
         touch_file(mit_history_lookup) &&
-        touch_file(mit_history_rows);
+        touch_file(mit_history_rows) &&
+        touch_file(journal);
 }
 
 bool data_base::store::dids_exist() const
@@ -292,6 +373,42 @@ bool data_base::store::touch_certs() const
     return touch_file(certs_lookup);
 }
 
+bool data_base::store::utxos_exist() const
+{
+    return boost::filesystem::exists(utxos_lookup);
+}
+
+bool data_base::store::touch_utxos() const
+{
+    return touch_file(utxos_lookup);
+}
+
+bool data_base::store::balances_exist() const
+{
+    return
+        boost::filesystem::exists(balances_lookup) ||
+        boost::filesystem::exists(balances_outputs) ||
+        boost::filesystem::exists(balances_rows);
+}
+
+bool data_base::store::touch_balances() const
+{
+    return
+        touch_file(balances_lookup) &&
+        touch_file(balances_outputs) &&
+        touch_file(balances_rows);
+}
+
+bool data_base::store::journal_exists() const
+{
+    return boost::filesystem::exists(journal);
+}
+
+bool data_base::store::touch_journal() const
+{
+    return touch_file(journal);
+}
+
 bool data_base::store::mits_exist() const
 {
     return
@@ -459,6 +576,9 @@ data_base::data_base(const store& paths, size_t history_height,
     stealth(paths.stealth_rows, mutex_),
     spends(paths.spends_lookup, mutex_),
     transactions(paths.transactions_lookup, mutex_),
+    utxos(paths.utxos_lookup, mutex_),
+    balances(paths.balances_lookup, paths.balances_outputs,
+        paths.balances_rows, mutex_),
     /* begin database for account, asset, address_asset, did relationship */
     accounts(paths.accounts_lookup, mutex_),
     assets(paths.assets_lookup, mutex_),
@@ -471,7 +591,8 @@ data_base::data_base(const store& paths, size_t history_height,
     /* end database for account, asset, address_asset, did relationship */
     mits(paths.mits_lookup, mutex_),
     address_mits(paths.address_mits_lookup, paths.address_mits_rows, mutex_),
-    mit_history(paths.mit_history_lookup, paths.mit_history_rows, mutex_)
+    mit_history(paths.mit_history_lookup, paths.mit_history_rows, mutex_),
+    journal_(paths.journal)
 {
 }
 
@@ -519,6 +640,8 @@ bool data_base::create()
         spends.create() &&
         stealth.create() &&
         transactions.create() &&
+        utxos.create() &&
+        balances.create(true) &&
         /* begin database for account, asset, address_asset relationship */
         accounts.create() &&
         assets.create() &&
@@ -531,7 +654,8 @@ bool data_base::create()
         /* end database for account, asset, address_asset relationship */
         mits.create() &&
         address_mits.create() &&
-        mit_history.create()
+        mit_history.create() &&
+        journal_.create()
         ;
 }
 
@@ -548,6 +672,18 @@ bool data_base::create_certs()
         certs.create();
 }
 
+bool data_base::create_utxos()
+{
+    return
+        utxos.create();
+}
+
+bool data_base::create_balances()
+{
+    return
+        balances.create(false);
+}
+
 bool data_base::create_mits()
 {
     return
@@ -574,6 +710,10 @@ bool data_base::start()
     if (!file_lock_->try_lock())
         return false;
 
+    // Roll back an interrupted block write before the tables are mapped.
+    if (!journal_.start() || !journal_.recover())
+        return false;
+
     const auto start_exclusive = begin_write();
     const auto start_result =
         blocks.start() &&
@@ -581,6 +721,8 @@ bool data_base::start()
         spends.start() &&
         stealth.start() &&
         transactions.start() &&
+        utxos.start() &&
+        balances.start() &&
         /* begin database for account, asset, address_asset relationship */
         accounts.start() &&
         assets.start() &&
@@ -610,6 +752,8 @@ bool data_base::stop()
     const auto spends_stop = spends.stop();
     const auto stealth_stop = stealth.stop();
     const auto transactions_stop = transactions.stop();
+    const auto utxos_stop = utxos.stop();
+    const auto balances_stop = balances.stop();
     /* begin database for account, asset, address_asset relationship */
     const auto accounts_stop = accounts.stop();
     const auto assets_stop = assets.stop();
@@ -623,6 +767,7 @@ bool data_base::stop()
     const auto mits_stop = mits.stop();
     const auto address_mits_stop = address_mits.stop();
     const auto mit_history_stop = mit_history.stop();
+    const auto journal_stop = journal_.stop();
     const auto end_exclusive = end_write();
 
     // This should remove the lock file. This is not important for locking
@@ -638,6 +783,8 @@ bool data_base::stop()
         spends_stop &&
         stealth_stop &&
         transactions_stop &&
+        utxos_stop &&
+        balances_stop &&
         /* begin database for account, asset, address_asset relationship */
         accounts_stop &&
         assets_stop &&
@@ -651,6 +798,7 @@ bool data_base::stop()
         mits_stop &&
         address_mits_stop &&
         mit_history_stop &&
+        journal_stop &&
         end_exclusive;
 }
 
@@ -662,6 +810,8 @@ bool data_base::close()
     const auto spends_close = spends.close();
     const auto stealth_close = stealth.close();
     const auto transactions_close = transactions.close();
+    const auto utxos_close = utxos.close();
+    const auto balances_close = balances.close();
     /* begin database for account, asset, address_asset relationship */
     const auto accounts_close = accounts.close();
     const auto assets_close = assets.close();
@@ -675,6 +825,7 @@ bool data_base::close()
     const auto mits_close = mits.close();
     const auto address_mits_close = address_mits.close();
     const auto mit_history_close = mit_history.close();
+    const auto journal_close = journal_.close();
 
     // Return the cumulative result of the database closes.
     return
@@ -683,6 +834,8 @@ bool data_base::close()
         spends_close &&
         stealth_close &&
         transactions_close&&
+        utxos_close &&
+        balances_close &&
         /* begin database for account, asset, address_asset relationship */
         accounts_close &&
         assets_close &&
@@ -695,7 +848,8 @@ bool data_base::close()
         /* end database for account, asset, address_asset relationship */
         mits_close &&
         address_mits_close &&
-        mit_history_close
+        mit_history_close &&
+        journal_close
         ;
 }
 
@@ -717,20 +871,43 @@ bool data_base::is_write_locked(handle value)
     return (value % 2) == 1;
 }
 
-// TODO: drop a file as a write sentinel that we can use to detect uncontrolled
-// shutdown during write. Use a similar approach around initial block download.
-// Fail startup if the sentinel is detected. (file: write_lock).
+// Uncontrolled shutdown during a block write is detected and rolled back on
+// start by the write journal (see push and pop).
 bool data_base::begin_write()
 {
     // slock is now odd.
     return is_write_locked(++sequential_lock_);
 }
 
-// TODO: clear the write sentinel.
 bool data_base::end_write()
 {
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(write_mutex_);
+
     // slock_ is now even again.
-    return !is_write_locked(++sequential_lock_);
+    const auto unlocked = !is_write_locked(++sequential_lock_);
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    write_completed_.notify_all();
+    return unlocked;
+}
+
+// The counter is advanced under the mutex, so a wakeup cannot be missed.
+void data_base::wait_write(handle value)
+{
+    if (!is_write_locked(value))
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(write_mutex_);
+    write_completed_.wait(lock, [this, value]()
+    {
+        return sequential_lock_.load() != value;
+    });
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // Query engines.
@@ -756,6 +933,8 @@ void data_base::synchronize()
     history.sync();
     stealth.sync();
     transactions.sync();
+    utxos.sync();
+    balances.sync();
     /* begin database for account, asset, address_asset relationship */
     accounts.sync();
     assets.sync();
@@ -798,6 +977,11 @@ void data_base::push(const block& block)
 
 void data_base::push(const block& block, uint64_t height)
 {
+    journal_.begin(write_journal::operation::push, height);
+
+    // Grow the large tables once for the block instead of row by row.
+    presize(block, height);
+
     for (size_t index = 0; index < block.transactions.size(); ++index)
     {
         // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
@@ -826,6 +1010,12 @@ void data_base::push(const block& block, uint64_t height)
         // Add stealth outputs
         push_stealth(tx_hash, height, tx.outputs);
 
+        // Spend inputs from and add outputs to the unspent output set.
+        push_utxos(tx, tx_hash, height);
+
+        // Update the balances of the addresses of the spends and outputs.
+        push_balances(tx, tx_hash, height);
+
         // Add transaction
         transactions.store(height, index, tx);
     }
@@ -833,8 +1023,36 @@ void data_base::push(const block& block, uint64_t height)
     // Add block itself.
     blocks.store(block, height);
 
-    // Synchronise everything that was added.
+    // Synchronise everything that was added, once per block.
     synchronize();
+    journal_.commit();
+}
+
+void data_base::presize(const block& block, size_t height)
+{
+    size_t inputs = 0;
+    size_t outputs = 0;
+    size_t tx_size = 0;
+    size_t outputs_size = 0;
+
+    for (const auto& tx: block.transactions)
+    {
+        tx_size += tx.serialized_size();
+        outputs += tx.outputs.size();
+
+        for (const auto& output: tx.outputs)
+            outputs_size += output.serialized_size();
+
+        if (!tx.is_coinbase())
+            inputs += tx.inputs.size();
+    }
+
+    transactions.reserve(block.transactions.size(), tx_size);
+    utxos.reserve(outputs, outputs_size);
+    spends.reserve(inputs);
+
+    if (height >= history_height_)
+        history.reserve(inputs + outputs);
 }
 
 void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
@@ -863,7 +1081,6 @@ void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
         data_chunk data(address_str.begin(), address_str.end());
         short_hash key = ripemd160_hash(data);
         address_assets.store_input(key, point, height, previous, timestamp_);
-        address_assets.sync();
         /* end added for asset issue/transfer */
     }
 }
@@ -891,6 +1108,98 @@ void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
     }
 }
 
+void data_base::push_utxos(const transaction& tx, const hash_digest& tx_hash,
+    size_t height)
+{
+    // Outputs confirmed before the utxo table existed are not present.
+    if (!tx.is_coinbase())
+        for (const auto& input: tx.inputs)
+            utxos.remove(input.previous_output);
+
+    BITCOIN_ASSERT(height <= max_uint32);
+    const auto height32 = static_cast<uint32_t>(height);
+    const auto coinbase = tx.is_coinbase();
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+    {
+        const chain::output_point point{ tx_hash, index };
+        utxos.store(point, height32, coinbase, tx.outputs[index]);
+    }
+}
+
+void data_base::push_balances(const transaction& tx,
+    const hash_digest& tx_hash, size_t height)
+{
+    // Outputs confirmed before the balance table existed are not present.
+    if (!tx.is_coinbase())
+        for (const auto& input: tx.inputs)
+            balances.spend(input.previous_output);
+
+    BITCOIN_ASSERT(height <= max_uint32);
+    const auto height32 = static_cast<uint32_t>(height);
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+    {
+        const auto& output = tx.outputs[index];
+        const auto address = payment_address::extract(output.script);
+        if (!address)
+            continue;
+
+        // Deposits and coinbase outputs are frozen until their lock height.
+        const auto& operations = output.script.operations;
+        uint64_t unlock_height = 0;
+        if (operation::is_pay_key_hash_with_lock_height_pattern(operations))
+            unlock_height = height + operation::
+                get_lock_height_from_pay_key_hash_with_lock_height(operations);
+        else if (tx.is_coinbase())
+            unlock_height = height + coinbase_maturity;
+
+        const chain::output_point point{ tx_hash, index };
+        balances.store(address.hash(), point, height32, output.value,
+            unlock_height);
+    }
+}
+
+// Index the balances of the blocks confirmed before the balance table.
+bool data_base::index_balances()
+{
+    if (!blocks.start() || !transactions.start())
+        return false;
+
+    size_t top;
+    if (blocks.top(top))
+    {
+        log::info(LOG_DATABASE)
+            << "Indexing address balances of " << top + 1
+            << " blocks, this may take a while.";
+
+        for (size_t height = 0; height <= top; ++height)
+        {
+            const auto result = blocks.get(height);
+            if (!result)
+                return false;
+
+            for (size_t index = 0; index < result.transaction_count(); ++index)
+            {
+                // Skip BIP30 allowed duplicates, as push does.
+                if (index == 0 && is_allowed_duplicate(result.header(), height))
+                    continue;
+
+                const auto tx_hash = result.transaction_hash(index);
+                const auto tx_result = transactions.get(tx_hash);
+                if (!tx_result)
+                    return false;
+
+                push_balances(tx_result.transaction(), tx_hash, height);
+            }
+        }
+    }
+
+    balances.set_complete();
+    balances.sync();
+    return true;
+}
+
 void data_base::push_stealth(const hash_digest& tx_hash, size_t height,
     const output::list& outputs)
 {
@@ -936,6 +1245,8 @@ chain::block data_base::pop()
     DEBUG_ONLY(const auto result =) blocks.top(height);
     BITCOIN_ASSERT_MSG(result, "Pop on empty database.");
 
+    journal_.begin(write_journal::operation::pop, height);
+
     const auto block_result = blocks.get(height);
     const auto count = block_result.transaction_count();
 
@@ -969,6 +1280,8 @@ chain::block data_base::pop()
     for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
     {
         transactions.remove(tx->hash());
+        pop_utxos(*tx);
+        pop_balances(*tx);
         pop_outputs(tx->outputs, height);
 
         if (!tx->is_coinbase())
@@ -982,11 +1295,56 @@ chain::block data_base::pop()
 
     // Synchronise everything that was changed.
     synchronize();
+    journal_.commit();
 
     // Return the block.
     return block;
 }
 
+void data_base::pop_utxos(const transaction& tx)
+{
+    const auto tx_hash = tx.hash();
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        utxos.remove({ tx_hash, index });
+
+    if (tx.is_coinbase())
+        return;
+
+    // Restore the previous outputs spent by the popped transaction.
+    for (const auto& input: tx.inputs)
+    {
+        const auto& previous = input.previous_output;
+        const auto previous_result = transactions.get(previous.hash);
+
+        if (!previous_result)
+            continue;
+
+        const auto previous_tx = previous_result.transaction();
+        if (previous.index >= previous_tx.outputs.size())
+            continue;
+
+        const auto height32 = static_cast<uint32_t>(previous_result.height());
+        utxos.store(previous, height32, previous_tx.is_coinbase(),
+            previous_tx.outputs[previous.index]);
+    }
+}
+
+void data_base::pop_balances(const transaction& tx)
+{
+    const auto tx_hash = tx.hash();
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        balances.remove({ tx_hash, index });
+
+    if (tx.is_coinbase())
+        return;
+
+    // Restore the previous outputs spent by the popped transaction.
+    for (const auto& input: tx.inputs)
+        balances.unspend(input.previous_output);
+}
+
 void data_base::pop_inputs(const input::list& inputs, size_t height)
 {
     // Loop in reverse.
@@ -1128,8 +1486,6 @@ void data_base::push_etp(const etp& etp, const short_hash& key,
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::etp),
         timestamp_, etp);
-    address_assets.sync();
-
 }
 
 void data_base::push_etp_award(const etp_award& award, const short_hash& key,
@@ -1138,7 +1494,6 @@ void data_base::push_etp_award(const etp_award& award, const short_hash& key,
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::etp_award),
         timestamp_, award);
-    address_assets.sync();
 }
 
 void data_base::push_message(const chain::blockchain_message& msg, const short_hash& key,
@@ -1147,7 +1502,6 @@ void data_base::push_message(const chain::blockchain_message& msg, const short_h
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::message),
         timestamp_, msg);
-    address_assets.sync();
 }
 
 void data_base::push_asset(const asset& sp, const short_hash& key,
@@ -1162,12 +1516,10 @@ void data_base::push_asset_cert(const asset_cert& sp_cert, const short_hash& key
 {
     if (sp_cert.is_newly_generated()) {
         certs.store(sp_cert);
-        certs.sync();
     }
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_cert),
         timestamp_, sp_cert);
-    address_assets.sync();
 }
 
 void data_base::push_asset_detail(const asset_detail& sp_detail, const short_hash& key,
@@ -1177,11 +1529,9 @@ void data_base::push_asset_detail(const asset_detail& sp_detail, const short_has
     const auto hash = sha256_hash(data);
     auto bc_asset = blockchain_asset(0, outpoint,output_height, sp_detail);
     assets.store(hash, bc_asset);
-    assets.sync();
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_issue),
         timestamp_, sp_detail);
-    address_assets.sync();
 }
 
 void data_base::push_asset_transfer(const asset_transfer& sp_transfer, const short_hash& key,
@@ -1190,7 +1540,6 @@ void data_base::push_asset_transfer(const asset_transfer& sp_transfer, const sho
     address_assets.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_transfer),
         timestamp_, sp_transfer);
-    address_assets.sync();
 }
 /* end store asset related info into database */
 
@@ -1208,11 +1557,9 @@ void data_base::push_did_detail(const did_detail& sp_detail, const short_hash& k
     const auto hash = sha256_hash(data);
     auto bc_did = blockchain_did(0, outpoint,output_height, blockchain_did::address_current,sp_detail);
     dids.store(hash, bc_did);
-    dids.sync();
     address_dids.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::did_register),
         timestamp_, sp_detail);
-    address_dids.sync();
 }
 
 /* end store did related info into database */
@@ -1226,16 +1573,13 @@ void data_base::push_mit(const asset_mit& mit, const short_hash& key,
 
     if (mit.is_register_status()) {
         mits.store(mit_info);
-        mits.sync();
     }
 
     address_mits.store_output(key, outpoint, output_height, value,
         static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_mit),
         timestamp_, mit);
-    address_mits.sync();
 
     mit_history.store(mit_info);
-    mit_history.sync();
 }
 /* end store mit related info into database */
 
@@ -80,15 +80,13 @@ bool account_address_database::create()
     lookup_file_.resize(initial_lookup_file_size);
     rows_file_.resize(minimum_records_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create() ||
+    if (!lookup_map_.create() ||
         !rows_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -100,8 +98,7 @@ bool account_address_database::start()
     return
         lookup_file_.start() &&
         rows_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -217,6 +214,7 @@ std::shared_ptr<account_address> account_address_database::get(const short_hash&
 }
 void account_address_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
     rows_manager_.sync();
 }
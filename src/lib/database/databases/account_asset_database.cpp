@@ -79,15 +79,13 @@ bool account_asset_database::create()
     lookup_file_.resize(initial_lookup_file_size);
     rows_file_.resize(minimum_records_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create() ||
+    if (!lookup_map_.create() ||
         !rows_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -99,8 +97,7 @@ bool account_asset_database::start()
     return
         lookup_file_.start() &&
         rows_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -228,6 +225,7 @@ std::shared_ptr<business_address_asset::list> account_asset_database::get_unissu
 
 void account_asset_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
     rows_manager_.sync();
 }
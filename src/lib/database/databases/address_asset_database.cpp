@@ -37,7 +37,7 @@ namespace database {
 using namespace boost::filesystem;
 using namespace bc::chain;
 
-constexpr size_t number_buckets = 97210744;
+constexpr size_t number_buckets = 100003;
 constexpr size_t header_size = record_hash_table_header_size(number_buckets);
 constexpr size_t initial_lookup_file_size = header_size + minimum_records_size;
 
@@ -81,15 +81,13 @@ bool address_asset_database::create()
     lookup_file_.resize(initial_lookup_file_size);
     rows_file_.resize(minimum_records_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create() ||
+    if (!lookup_map_.create() ||
         !rows_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -101,8 +99,7 @@ bool address_asset_database::start()
     return
         lookup_file_.start() &&
         rows_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -373,6 +370,56 @@ std::shared_ptr<business_record::list> address_asset_database::get(const std::st
     return result;
 }
 
+void address_asset_database::scan(const short_hash& key, size_t max_height,
+    std::function<bool(const business_record&)> visitor) const
+{
+    // Read the height value from the row.
+    const auto read_height = [](uint8_t* data)
+    {
+        static constexpr file_offset height_position = 1 + 36;
+        const auto height_address = data + height_position;
+        return from_little_endian_unsafe<uint32_t>(height_address);
+    };
+
+    // Read a row from the data for the history list.
+    const auto read_row = [](uint8_t* data)
+    {
+        auto deserial = make_deserializer_unsafe(data);
+        return business_record
+        {
+            // output or spend?
+            static_cast<point_kind>(deserial.read_byte()),
+
+            // point
+            point::factory_from_data(deserial),
+
+            // height
+            deserial.read_4_bytes_little_endian(),
+
+            // value or checksum
+            { deserial.read_8_bytes_little_endian() },
+
+            business_data::factory_from_data(deserial) // 2 + 4 are in this class
+        };
+    };
+
+    const auto start = rows_multimap_.lookup(key);
+    const auto records = record_multimap_iterable(rows_list_, start);
+
+    for (const auto index: records)
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(index);
+        const auto address = REMAP_ADDRESS(record);
+
+        if (read_height(address) > max_height)
+            continue;
+
+        if (!visitor(read_row(address)))
+            break;
+    }
+}
+
 /// get all record of key from database
 std::shared_ptr<business_record::list> address_asset_database::get(size_t idx) const
 {
@@ -780,6 +827,7 @@ business_address_asset_cert::list address_asset_database::get_asset_certs(const
 
 void address_asset_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
     rows_manager_.sync();
 }
@@ -0,0 +1,489 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/address_balance_database.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+using namespace bc::chain;
+
+constexpr size_t number_buckets = 100003;
+constexpr size_t header_size = record_hash_table_header_size(number_buckets);
+constexpr size_t initial_lookup_file_size = header_size + minimum_records_size;
+
+constexpr size_t outputs_buckets = 1000003;
+constexpr size_t outputs_header_size =
+    record_hash_table_header_size(outputs_buckets);
+constexpr size_t initial_outputs_file_size =
+    outputs_header_size + minimum_records_size;
+
+constexpr array_index empty_row = max_uint32;
+
+//  [ received:8 ][ unspent:8 ][ first:4 ][ first_locked:4 ]
+constexpr size_t balance_size = 8 + 8 + 4 + 4;
+constexpr file_offset first_offset = 16;
+constexpr file_offset first_locked_offset = 20;
+constexpr size_t record_size = hash_table_record_size<short_hash>(balance_size);
+
+constexpr size_t output_record_size =
+    hash_table_record_size<chain::point>(sizeof(array_index));
+
+//  [ key:20 ][ point:36 ][ height:4 ][ value:8 ][ unlock:8 ][ spent:1 ]
+//  [ previous:4 ][ next:4 ]
+constexpr file_offset spent_offset = 20 + 36 + 4 + 8 + 8;
+constexpr file_offset previous_offset = spent_offset + 1;
+constexpr file_offset next_offset = previous_offset + 4;
+constexpr size_t row_size = next_offset + 4;
+
+address_balance_database::address_balance_database(
+    const path& lookup_filename, const path& outputs_filename,
+    const path& rows_filename, std::shared_ptr<shared_mutex> mutex)
+  : lookup_file_(lookup_filename, mutex),
+    lookup_header_(lookup_file_, number_buckets),
+    lookup_manager_(lookup_file_, header_size, record_size),
+    lookup_map_(lookup_header_, lookup_manager_),
+    outputs_file_(outputs_filename, mutex),
+    outputs_header_(outputs_file_, outputs_buckets),
+    outputs_manager_(outputs_file_, outputs_header_size, output_record_size),
+    outputs_map_(outputs_header_, outputs_manager_),
+    rows_file_(rows_filename, mutex),
+    rows_manager_(rows_file_, 0, row_size)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+address_balance_database::~address_balance_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool address_balance_database::create(bool complete)
+{
+    // Resize and create require a started file.
+    if (!lookup_file_.start() ||
+        !outputs_file_.start() ||
+        !rows_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    lookup_file_.resize(initial_lookup_file_size);
+    outputs_file_.resize(initial_outputs_file_size);
+    rows_file_.resize(minimum_records_size);
+
+    if (!lookup_map_.create() ||
+        !outputs_map_.create() ||
+        !rows_manager_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    if (!lookup_map_.start() ||
+        !outputs_map_.start() ||
+        !rows_manager_.start())
+        return false;
+
+    // The first row records whether blocks preceded the index.
+    const auto row = rows_manager_.new_records(1);
+    const auto memory = rows_manager_.get(row);
+    const auto address = REMAP_ADDRESS(memory);
+    memset(address, 0, row_size);
+    *address = complete ? 1 : 0;
+    rows_manager_.sync();
+    return true;
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool address_balance_database::start()
+{
+    return
+        lookup_file_.start() &&
+        outputs_file_.start() &&
+        rows_file_.start() &&
+        lookup_map_.start() &&
+        outputs_map_.start() &&
+        rows_manager_.start();
+}
+
+bool address_balance_database::stop()
+{
+    return
+        lookup_file_.stop() &&
+        outputs_file_.stop() &&
+        rows_file_.stop();
+}
+
+bool address_balance_database::close()
+{
+    return
+        lookup_file_.close() &&
+        outputs_file_.close() &&
+        rows_file_.close();
+}
+
+// ----------------------------------------------------------------------------
+
+bool address_balance_database::complete() const
+{
+    if (rows_manager_.count() == 0)
+        return false;
+
+    const auto memory = rows_manager_.get(0);
+    return *REMAP_ADDRESS(memory) == 1;
+}
+
+void address_balance_database::set_complete()
+{
+    BITCOIN_ASSERT(rows_manager_.count() != 0);
+    const auto memory = rows_manager_.get(0);
+    const auto address = REMAP_ADDRESS(memory);
+    rows_manager_.preserve(address, 1);
+    *address = 1;
+}
+
+address_balance address_balance_database::get(const short_hash& key) const
+{
+    address_balance balance{ 0, 0, {} };
+    auto first_locked = empty_row;
+
+    // The accessor is released before rows are read.
+    {
+        const auto memory = lookup_map_.find(key);
+
+        if (!memory)
+            return balance;
+
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+        balance.received = deserial.read_8_bytes_little_endian();
+        balance.unspent = deserial.read_8_bytes_little_endian();
+        deserial.read_4_bytes_little_endian();
+        first_locked = deserial.read_4_bytes_little_endian();
+    }
+
+    append(balance.locked, first_locked);
+    return balance;
+}
+
+bool address_balance_database::get(const output_point& point,
+    address_output& out) const
+{
+    const auto row = find_row(point);
+
+    if (row == empty_row || is_spent(row))
+        return false;
+
+    out = read_row(row);
+    return true;
+}
+
+address_output::list address_balance_database::get_unspent(
+    const short_hash& key) const
+{
+    address_output::list outputs;
+    auto first = empty_row;
+    auto first_locked = empty_row;
+
+    // The accessor is released before rows are read.
+    {
+        const auto memory = lookup_map_.find(key);
+
+        if (!memory)
+            return outputs;
+
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory) +
+            first_offset);
+        first = deserial.read_4_bytes_little_endian();
+        first_locked = deserial.read_4_bytes_little_endian();
+    }
+
+    append(outputs, first);
+    append(outputs, first_locked);
+    return outputs;
+}
+
+void address_balance_database::store(const short_hash& key,
+    const output_point& point, uint32_t height, uint64_t value,
+    uint64_t unlock_height)
+{
+    const auto row = rows_manager_.new_records(1);
+
+    // The row is new, it is linked below.
+    {
+        const auto memory = rows_manager_.get(row);
+        auto serial = make_serializer(REMAP_ADDRESS(memory));
+        serial.write_short_hash(key);
+        serial.write_data(point.to_data());
+        serial.write_4_bytes_little_endian(height);
+        serial.write_8_bytes_little_endian(value);
+        serial.write_8_bytes_little_endian(unlock_height);
+        serial.write_byte(0);
+        serial.write_4_bytes_little_endian(empty_row);
+        serial.write_4_bytes_little_endian(empty_row);
+    }
+
+    const auto write = [row](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_4_bytes_little_endian(row);
+    };
+
+    outputs_map_.store(point, write);
+    add_unspent(key, value, value);
+    link(key, row, unlock_height != 0);
+}
+
+void address_balance_database::spend(const output_point& point)
+{
+    // Outputs confirmed before the index existed are not present.
+    const auto row = find_row(point);
+
+    if (row == empty_row || is_spent(row))
+        return;
+
+    const auto out = read_row(row);
+    unlink(row);
+    write_spent(row, true);
+    add_unspent(out.key, 0, -static_cast<int64_t>(out.value));
+}
+
+void address_balance_database::unspend(const output_point& point)
+{
+    const auto row = find_row(point);
+
+    if (row == empty_row || !is_spent(row))
+        return;
+
+    const auto out = read_row(row);
+    write_spent(row, false);
+    add_unspent(out.key, 0, out.value);
+    link(out.key, row, out.unlock_height != 0);
+}
+
+// The row is left in place, it is no longer referenced.
+void address_balance_database::remove(const output_point& point)
+{
+    const auto row = find_row(point);
+
+    if (row == empty_row)
+        return;
+
+    const auto out = read_row(row);
+    const auto value = static_cast<int64_t>(out.value);
+
+    if (is_spent(row))
+    {
+        add_unspent(out.key, -value, 0);
+    }
+    else
+    {
+        unlink(row);
+        add_unspent(out.key, -value, -value);
+    }
+
+    DEBUG_ONLY(const auto result =) outputs_map_.unlink(point);
+    BITCOIN_ASSERT(result);
+}
+
+void address_balance_database::sync()
+{
+    lookup_header_.sync();
+    outputs_header_.sync();
+    lookup_manager_.sync();
+    outputs_manager_.sync();
+    rows_manager_.sync();
+}
+
+// private
+// ----------------------------------------------------------------------------
+
+array_index address_balance_database::find_row(
+    const output_point& point) const
+{
+    const auto memory = outputs_map_.find(point);
+
+    if (!memory)
+        return empty_row;
+
+    return from_little_endian_unsafe<array_index>(REMAP_ADDRESS(memory));
+}
+
+address_output address_balance_database::read_row(array_index row) const
+{
+    address_output out;
+    const auto memory = rows_manager_.get(row);
+    auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+    out.key = deserial.read_short_hash();
+    out.point.from_data(deserial);
+    out.height = deserial.read_4_bytes_little_endian();
+    out.value = deserial.read_8_bytes_little_endian();
+    out.unlock_height = deserial.read_8_bytes_little_endian();
+    return out;
+}
+
+bool address_balance_database::is_spent(array_index row) const
+{
+    const auto memory = rows_manager_.get(row);
+    return *(REMAP_ADDRESS(memory) + spent_offset) != 0;
+}
+
+array_index address_balance_database::read_link(array_index row,
+    file_offset offset) const
+{
+    const auto memory = rows_manager_.get(row);
+    return from_little_endian_unsafe<array_index>(REMAP_ADDRESS(memory) +
+        offset);
+}
+
+// A list read concurrently with a write may be torn, the walk is bounded.
+void address_balance_database::append(address_output::list& outputs,
+    array_index first) const
+{
+    const auto rows = rows_manager_.count();
+
+    for (auto row = first; row != empty_row && row < rows;
+        row = read_link(row, next_offset))
+    {
+        outputs.push_back(read_row(row));
+
+        if (outputs.size() >= rows)
+            break;
+    }
+}
+
+void address_balance_database::link(const short_hash& key, array_index row,
+    bool locked)
+{
+    const auto offset = locked ? first_locked_offset : first_offset;
+    array_index first;
+
+    {
+        const auto memory = lookup_map_.find(key);
+        BITCOIN_ASSERT(memory);
+        const auto address = REMAP_ADDRESS(memory) + offset;
+        first = from_little_endian_unsafe<array_index>(address);
+        lookup_map_.preserve(address, sizeof(array_index));
+        auto serial = make_serializer(address);
+        serial.write_4_bytes_little_endian(row);
+    }
+
+    write_link(row, previous_offset, empty_row);
+    write_link(row, next_offset, first);
+
+    if (first != empty_row)
+        write_link(first, previous_offset, row);
+}
+
+void address_balance_database::unlink(array_index row)
+{
+    const auto out = read_row(row);
+    const auto previous = read_link(row, previous_offset);
+    const auto next = read_link(row, next_offset);
+
+    if (previous == empty_row)
+    {
+        const auto offset = out.unlock_height != 0 ? first_locked_offset :
+            first_offset;
+        const auto memory = lookup_map_.find(out.key);
+        BITCOIN_ASSERT(memory);
+        const auto address = REMAP_ADDRESS(memory) + offset;
+        lookup_map_.preserve(address, sizeof(array_index));
+        auto serial = make_serializer(address);
+        serial.write_4_bytes_little_endian(next);
+    }
+    else
+    {
+        write_link(previous, next_offset, next);
+    }
+
+    if (next != empty_row)
+        write_link(next, previous_offset, previous);
+}
+
+void address_balance_database::write_link(array_index row, file_offset offset,
+    array_index value)
+{
+    const auto memory = rows_manager_.get(row);
+    const auto address = REMAP_ADDRESS(memory) + offset;
+    rows_manager_.preserve(address, sizeof(array_index));
+    auto serial = make_serializer(address);
+    serial.write_4_bytes_little_endian(value);
+}
+
+void address_balance_database::write_spent(array_index row, bool spent)
+{
+    const auto memory = rows_manager_.get(row);
+    const auto address = REMAP_ADDRESS(memory) + spent_offset;
+    rows_manager_.preserve(address, 1);
+    *address = spent ? 1 : 0;
+}
+
+// Deltas are applied modulo 2^64, a negative delta is a subtraction.
+void address_balance_database::add_unspent(const short_hash& key,
+    int64_t received, int64_t unspent)
+{
+    {
+        const auto memory = lookup_map_.find(key);
+
+        if (memory)
+        {
+            const auto address = REMAP_ADDRESS(memory);
+            auto deserial = make_deserializer_unsafe(address);
+            const auto old_received = deserial.read_8_bytes_little_endian();
+            const auto old_unspent = deserial.read_8_bytes_little_endian();
+
+            lookup_map_.preserve(address, 2 * sizeof(uint64_t));
+            auto serial = make_serializer(address);
+            serial.write_8_bytes_little_endian(old_received +
+                static_cast<uint64_t>(received));
+            serial.write_8_bytes_little_endian(old_unspent +
+                static_cast<uint64_t>(unspent));
+            return;
+        }
+    }
+
+    BITCOIN_ASSERT(received >= 0 && unspent >= 0);
+
+    const auto write = [received, unspent](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_8_bytes_little_endian(static_cast<uint64_t>(received));
+        serial.write_8_bytes_little_endian(static_cast<uint64_t>(unspent));
+        serial.write_4_bytes_little_endian(empty_row);
+        serial.write_4_bytes_little_endian(empty_row);
+    };
+
+    lookup_map_.store(key, write);
+}
+
+} // namespace database
+} // namespace libbitcoin
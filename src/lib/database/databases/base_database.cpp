@@ -65,14 +65,12 @@ bool base_database::create()
     // This will throw if insufficient disk space.
     lookup_file_.resize(initial_map_file_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create())
+    if (!lookup_map_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Startup and shutdown.
@@ -83,8 +81,7 @@ bool base_database::start()
 {
     return
         lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Stop files.
@@ -114,6 +111,7 @@ void base_database::remove(const hash_digest& hash)
 
 void base_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
 }
 
@@ -34,7 +34,7 @@ namespace database {
 using namespace boost::filesystem;
 using namespace bc::chain;
 
-constexpr size_t number_buckets = 600000;
+constexpr size_t number_buckets = 100003;
 constexpr size_t header_size = slab_hash_table_header_size(number_buckets);
 constexpr size_t initial_map_file_size = header_size + minimum_slabs_size;
 
@@ -83,15 +83,13 @@ bool block_database::create()
     lookup_file_.resize(initial_map_file_size);
     index_file_.resize(minimum_records_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create() ||
+    if (!lookup_map_.create() ||
         !index_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         index_manager_.start();
 }
 
@@ -104,8 +102,7 @@ bool block_database::start()
     return
         lookup_file_.start() &&
         index_file_.start() &&
-        lookup_header_.start() && 
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         index_manager_.start();
 }
 
@@ -193,6 +190,7 @@ void block_database::remove(const hash_digest& hash)
 
 void block_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
     index_manager_.sync();
 }
@@ -233,6 +231,7 @@ void block_database::write_position(file_offset position, array_index height)
 
     // Guard write to prevent subsequent zeroize from erasing.
     const auto memory = index_manager_.get(height);
+    index_manager_.preserve(REMAP_ADDRESS(memory), sizeof(file_offset));
     auto serial = make_serializer(REMAP_ADDRESS(memory));
     serial.write_8_bytes_little_endian(position);
 
@@ -65,14 +65,12 @@ bool blockchain_asset_database::create()
     // This will throw if insufficient disk space.
     lookup_file_.resize(initial_map_file_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create())
+    if (!lookup_map_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Startup and shutdown.
@@ -83,8 +81,7 @@ bool blockchain_asset_database::start()
 {
     return
         lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Stop files.
@@ -109,6 +106,7 @@ void blockchain_asset_database::remove(const hash_digest& hash)
 
 void blockchain_asset_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
 }
 
@@ -149,7 +147,7 @@ std::shared_ptr<std::vector<blockchain_asset>> blockchain_asset_database::get_bl
 {
     auto vec_acc = std::make_shared<std::vector<blockchain_asset>>();
     uint64_t i = 0;
-    for( i = 0; i < number_buckets; i++ ) {
+    for( i = 0; i < lookup_header_.size(); i++ ) {
         auto memo = lookup_map_.find(i);
         //log::debug("get_accounts size=")<<memo->size();
         if (memo->size()) {
@@ -65,14 +65,12 @@ bool blockchain_did_database::create()
     // This will throw if insufficient disk space.
     lookup_file_.resize(initial_map_file_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create())
+    if (!lookup_map_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Startup and shutdown.
@@ -83,8 +81,7 @@ bool blockchain_did_database::start()
 {
     return
         lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Stop files.
@@ -109,6 +106,7 @@ void blockchain_did_database::remove(const hash_digest& hash)
 
 void blockchain_did_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
 }
 
@@ -152,7 +150,7 @@ std::shared_ptr<std::vector<blockchain_did>> blockchain_did_database::get_blockc
 {
 	auto vec_acc = std::make_shared<std::vector<blockchain_did>>();
 	uint64_t i = 0;
-	for( i = 0; i < number_buckets; i++ ) {
+	for( i = 0; i < lookup_header_.size(); i++ ) {
 	    auto memo = lookup_map_.find(i);
 		//log::debug("get_accounts size=")<<memo->size();
 		if(memo->size())
@@ -209,6 +207,7 @@ std::shared_ptr<blockchain_did> blockchain_did_database::update_address_status(c
             {
                 //update status and serializer
                 detail->set_status(status);
+                lookup_file_.preserve(memory, detail->serialized_size());
                 auto serial = make_serializer(memory);
                 serial.write_data(detail->to_data());
             }
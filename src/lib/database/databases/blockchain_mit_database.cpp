@@ -31,7 +31,7 @@ namespace database {
 
 using namespace boost::filesystem;
 
-constexpr size_t number_buckets = 999983;
+constexpr size_t number_buckets = 10007;
 constexpr size_t header_size = slab_hash_table_header_size(number_buckets);
 constexpr size_t initial_map_file_size = header_size + minimum_slabs_size;
 
@@ -63,14 +63,12 @@ bool blockchain_mit_database::create()
     // This will throw if insufficient disk space.
     lookup_file_.resize(initial_map_file_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create())
+    if (!lookup_map_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Startup and shutdown.
@@ -81,8 +79,7 @@ bool blockchain_mit_database::start()
 {
     return
         lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Stop files.
@@ -107,6 +104,7 @@ void blockchain_mit_database::remove(const hash_digest& hash)
 
 void blockchain_mit_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
 }
 
@@ -128,7 +126,7 @@ std::shared_ptr<asset_mit_info> blockchain_mit_database::get(const hash_digest&
 std::shared_ptr<asset_mit_info::list> blockchain_mit_database::get_blockchain_mits() const
 {
     auto vec_acc = std::make_shared<std::vector<asset_mit_info>>();
-    for( uint64_t i = 0; i < number_buckets; i++ ) {
+    for( uint64_t i = 0; i < lookup_header_.size(); i++ ) {
         auto memo = lookup_map_.find(i);
         if (memo->size()) {
             const auto action = [&vec_acc](memory_ptr elem)
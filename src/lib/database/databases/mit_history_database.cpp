@@ -57,7 +57,7 @@ namespace {
     };
 } // end of namespace anonymous
 
-constexpr size_t number_buckets = 99999989;
+constexpr size_t number_buckets = 100003;
 constexpr size_t header_size = record_hash_table_header_size(number_buckets);
 constexpr size_t initial_lookup_file_size = header_size + minimum_records_size;
 
@@ -100,15 +100,13 @@ bool mit_history_database::create()
     lookup_file_.resize(initial_lookup_file_size);
     rows_file_.resize(minimum_records_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create() ||
+    if (!lookup_map_.create() ||
         !rows_manager_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -120,8 +118,7 @@ bool mit_history_database::start()
     return
         lookup_file_.start() &&
         rows_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start() &&
+        lookup_map_.start() &&
         rows_manager_.start();
 }
 
@@ -141,6 +138,7 @@ bool mit_history_database::close()
 
 void mit_history_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
     rows_manager_.sync();
 }
@@ -34,7 +34,7 @@ namespace database {
 using namespace boost::filesystem;
 using namespace bc::chain;
 
-constexpr size_t number_buckets = 228110589;
+constexpr size_t number_buckets = 1000003;
 constexpr size_t header_size = record_hash_table_header_size(number_buckets);
 constexpr size_t initial_map_file_size = header_size + minimum_records_size;
 
@@ -69,14 +69,12 @@ bool spend_database::create()
     // This will throw if insufficient disk space.
     lookup_file_.resize(initial_map_file_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create())
+    if (!lookup_map_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Startup and shutdown.
@@ -86,8 +84,7 @@ bool spend_database::start()
 {
     return
         lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 bool spend_database::stop()
@@ -138,8 +135,14 @@ void spend_database::remove(const output_point& outpoint)
     BITCOIN_ASSERT(success);
 }
 
+void spend_database::reserve(size_t count)
+{
+    lookup_manager_.reserve(count);
+}
+
 void spend_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
 }
 
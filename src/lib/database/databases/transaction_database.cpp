@@ -33,7 +33,7 @@ namespace database {
 
 using namespace boost::filesystem;
 
-constexpr size_t number_buckets = 100000000;
+constexpr size_t number_buckets = 1000003;
 constexpr size_t header_size = slab_hash_table_header_size(number_buckets);
 constexpr size_t initial_map_file_size = header_size + minimum_slabs_size;
 
@@ -65,14 +65,12 @@ bool transaction_database::create()
     // This will throw if insufficient disk space.
     lookup_file_.resize(initial_map_file_size);
 
-    if (!lookup_header_.create() ||
-        !lookup_manager_.create())
+    if (!lookup_map_.create())
         return false;
 
     // Should not call start after create, already started.
     return
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Startup and shutdown.
@@ -83,8 +81,7 @@ bool transaction_database::start()
 {
     return
         lookup_file_.start() &&
-        lookup_header_.start() &&
-        lookup_manager_.start();
+        lookup_map_.start();
 }
 
 // Stop files.
@@ -128,7 +125,7 @@ void transaction_database::store(size_t height, size_t index,
         auto serial = make_serializer(REMAP_ADDRESS(data));
         serial.write_4_bytes_little_endian(hight32);
         serial.write_4_bytes_little_endian(index32);
-        serial.write_data(tx.to_data());
+        tx.to_data(serial);
     };
     lookup_map_.store(key, write, value_size);
 }
@@ -139,8 +136,16 @@ void transaction_database::remove(const hash_digest& hash)
     BITCOIN_ASSERT(success);
 }
 
+void transaction_database::reserve(size_t count, size_t size)
+{
+    // Each slab is prefixed by its key and next position.
+    static constexpr size_t overhead = hash_size + sizeof(file_offset) + 4 + 4;
+    lookup_manager_.reserve(count * overhead + size);
+}
+
 void transaction_database::sync()
 {
+    lookup_header_.sync();
     lookup_manager_.sync();
 }
 
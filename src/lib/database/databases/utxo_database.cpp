@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/utxo_database.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+using namespace bc::chain;
+
+constexpr size_t number_buckets = 1000003;
+constexpr size_t header_size = slab_hash_table_header_size(number_buckets);
+constexpr size_t initial_map_file_size = header_size + minimum_slabs_size;
+
+static constexpr size_t height_size = sizeof(uint32_t);
+static constexpr size_t coinbase_size = sizeof(uint8_t);
+
+const size_t utxo_database::default_cache_capacity = 100000;
+
+utxo_database::utxo_database(const path& filename,
+    std::shared_ptr<shared_mutex> mutex, size_t cache_capacity)
+  : lookup_file_(filename, mutex),
+    lookup_header_(lookup_file_, number_buckets),
+    lookup_manager_(lookup_file_, header_size),
+    lookup_map_(lookup_header_, lookup_manager_),
+    cache_capacity_(cache_capacity),
+    cache_generation_(0)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+utxo_database::~utxo_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool utxo_database::create()
+{
+    // Resize and create require a started file.
+    if (!lookup_file_.start())
+        return false;
+
+    // This will throw if insufficient disk space.
+    lookup_file_.resize(initial_map_file_size);
+
+    if (!lookup_map_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return
+        lookup_map_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool utxo_database::start()
+{
+    return
+        lookup_file_.start() &&
+        lookup_map_.start();
+}
+
+bool utxo_database::stop()
+{
+    return lookup_file_.stop();
+}
+
+bool utxo_database::close()
+{
+    return lookup_file_.close();
+}
+
+// ----------------------------------------------------------------------------
+
+unspent_output utxo_database::get(const output_point& outpoint) const
+{
+    uint64_t generation;
+
+    {
+        scoped_lock lock(cache_mutex_);
+        const auto it = cache_index_.find(outpoint);
+
+        if (it != cache_index_.end())
+        {
+            cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
+            return it->second->second;
+        }
+
+        generation = cache_generation_;
+    }
+
+    unspent_output result{ false, 0, false, {} };
+
+    {
+        const auto memory = lookup_map_.find(outpoint);
+
+        if (!memory)
+            return result;
+
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+        result.height = deserial.read_4_bytes_little_endian();
+        result.coinbase = deserial.read_byte() != 0;
+        result.valid = result.output.from_data(deserial);
+    }
+
+    // Do not cache a value that a concurrent write may have superseded.
+    scoped_lock lock(cache_mutex_);
+
+    if (result.valid && generation == cache_generation_)
+        cache(result, outpoint);
+
+    return result;
+}
+
+void utxo_database::store(const output_point& outpoint, uint32_t height,
+    bool coinbase, const output& output)
+{
+    const auto output_size = output.serialized_size();
+    BITCOIN_ASSERT(output_size <= max_size_t - height_size - coinbase_size);
+    const auto value_size = height_size + coinbase_size +
+        static_cast<size_t>(output_size);
+
+    const auto write = [height, coinbase, &output](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_4_bytes_little_endian(height);
+        serial.write_byte(coinbase ? 1 : 0);
+        output.to_data(serial);
+    };
+
+    lookup_map_.store(outpoint, write, value_size);
+
+    scoped_lock lock(cache_mutex_);
+    ++cache_generation_;
+    cache({ true, height, coinbase, output }, outpoint);
+}
+
+bool utxo_database::remove(const output_point& outpoint)
+{
+    const auto removed = lookup_map_.unlink(outpoint);
+    uncache(outpoint);
+    return removed;
+}
+
+void utxo_database::reserve(size_t count, size_t size)
+{
+    // Each slab is prefixed by its key and next position.
+    static constexpr size_t overhead = std::tuple_size<chain::point>::value +
+        sizeof(file_offset) + height_size + coinbase_size;
+    lookup_manager_.reserve(count * overhead + size);
+}
+
+void utxo_database::sync()
+{
+    lookup_header_.sync();
+    lookup_manager_.sync();
+}
+
+// Cache, the caller must hold the cache mutex (except for uncache).
+// ----------------------------------------------------------------------------
+
+void utxo_database::cache(const unspent_output& entry,
+    const output_point& outpoint) const
+{
+    if (cache_capacity_ == 0)
+        return;
+
+    const auto it = cache_index_.find(outpoint);
+
+    if (it != cache_index_.end())
+    {
+        it->second->second = entry;
+        cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
+        return;
+    }
+
+    cache_list_.emplace_front(outpoint, entry);
+    cache_index_.emplace(outpoint, cache_list_.begin());
+
+    if (cache_list_.size() > cache_capacity_)
+    {
+        cache_index_.erase(cache_list_.back().first);
+        cache_list_.pop_back();
+    }
+}
+
+void utxo_database::uncache(const output_point& outpoint)
+{
+    scoped_lock lock(cache_mutex_);
+    ++cache_generation_;
+    const auto it = cache_index_.find(outpoint);
+
+    if (it == cache_index_.end())
+        return;
+
+    cache_list_.erase(it->second);
+    cache_index_.erase(it);
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -45,6 +45,7 @@
 #include <metaverse/database/memory/accessor.hpp>
 #include <metaverse/database/memory/allocator.hpp>
 #include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/memory/write_journal.hpp>
 
 // memory_map is be able to support 32 bit but because the database 
 // requires a larger file this is not validated or supported.
@@ -141,7 +142,9 @@ memory_map::memory_map(const path& filename)
     file_size_(file_size(file_handle_)),
     logical_size_(file_size_),
     closed_(true),
-    stopped_(true)
+    stopped_(true),
+    journal_epoch_(0),
+    watermark_(0)
 {
 }
 
@@ -322,6 +325,10 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
     ///////////////////////////////////////////////////////////////////////////
     const auto memory = REMAP_ALLOCATOR(mutex_);
 
+    const auto journal = write_journal::active();
+    if (journal != nullptr)
+        track(*journal);
+
     if (size > file_size_)
     {
         const auto target = size * expansion / EXPANSION_DENOMINATOR;
@@ -340,9 +347,66 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// throws runtime_error
+// Growing ahead of a batch of reservations replaces several remaps with one.
+void memory_map::preallocate(size_t size)
+{
+    // Critical Section (internal)
+    ///////////////////////////////////////////////////////////////////////////
+    const auto memory = REMAP_ALLOCATOR(mutex_);
+
+    if (size > file_size_)
+    {
+        const auto target = size * EXPANSION_NUMERATOR / EXPANSION_DENOMINATOR;
+
+        if (!truncate_mapped(target))
+        {
+            handle_error("resize", filename_);
+            throw std::runtime_error("Resize failure, disk space may be low.");
+        }
+    }
+
+    REMAP_DOWNGRADE(memory, data_);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The caller holds an accessor to the address, so the mapping is stable.
+void memory_map::preserve(const uint8_t* address, size_t size)
+{
+    const auto journal = write_journal::active();
+    if (journal == nullptr)
+        return;
+
+    BITCOIN_ASSERT(address >= data_ && address + size <= data_ + file_size_);
+    const auto offset = static_cast<file_offset>(address - data_);
+
+    // Data appended by this write is discarded with the journaled size.
+    if (offset >= track(*journal))
+        return;
+
+    journal->preserve(filename_, offset, address, size);
+}
+
 // privates
 // ----------------------------------------------------------------------------
 
+size_t memory_map::track(const write_journal& journal)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(journal_mutex_);
+
+    const auto epoch = journal.epoch();
+    if (journal_epoch_ != epoch)
+    {
+        journal_epoch_ = epoch;
+        watermark_ = logical_size_;
+    }
+
+    return watermark_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 size_t memory_map::page()
 {
 #ifdef _WIN32
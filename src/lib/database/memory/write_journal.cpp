@@ -0,0 +1,283 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/memory/write_journal.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+
+// Header: [ operation:1 ][ height:8 ][ entries size:8 ]
+// Entry:  [ name size:1 ][ name ][ offset:8 ][ size:4 ][ original bytes ]
+static constexpr size_t size_position = sizeof(uint8_t) + sizeof(uint64_t);
+static constexpr size_t header_size = size_position + sizeof(file_offset);
+static constexpr size_t entry_overhead = sizeof(uint8_t) +
+    sizeof(file_offset) + sizeof(uint32_t);
+static constexpr size_t initial_file_size = header_size + (1u << 20);
+
+static write_journal*& current_journal()
+{
+    static thread_local write_journal* journal = nullptr;
+    return journal;
+}
+
+write_journal* write_journal::active()
+{
+    return current_journal();
+}
+
+write_journal::write_journal(const path& filename)
+  : file_(filename),
+    directory_(filename.parent_path()),
+    epoch_(0),
+    size_(0)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+write_journal::~write_journal()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize file and start.
+bool write_journal::create()
+{
+    // Resize and create require a started file.
+    if (!file_.start())
+        return false;
+
+    // This will throw if insufficient disk space.
+    file_.resize(initial_file_size);
+    write_header(operation::none, 0, 0);
+    return true;
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool write_journal::start()
+{
+    return file_.start() && file_.size() >= header_size;
+}
+
+bool write_journal::stop()
+{
+    return file_.stop();
+}
+
+bool write_journal::close()
+{
+    return file_.close();
+}
+
+// Recovery.
+// ----------------------------------------------------------------------------
+
+bool write_journal::recover()
+{
+    struct entry
+    {
+        std::string name;
+        file_offset offset;
+        data_chunk data;
+    };
+
+    operation op;
+    uint64_t height;
+    std::vector<entry> entries;
+
+    {
+        // The accessor must remain in scope until the end of the block.
+        const auto memory = file_.access();
+        const auto start = REMAP_ADDRESS(memory);
+        auto deserial = make_deserializer_unsafe(start);
+        op = static_cast<operation>(deserial.read_byte());
+        height = deserial.read_8_bytes_little_endian();
+        const auto size = deserial.read_8_bytes_little_endian();
+
+        if (op == operation::none)
+            return true;
+
+        const auto end = header_size + size;
+        if (end > file_.size())
+        {
+            log::fatal(LOG_DATABASE)
+                << "The write journal is corrupt, the database must be rebuilt.";
+            return false;
+        }
+
+        for (auto position = header_size; position < end;)
+        {
+            auto reader = make_deserializer_unsafe(start + position);
+            const auto name_size = reader.read_byte();
+
+            if (position + entry_overhead + name_size > end)
+                break;
+
+            const auto name = reader.read_data(name_size);
+            const auto offset = reader.read_8_bytes_little_endian();
+            const auto data_size = reader.read_4_bytes_little_endian();
+            position += entry_overhead + name_size;
+
+            if (position + data_size > end)
+                break;
+
+            entries.push_back(
+            {
+                std::string(name.begin(), name.end()),
+                offset,
+                reader.read_data(data_size)
+            });
+
+            position += data_size;
+        }
+    }
+
+    log::warning(LOG_DATABASE)
+        << "Rolling back the interrupted "
+        << (op == operation::push ? "push" : "pop") << " of block "
+        << height << " (" << entries.size() << " writes).";
+
+    // Restore in reverse, so the oldest copy of each location is kept.
+    std::map<std::string, std::shared_ptr<bc::ofstream>> files;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+    {
+        auto& file = files[it->name];
+        if (!file)
+            file = std::make_shared<bc::ofstream>((directory_ / it->name).string(),
+                std::ofstream::in | std::ofstream::out | std::ofstream::binary);
+
+        file->seekp(it->offset);
+        file->write(reinterpret_cast<const char*>(it->data.data()),
+            it->data.size());
+
+        if (file->bad())
+        {
+            log::fatal(LOG_DATABASE)
+                << "Failed to roll back " << it->name
+                << ", the database must be rebuilt.";
+            return false;
+        }
+    }
+
+    for (const auto& file: files)
+        file.second->flush();
+
+    write_header(operation::none, 0, 0);
+
+    log::info(LOG_DATABASE)
+        << "Rolled back to block " << (op == operation::push ?
+            height - 1 : height) << ".";
+    return true;
+}
+
+// Journaling.
+// ----------------------------------------------------------------------------
+
+void write_journal::begin(operation op, size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(mutex_);
+
+    ++epoch_;
+    size_ = 0;
+    write_header(op, height, size_);
+    current_journal() = this;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void write_journal::commit()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(mutex_);
+
+    size_ = 0;
+    write_header(operation::none, 0, size_);
+    current_journal() = nullptr;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t write_journal::epoch() const
+{
+    return epoch_;
+}
+
+void write_journal::preserve(const path& file, file_offset offset,
+    const uint8_t* data, size_t size)
+{
+    const auto name = file.filename().string();
+    BITCOIN_ASSERT(name.size() <= max_uint8);
+    BITCOIN_ASSERT(size <= max_uint32);
+    const auto entry_size = entry_overhead + name.size() + size;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(mutex_);
+
+    const auto position = header_size + size_;
+    const auto memory = file_.reserve(position + entry_size);
+    const auto start = REMAP_ADDRESS(memory);
+
+    auto serial = make_serializer(start + position);
+    serial.write_byte(static_cast<uint8_t>(name.size()));
+    serial.write_data(reinterpret_cast<const uint8_t*>(name.data()),
+        name.size());
+    serial.write_8_bytes_little_endian(offset);
+    serial.write_4_bytes_little_endian(static_cast<uint32_t>(size));
+    serial.write_data(data, size);
+
+    // The entry only counts once it is completely written.
+    size_ += entry_size;
+    auto header = make_serializer(start + size_position);
+    header.write_8_bytes_little_endian(size_);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void write_journal::write_header(operation op, uint64_t height,
+    file_offset size)
+{
+    // The accessor must remain in scope until the end of the block.
+    const auto memory = file_.access();
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
+    serial.write_byte(static_cast<uint8_t>(op));
+    serial.write_8_bytes_little_endian(height);
+    serial.write_8_bytes_little_endian(size);
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/primitives/lock_stripes.hpp>
+
+#include <cstddef>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+constexpr size_t lock_stripes::size;
+
+lock_stripes::lock_stripes()
+{
+    for (auto& stripe: stripes_)
+        stripe.sequence = 0;
+}
+
+size_t lock_stripes::stripe(size_t hash) const
+{
+    return hash % size;
+}
+
+boost::mutex& lock_stripes::mutex(size_t stripe)
+{
+    BITCOIN_ASSERT(stripe < size);
+    return stripes_[stripe].mutex;
+}
+
+size_t lock_stripes::sequence(size_t stripe) const
+{
+    BITCOIN_ASSERT(stripe < size);
+    return stripes_[stripe].sequence;
+}
+
+void lock_stripes::begin_write(size_t stripe)
+{
+    BITCOIN_ASSERT(stripe < size);
+    ++stripes_[stripe].sequence;
+}
+
+void lock_stripes::end_write(size_t stripe)
+{
+    BITCOIN_ASSERT(stripe < size);
+    ++stripes_[stripe].sequence;
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -87,6 +87,16 @@ bool record_manager::start()
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void record_manager::set_header_size(file_offset header_size)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_WRITE(mutex_);
+
+    header_size_ = header_size;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 void record_manager::sync()
 {
     // Critical Section
@@ -107,6 +117,11 @@ array_index record_manager::count() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
+size_t record_manager::record_size() const
+{
+    return record_size_;
+}
+
 void record_manager::set_count(const array_index value)
 {
     // Critical Section
@@ -139,6 +154,17 @@ array_index record_manager::new_records(size_t count)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void record_manager::reserve(size_t count)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_READ(mutex_);
+
+    const size_t position = record_to_position(record_count_ + count);
+    file_.preallocate(header_size_ + position);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 const memory_ptr record_manager::get(array_index record) const
 {
     // If record >= count() then we should still be within the file. The
@@ -171,10 +197,21 @@ void record_manager::write_count()
     // The accessor must remain in scope until the end of the block.
     auto memory = file_.access();
     auto payload_size_address = REMAP_ADDRESS(memory) + header_size_;
+    file_.preserve(payload_size_address, sizeof(array_index));
     auto serial = make_serializer(payload_size_address);
     serial.write_little_endian(record_count_);
 }
 
+file_offset record_manager::file_position(array_index record) const
+{
+    return header_size_ + record_to_position(record);
+}
+
+void record_manager::preserve(const uint8_t* address, size_t size)
+{
+    file_.preserve(address, size);
+}
+
 array_index record_manager::position_to_record(file_offset position) const
 {
     return (position - sizeof(array_index)) / record_size_;
@@ -85,6 +85,16 @@ bool slab_manager::start()
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void slab_manager::set_header_size(file_offset header_size)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_WRITE(mutex_);
+
+    header_size_ = header_size;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 void slab_manager::sync() const
 {
     // Critical Section
@@ -125,6 +135,26 @@ file_offset slab_manager::new_slab(size_t size)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void slab_manager::reserve(size_t size)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_READ(mutex_);
+
+    file_.preallocate(header_size_ + payload_size_ + size);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+file_offset slab_manager::file_position(file_offset position) const
+{
+    return header_size_ + position;
+}
+
+void slab_manager::preserve(const uint8_t* address, size_t size)
+{
+    file_.preserve(address, size);
+}
+
 // Position is offset by header but not size storage (embedded in data files).
 const memory_ptr slab_manager::get(file_offset position) const
 {
@@ -159,6 +189,7 @@ void slab_manager::write_size() const
     // The accessor must remain in scope until the end of the block.
     const auto memory = file_.access();
     const auto payload_size_address = REMAP_ADDRESS(memory) + header_size_;
+    file_.preserve(payload_size_address, sizeof(file_offset));
     auto serial = make_serializer(payload_size_address);
     serial.write_little_endian(payload_size_);
 }
@@ -130,16 +130,45 @@ console_result dispatch_command(int argc, const char* argv[],
     return command->invoke(out, err);
 }
 
-console_result dispatch_command(int argc, const char* argv[],
+// Invoke a command whose arguments are already bound.
+static console_result invoke_command(command& command, Json::Value& jv_output,
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    std::ostringstream output;
+
+    command.set_api_version(api_version);
+
+    if (command.category(ctgy_extension))
+    {
+        // fixme. is_blockchain_sync has some problem.
+        // if (command.category(ctgy_online) && node.is_blockchain_sync()) {
+        if (command.category(ctgy_online) &&
+            !node.chain_impl().chain_settings().use_testnet_rules) {
+            uint64_t height{0};
+            node.chain_impl().get_last_height(height);
+            if (!command.is_block_height_fullfilled(height)) {
+                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
+            }
+        }
+
+        return static_cast<commands::command_extension&>(command).invoke(jv_output, node);
+    }
+    else {
+        command.set_api_version(1); // only compatible for v1
+        auto retcode = command.invoke(output, output);
+        jv_output = output.str();
+        return retcode;
+    }
+}
+
+static console_result dispatch_command(std::shared_ptr<command> command,
+    const std::string& target, int argc, const char* argv[],
     Json::Value& jv_output,
     libbitcoin::server::server_node& node, uint8_t api_version)
 {
     std::istringstream input;
     std::ostringstream output;
 
-    const std::string target(argv[0]);
-    const auto command = find(target);
-
     if (!command)
     {
         const std::string superseding(formerly(target));
@@ -165,31 +194,33 @@ console_result dispatch_command(int argc, const char* argv[],
         return console_result::okay;
     }
 
-    command->set_api_version(api_version);
-
-    if (command->category(ctgy_extension))
-    {
-        // fixme. is_blockchain_sync has some problem.
-        // if (command->category(ctgy_online) && node.is_blockchain_sync()) {
-        if (command->category(ctgy_online) &&
-            !node.chain_impl().chain_settings().use_testnet_rules) {
-            uint64_t height{0};
-            node.chain_impl().get_last_height(height);
-            if (!command->is_block_height_fullfilled(height)) {
-                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
-            }
-        }
+    return invoke_command(*command, jv_output, node, api_version);
+}
 
-        return static_cast<commands::command_extension*>(command.get())->invoke(jv_output, node);
-    }
-    else {
-        command->set_api_version(1); // only compatible for v1
-        auto retcode = command->invoke(output, output);
-        jv_output = output.str();
-        return retcode;
-    }
+console_result dispatch_command(int argc, const char* argv[],
+    Json::Value& jv_output,
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    const std::string target(argv[0]);
+    return dispatch_command(find(target), target, argc, argv, jv_output,
+        node, api_version);
 }
 
+bool dispatch_json_command(const std::string& target,
+    const Json::Value& params, Json::Value& jv_output,
+    libbitcoin::server::server_node& node, uint8_t api_version,
+    console_result& result)
+{
+    const auto command = find(target);
+
+    // Commands with a json binder skip argv and program_options.
+    if (!command || !command->category(ctgy_extension) ||
+        !static_cast<commands::command_extension*>(command.get())->bind_json(params))
+        return false;
+
+    result = invoke_command(*command, jv_output, node, api_version);
+    return true;
+}
 
 } // namespace explorer
 } // namespace libbitcoin
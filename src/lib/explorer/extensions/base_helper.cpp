@@ -272,7 +272,8 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
     }
 }
 
-void sync_fetchbalance(wallet::payment_address& address,
+// Sum the balance from the full address history, confirmed and pooled.
+static void sync_fetchbalance_history(wallet::payment_address& address,
     bc::blockchain::block_chain_impl& blockchain, balances& addr_balance)
 {
     auto&& rows = blockchain.get_address_history(address);
@@ -333,6 +334,78 @@ void sync_fetchbalance(wallet::payment_address& address,
     addr_balance.frozen_balance = frozen_balance;
 }
 
+void sync_fetchbalance(wallet::payment_address& address,
+    bc::blockchain::block_chain_impl& blockchain, balances& addr_balance)
+{
+    // The confirmed part is read from the balance index when it covers the
+    // whole chain, only the transaction pool is then scanned.
+    database::address_balance confirmed;
+    if (!blockchain.get_address_balance(address, confirmed)) {
+        sync_fetchbalance_history(address, blockchain, addr_balance);
+        return;
+    }
+
+    chain::spend_info::list spends;
+    chain::output_info::list outputs;
+    blockchain.get_pool_history(address, spends, outputs);
+
+    uint64_t height = 0;
+    blockchain.get_last_height(height);
+
+    const auto pool_spent = [&spends](const chain::output_point& point) {
+        return std::any_of(spends.begin(), spends.end(),
+            [&point](const chain::spend_info& spend) {
+                return spend.previous_output == point;
+            });
+    };
+
+    uint64_t total_received = confirmed.received;
+    uint64_t unspent_balance = confirmed.unspent;
+    uint64_t frozen_balance = 0;
+
+    // deposit not expire or coinbase not mature
+    for (auto& output: confirmed.locked) {
+        if (output.unlock_height > height && !pool_spent(output.point)) {
+            frozen_balance += output.value;
+        }
+    }
+
+    chain::transaction tx_temp;
+    uint64_t tx_height;
+
+    for (auto& output: outputs) {
+        total_received += output.value;
+
+        if (pool_spent(output.point)) {
+            continue;
+        }
+
+        unspent_balance += output.value;
+
+        // deposit utxo in transaction pool
+        if (blockchain.get_transaction(output.point.hash, tx_temp, tx_height)
+                && output.point.index < tx_temp.outputs.size()
+                && chain::operation::is_pay_key_hash_with_lock_height_pattern(
+                    tx_temp.outputs[output.point.index].script.operations)) {
+            frozen_balance += output.value;
+        }
+    }
+
+    // confirmed utxo spent in transaction pool
+    for (auto& spend: spends) {
+        database::address_output output;
+        if (blockchain.get_address_output(spend.previous_output, output)
+                && output.key == address.hash()) {
+            unspent_balance -= output.value;
+        }
+    }
+
+    addr_balance.confirmed_balance = confirmed.unspent;
+    addr_balance.total_received = total_received;
+    addr_balance.unspent_balance = unspent_balance;
+    addr_balance.frozen_balance = frozen_balance;
+}
+
 bool base_transfer_common::get_spendable_output(
     chain::output& output, const chain::history& row, uint64_t height) const
 {
@@ -380,7 +453,13 @@ void base_transfer_common::sync_fetchutxo(
         const std::string& prikey, const std::string& addr, filter filter)
 {
     auto&& waddr = wallet::payment_address(addr);
-    auto&& rows = blockchain_.get_address_history(waddr, true);
+
+    // Only the unspent outputs are read when the balance index covers the
+    // whole chain, otherwise the full address history is expanded.
+    chain::history::list rows;
+    if (!blockchain_.get_address_unspent(waddr, rows)) {
+        rows = blockchain_.get_address_history(waddr, true);
+    }
 
     uint64_t height = 0;
     blockchain_.get_last_height(height);
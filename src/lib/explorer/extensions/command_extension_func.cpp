@@ -23,6 +23,8 @@
 #include <memory>
 #include <string>
 #include <array>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <metaverse/explorer/command.hpp>
 #include <metaverse/explorer/dispatch.hpp>
@@ -215,182 +217,161 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func, std::os
     func(make_shared<getdid>());
 }
 
-shared_ptr<command> find_extension(const string& symbol)
-{
-    using namespace std;
-    using namespace commands;
+typedef shared_ptr<command>(*command_factory)();
 
-    // account
-    if (symbol == getnewaccount::symbol())
-        return make_shared<getnewaccount>();
-    if (symbol == getaccount::symbol())
-        return make_shared<getaccount>();
-    if (symbol == deleteaccount::symbol())
-        return make_shared<deleteaccount>();
-    if (symbol == changepasswd::symbol())
-        return make_shared<changepasswd>();
-    if (symbol == validateaddress::symbol())
-        return make_shared<validateaddress>();
-    if (symbol == getnewaddress::symbol())
-        return make_shared<getnewaddress>();
-    if (symbol == listaddresses::symbol())
-        return make_shared<listaddresses>();
-    if (symbol == importaccount::symbol())
-        return make_shared<importaccount>();
-    if (symbol == dumpkeyfile::symbol() || symbol == "exportaccountasfile")
-        return make_shared<dumpkeyfile>();
-    if (symbol == importkeyfile::symbol() || symbol == "importaccountfromfile")
-        return make_shared<importkeyfile>();
-
-    // system
-    if (symbol == shutdown::symbol())
-        return make_shared<shutdown>();
-    if (symbol == getinfo::symbol())
-        return make_shared<getinfo>();
-    if (symbol == addnode::symbol())
-        return make_shared<addnode>();
-    if (symbol == getpeerinfo::symbol())
-        return make_shared<getpeerinfo>();
-
-    // mining
-    if (symbol == stopmining::symbol() || symbol == "stop")
-        return make_shared<stopmining>();
-    if (symbol == startmining::symbol() || symbol == "start")
-        return make_shared<startmining>();
-    if (symbol == setminingaccount::symbol())
-        return make_shared<setminingaccount>();
-    if (symbol == getmininginfo::symbol())
-        return make_shared<getmininginfo>();
-    if ((symbol == getwork::symbol()) || (symbol == "eth_getWork"))
-        return make_shared<getwork>();
-    if ((symbol == submitwork::symbol()) || ( symbol == "eth_submitWork"))
-        return make_shared<submitwork>();
-    if (symbol == getmemorypool::symbol())
-        return make_shared<getmemorypool>();
-
-    // block & tx
-    if (symbol == getheight::symbol())
-        return make_shared<getheight>();
-    if (symbol == "fetch-height")
-        return make_shared<getheight>(symbol);
-    if (symbol == getblock::symbol())
-        return make_shared<getblock>();
-    if (symbol == "getbestblockhash")
-        return make_shared<getblockheader>(symbol);
-    if (symbol == getblockheader::symbol() || symbol == "fetch-header" || symbol == "getbestblockheader")
-        return make_shared<getblockheader>();
-    if (symbol == fetchheaderext::symbol())
-        return make_shared<fetchheaderext>();
-    if (symbol == gettx::symbol() || symbol == "gettransaction")
-        return make_shared<gettx>();
-    if (symbol == "fetch-tx")
-        return make_shared<gettx>(symbol);
-    if (symbol == listtxs::symbol())
-        return make_shared<listtxs>();
-
-    // raw tx
-    if (symbol == createrawtx::symbol())
-        return make_shared<createrawtx>();
-    if (symbol == decoderawtx::symbol())
-        return make_shared<decoderawtx>();
-    if (symbol == signrawtx::symbol())
-        return make_shared<signrawtx>();
-    if (symbol == sendrawtx::symbol())
-        return make_shared<sendrawtx>();
+template <typename Command>
+static shared_ptr<command> make_command()
+{
+    return std::make_shared<Command>();
+}
 
-    // multi-sig
-    if (symbol == getpublickey::symbol())
-        return make_shared<getpublickey>();
-    if (symbol == getnewmultisig::symbol())
-        return make_shared<getnewmultisig>();
-    if (symbol == listmultisig::symbol())
-        return make_shared<listmultisig>();
-    if (symbol == deletemultisig::symbol())
-        return make_shared<deletemultisig>();
-    if (symbol == createmultisigtx::symbol())
-        return make_shared<createmultisigtx>();
-    if (symbol == signmultisigtx::symbol())
-        return make_shared<signmultisigtx>();
+// Built once, a lookup is one hash instead of a string compare per command.
+static const std::unordered_map<std::string, command_factory>& extension_table()
+{
+    using namespace commands;
 
-    // etp
-    if (symbol == listbalances::symbol())
-        return make_shared<listbalances>();
-    if (symbol == getbalance::symbol())
-        return make_shared<getbalance>();
-    if (symbol == getaddressetp::symbol() || symbol == "fetch-balance")
-        return make_shared<getaddressetp>();
-    if (symbol == deposit::symbol())
-        return make_shared<deposit>();
-    if (symbol == send::symbol())
-        return make_shared<send>();
-    if (symbol == sendmore::symbol())
-        return make_shared<sendmore>();
-    if (symbol == sendfrom::symbol())
-        return make_shared<sendfrom>();
+    static const std::unordered_map<std::string, command_factory> table
+    {
+        // account
+        { getnewaccount::symbol(), make_command<getnewaccount> },
+        { getaccount::symbol(), make_command<getaccount> },
+        { deleteaccount::symbol(), make_command<deleteaccount> },
+        { changepasswd::symbol(), make_command<changepasswd> },
+        { validateaddress::symbol(), make_command<validateaddress> },
+        { getnewaddress::symbol(), make_command<getnewaddress> },
+        { listaddresses::symbol(), make_command<listaddresses> },
+        { importaccount::symbol(), make_command<importaccount> },
+        { dumpkeyfile::symbol(), make_command<dumpkeyfile> },
+        { "exportaccountasfile", make_command<dumpkeyfile> },
+        { importkeyfile::symbol(), make_command<importkeyfile> },
+        { "importaccountfromfile", make_command<importkeyfile> },
+
+        // system
+        { shutdown::symbol(), make_command<shutdown> },
+        { getinfo::symbol(), make_command<getinfo> },
+        { addnode::symbol(), make_command<addnode> },
+        { getpeerinfo::symbol(), make_command<getpeerinfo> },
+
+        // mining
+        { stopmining::symbol(), make_command<stopmining> },
+        { "stop", make_command<stopmining> },
+        { startmining::symbol(), make_command<startmining> },
+        { "start", make_command<startmining> },
+        { setminingaccount::symbol(), make_command<setminingaccount> },
+        { getmininginfo::symbol(), make_command<getmininginfo> },
+        { getwork::symbol(), make_command<getwork> },
+        { "eth_getWork", make_command<getwork> },
+        { submitwork::symbol(), make_command<submitwork> },
+        { "eth_submitWork", make_command<submitwork> },
+        { getmemorypool::symbol(), make_command<getmemorypool> },
+
+        // block & tx
+        { getheight::symbol(), make_command<getheight> },
+        { "fetch-height", []() -> shared_ptr<command> { return std::make_shared<getheight>("fetch-height"); } },
+        { getblock::symbol(), make_command<getblock> },
+        { "getbestblockhash", []() -> shared_ptr<command> { return std::make_shared<getblockheader>("getbestblockhash"); } },
+        { getblockheader::symbol(), make_command<getblockheader> },
+        { "fetch-header", make_command<getblockheader> },
+        { "getbestblockheader", make_command<getblockheader> },
+        { fetchheaderext::symbol(), make_command<fetchheaderext> },
+        { gettx::symbol(), make_command<gettx> },
+        { "gettransaction", make_command<gettx> },
+        { "fetch-tx", []() -> shared_ptr<command> { return std::make_shared<gettx>("fetch-tx"); } },
+        { listtxs::symbol(), make_command<listtxs> },
+
+        // raw tx
+        { createrawtx::symbol(), make_command<createrawtx> },
+        { decoderawtx::symbol(), make_command<decoderawtx> },
+        { signrawtx::symbol(), make_command<signrawtx> },
+        { sendrawtx::symbol(), make_command<sendrawtx> },
+
+        // multi-sig
+        { getpublickey::symbol(), make_command<getpublickey> },
+        { getnewmultisig::symbol(), make_command<getnewmultisig> },
+        { listmultisig::symbol(), make_command<listmultisig> },
+        { deletemultisig::symbol(), make_command<deletemultisig> },
+        { createmultisigtx::symbol(), make_command<createmultisigtx> },
+        { signmultisigtx::symbol(), make_command<signmultisigtx> },
+
+        // etp
+        { listbalances::symbol(), make_command<listbalances> },
+        { getbalance::symbol(), make_command<getbalance> },
+        { getaddressetp::symbol(), make_command<getaddressetp> },
+        { "fetch-balance", make_command<getaddressetp> },
+        { deposit::symbol(), make_command<deposit> },
+        { send::symbol(), make_command<send> },
+        { sendmore::symbol(), make_command<sendmore> },
+        { sendfrom::symbol(), make_command<sendfrom> },
+
+        // asset
+        { createasset::symbol(), make_command<createasset> },
+        { deletelocalasset::symbol(), make_command<deletelocalasset> },
+        { "deleteasset", make_command<deletelocalasset> },
+        { listassets::symbol(), make_command<listassets> },
+        { getasset::symbol(), make_command<getasset> },
+        { getaccountasset::symbol(), make_command<getaccountasset> },
+        { getaddressasset::symbol(), make_command<getaddressasset> },
+        { issue::symbol(), make_command<issue> },
+        // { issuefrom::symbol(), make_command<issuefrom> },
+        { secondaryissue::symbol(), make_command<secondaryissue> },
+        { "additionalissue", make_command<secondaryissue> },
+        { sendasset::symbol(), make_command<sendasset> },
+        { sendassetfrom::symbol(), make_command<sendassetfrom> },
+        { burn::symbol(), make_command<burn> },
+
+        // cert
+        { transfercert::symbol(), make_command<transfercert> },
+        { issuecert::symbol(), make_command<issuecert> },
+
+        // mit
+        { registermit::symbol(), make_command<registermit> },
+        { transfermit::symbol(), make_command<transfermit> },
+        { listmits::symbol(), make_command<listmits> },
+        { getmit::symbol(), make_command<getmit> },
+
+        // did
+        { registerdid::symbol(), make_command<registerdid> },
+        { didsend::symbol(), make_command<didsend> },
+        { didsendasset::symbol(), make_command<didsendasset> },
+        { didsendfrom::symbol(), make_command<didsendfrom> },
+        { didsendmore::symbol(), make_command<didsendmore> },
+        { didsendassetfrom::symbol(), make_command<didsendassetfrom> },
+        { didchangeaddress::symbol(), make_command<didchangeaddress> },
+        { listdids::symbol(), make_command<listdids> },
+        { getdid::symbol(), make_command<getdid> }
+    };
+
+    return table;
+}
 
-    // asset
-    if (symbol == createasset::symbol())
-        return make_shared<createasset>();
-    if (symbol == deletelocalasset::symbol() || symbol == "deleteasset" )
-        return make_shared<deletelocalasset>();
-    if (symbol == listassets::symbol())
-        return make_shared<listassets>();
-    if (symbol == getasset::symbol())
-        return make_shared<getasset>();
-    if (symbol == getaccountasset::symbol())
-        return make_shared<getaccountasset>();
-    if (symbol == getaddressasset::symbol())
-        return make_shared<getaddressasset>();
-    if (symbol == issue::symbol())
-        return make_shared<issue>();
-    // if (symbol == issuefrom::symbol())
-    //     return make_shared<issuefrom>();
-    if (symbol == secondaryissue::symbol() || (symbol == "additionalissue") )
-        return make_shared<secondaryissue>();
-    if (symbol == sendasset::symbol())
-        return make_shared<sendasset>();
-    if (symbol == sendassetfrom::symbol())
-        return make_shared<sendassetfrom>();
-    if (symbol == burn::symbol())
-        return make_shared<burn>();
+shared_ptr<command> find_extension(const string& symbol)
+{
+    const auto& table = extension_table();
+    const auto it = table.find(symbol);
+    if (it == table.end())
+        return nullptr;
 
-    // cert
-    if (symbol == transfercert::symbol())
-        return make_shared<transfercert>();
-    if (symbol == issuecert::symbol())
-        return make_shared<issuecert>();
+    return it->second();
+}
 
-    // mit
-    if (symbol == registermit::symbol())
-        return make_shared<registermit>();
-    if (symbol == transfermit::symbol())
-        return make_shared<transfermit>();
-    if (symbol == listmits::symbol())
-        return make_shared<listmits>();
-    if (symbol == getmit::symbol())
-        return make_shared<getmit>();
-
-    // did
-    if (symbol == registerdid::symbol())
-        return make_shared<registerdid>();
-    if (symbol == didsend::symbol())
-        return make_shared<didsend>();
-    if (symbol == didsendasset::symbol())
-        return make_shared<didsendasset>();
-    if (symbol == didsendfrom::symbol())
-        return make_shared<didsendfrom>();
-    if (symbol == didsendmore::symbol())
-        return make_shared<didsendmore>();
-    if (symbol == didsendassetfrom::symbol())
-        return make_shared<didsendassetfrom>();
-    if (symbol == didchangeaddress::symbol())
-        return make_shared<didchangeaddress>();
-    if (symbol == listdids::symbol())
-        return make_shared<listdids>();
-    if (symbol == getdid::symbol())
-        return make_shared<getdid>();
-
-    return nullptr;
+bool readonly_extension(const string& symbol)
+{
+    // Taken from the command classes once, aliases included.
+    static const auto readonly = []()
+    {
+        std::unordered_set<std::string> symbols;
+        for (const auto& entry : extension_table())
+        {
+            const auto command = std::dynamic_pointer_cast<
+                commands::command_extension>(entry.second());
+            if (command && command->reads_chain_only())
+                symbols.insert(entry.first);
+        }
+
+        return symbols;
+    }();
+
+    return readonly.count(symbol) != 0;
 }
 
 std::string formerly_extension(const string& former)
@@ -108,17 +108,6 @@ console_result listtxs::invoke(Json::Value& jv_output,
         sh_addr_vec->push_back(argument_.address);
     }
 
-    // scan all addresses business record
-    for (auto& each: *sh_addr_vec) {
-        auto sh_vec = blockchain.get_address_business_record(each, argument_.symbol,
-                option_.height.first(), option_.height.second(), 0, 0);
-        for(auto& elem : *sh_vec)
-            sh_txs->push_back(tx_block_info(elem.height, elem.data.get_timestamp(), elem.point.hash));
-    }
-    std::sort (sh_txs->begin(), sh_txs->end());
-    sh_txs->erase(std::unique(sh_txs->begin(), sh_txs->end()), sh_txs->end());
-    std::sort (sh_txs->begin(), sh_txs->end(), sort_by_height);
-
     // page limit & page index paramenter check
     if(!argument_.index)
         throw argument_legality_exception{"page index parameter cannot be zero"};
@@ -127,30 +116,45 @@ console_result listtxs::invoke(Json::Value& jv_output,
     if(argument_.limit > 100)
         throw argument_legality_exception{"page record limit cannot be bigger than 100."};
 
-    uint64_t start, end, total_page, tx_count;
-    if(argument_.index && argument_.limit) {
-        start = (argument_.index - 1)*argument_.limit;
-        end = (argument_.index)*argument_.limit;
+    std::vector<tx_block_info> result;
+    uint64_t total_page = 0, tx_count = 0;
+
+    if (option_.use_cursor) {
+        // seek to the cursor and read just this page
+        auto sh_page = blockchain.get_address_business_record_page(*sh_addr_vec, argument_.symbol,
+                option_.height.first(), option_.height.second(), argument_.limit, option_.cursor);
+        if (!sh_page)
+            throw argument_legality_exception{"invalid cursor parameter"};
+
+        for (auto& elem : *sh_page)
+            result.push_back(tx_block_info(elem.height, elem.data.get_timestamp(), elem.point.hash));
+        tx_count = result.size();
+    } else {
+        // scan all addresses business record
+        for (auto& each: *sh_addr_vec) {
+            auto sh_vec = blockchain.get_address_business_record(each, argument_.symbol,
+                    option_.height.first(), option_.height.second(), 0, 0);
+            for(auto& elem : *sh_vec)
+                sh_txs->push_back(tx_block_info(elem.height, elem.data.get_timestamp(), elem.point.hash));
+        }
+        std::sort (sh_txs->begin(), sh_txs->end());
+        sh_txs->erase(std::unique(sh_txs->begin(), sh_txs->end()), sh_txs->end());
+        std::sort (sh_txs->begin(), sh_txs->end(), sort_by_height);
+
+        uint64_t start = (argument_.index - 1)*argument_.limit;
+        uint64_t end = (argument_.index)*argument_.limit;
         if(start >= sh_txs->size() || !sh_txs->size())
             throw argument_legality_exception{"no record in this page"};
 
         total_page = sh_txs->size() % argument_.limit ? (sh_txs->size()/argument_.limit + 1) : (sh_txs->size()/argument_.limit);
         tx_count = end >=sh_txs->size()? (sh_txs->size() - start) : argument_.limit ;
 
-    } else if(!argument_.index && !argument_.limit) { // all tx records
-        start = 0;
-        tx_count = sh_txs->size();
-        argument_.index = 1;
-        total_page = 1;
-    } else {
-        throw argument_legality_exception{"invalid limit or index parameter"};
+        // sort by height
+        result.assign(sh_txs->begin() + start, sh_txs->begin() + start + tx_count);
     }
 
     auto json_helper = config::json_helper(get_api_version());
 
-    // sort by height
-    std::vector<tx_block_info> result(sh_txs->begin() + start, sh_txs->begin() + start + tx_count);
-
     // fetch tx according its hash
     std::vector<std::string> vec_ip_addr; // input addr
     chain::transaction tx;
@@ -292,7 +296,14 @@ console_result listtxs::invoke(Json::Value& jv_output,
         balances.append(tx_item);
     }
 
-    if (get_api_version() == 1) {
+    if (option_.use_cursor) {
+        // empty once the last page is reached
+        aroot["next_cursor"] = option_.cursor;
+        if (get_api_version() == 1)
+            aroot["transaction_count"] += tx_count;
+        else
+            aroot["transaction_count"] = tx_count;
+    } else if (get_api_version() == 1) {
         aroot["total_page"] += total_page;
         aroot["current_page"] += argument_.index;
         aroot["transaction_count"] += tx_count;
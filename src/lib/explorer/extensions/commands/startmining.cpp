@@ -78,7 +78,7 @@ console_result startmining::invoke(Json::Value& jv_output,
     }
 
     // start
-    if (miner.start(addr, option_.number)){
+    if (miner.start(addr, option_.number, option_.threads)){
         if (option_.number == 0) {
             jv_output = "solo mining started at " + str_addr;
         } else {
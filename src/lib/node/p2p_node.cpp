@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <functional>
 #include <metaverse/blockchain.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/node/configuration.hpp>
 #include <metaverse/node/sessions/session_block_sync.hpp>
 #include <metaverse/node/sessions/session_header_sync.hpp>
@@ -42,7 +43,7 @@ using namespace std::placeholders;
 
 p2p_node::p2p_node(const configuration& configuration)
   : p2p(configuration.network),
-    hashes_(configuration.chain.checkpoints),
+    hashes_(thread_pool(), configuration.chain.checkpoints),
     blockchain_(thread_pool(), configuration.chain, configuration.database),
     settings_(configuration.node)
 {
@@ -241,6 +242,9 @@ bool p2p_node::close()
     if (!p2p_node::stop())
         return false;
 
+    // Abort the DAG and light cache preparations, they are not restarted.
+    MinerAux::stop();
+
     // Join threads first so that there is no activity on the chain at close.
     return p2p::close() && blockchain_.stop() && blockchain_.close();
 }
@@ -298,11 +298,26 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.transaction_pool_consistency),
         "Enforce consistency between the pool and the blockchain, defaults to false."
     )
+    (
+        "blockchain.script_cache_capacity",
+        value<uint32_t>(&configured.chain.script_cache_capacity),
+        "The maximum number of verified input scripts to cache, defaults to 100000."
+    )
     (
         "blockchain.use_testnet_rules",
         value<bool>(&configured.chain.use_testnet_rules),
         "Use testnet rules for determination of work required, defaults to false."
     )
+    (
+        "blockchain.dag_threads",
+        value<uint32_t>(&configured.chain.dag_threads),
+        "The number of threads generating the ethash DAG, defaults to 0 (all cores)."
+    )
+    (
+        "blockchain.dag_pregenerate",
+        value<bool>(&configured.chain.dag_pregenerate),
+        "Generate the DAG of the next epoch in the background while mining, defaults to false."
+    )
     (
         "blockchain.checkpoint",
         value<config::checkpoint::list>(&configured.chain.checkpoints),
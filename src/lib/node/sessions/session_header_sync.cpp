@@ -260,7 +260,17 @@ bool session_header_sync::initialize(result_handler handler)
     log::info(LOG_NODE)
         << "Getting headers " << first_height << "-" << stop_height << ".";
 
-    hashes_.initialize(seed);
+    // The seed header is required to validate the first received header.
+    header seed_header;
+    if (!blockchain_.get_header(seed_header, seed.height()))
+    {
+        log::error(LOG_NODE)
+            << "Error getting header sync seed " << seed.height() << ".";
+        handler(error::operation_failed);
+        return false;
+    }
+
+    hashes_.initialize(seed_header, seed.height());
     return true;
 }
 
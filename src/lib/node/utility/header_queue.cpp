@@ -24,6 +24,7 @@
 #include <iterator>
 #include <memory>
 #include <metaverse/blockchain.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 
 namespace libbitcoin {
 namespace node {
@@ -33,10 +34,12 @@ using namespace bc::chain;
 using namespace bc::config;
 using namespace bc::message;
 
-header_queue::header_queue(const config::checkpoint::list& checkpoints)
+header_queue::header_queue(threadpool& pool,
+    const config::checkpoint::list& checkpoints)
   : height_(0),
     head_(list_.begin()),
-    checkpoints_(checkpoints)
+    checkpoints_(checkpoints),
+    pool_(pool)
 {
 }
 
@@ -113,6 +116,23 @@ void header_queue::initialize(const hash_digest& hash, size_t height)
     list_.emplace_back(hash);
     head_ = list_.begin();
     height_ = height;
+    last_header_ = chain::header();
+    retained_.clear();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_queue::initialize(const chain::header& header, size_t height)
+{
+    initialize(header.hash(), height);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    last_header_ = header;
+    retained_.push_back(header);
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -246,10 +266,13 @@ bool header_queue::enqueue(headers::ptr message)
         return false;
     }
 
+    // Proof of work is checked while readers may still proceed.
+    const auto valid = validate(message->elements);
+
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
 
-    const auto result = merge(message->elements);
+    const auto result = merge(message->elements, valid);
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -260,8 +283,33 @@ bool header_queue::enqueue(headers::ptr message)
 // private
 //-----------------------------------------------------------------------------
 
-// TODO: add PoW validation to reduce importance of intermediate checkpoints.
-bool header_queue::merge(const header::list& headers)
+// Seals are verified in parallel batches, the difficulty of each header
+// against its predecessor. Nothing is valid if the header the first one links
+// to is unknown, as its difficulty could not be checked.
+size_t header_queue::validate(const header::list& headers) const
+{
+    if (headers.empty() || is_empty() || last_header_.hash() != list_.back())
+        return 0;
+
+    // MinerAux works on mutable headers, the parent of headers[i] is at i.
+    header::list sequence;
+    sequence.reserve(headers.size() + 1);
+    sequence.push_back(last_header_);
+    sequence.insert(sequence.end(), headers.begin(), headers.end());
+
+    std::vector<std::pair<header*, header*>> items;
+    items.reserve(headers.size());
+
+    for (size_t index = 1; index < sequence.size(); ++index)
+        items.emplace_back(&sequence[index], &sequence[index - 1]);
+
+    const auto seals = MinerAux::verifySeals(pool_, items);
+    const auto invalid = std::find_if(seals.begin(), seals.end(),
+        [](MinerAux::Seal seal) { return seal != MinerAux::Seal::valid; });
+    return std::distance(seals.begin(), invalid);
+}
+
+bool header_queue::merge(const header::list& headers, size_t valid)
 {
     // If we exceed capacity the header pointer becomes invalid, so prevent.
     const auto size = get_size();
@@ -269,21 +317,29 @@ bool header_queue::merge(const header::list& headers)
     list_.reserve(size + headers.size());
     head_ = list_.begin();
 
-    for (const auto& header: headers)
+    for (size_t index = 0; index < headers.size(); ++index)
     {
+        const auto& header = headers[index];
         const auto& new_hash = header.hash();
         const auto next_height = last() + 1;
         const auto& last_hash = is_empty() ? null_hash : list_.back();
 
-        if (!linked(header, last_hash) || !check(new_hash, next_height))
+        if (index >= valid || !linked(header, last_hash) ||
+            !check(new_hash, next_height))
         {
             rollback();
             return false;
         }
 
         list_.emplace_back(new_hash);
+
+        if (is_checkpoint(new_hash, next_height))
+            retained_.push_back(header);
     }
 
+    if (!headers.empty())
+        last_header_ = headers.back();
+
     return true;
 }
 
@@ -298,6 +354,7 @@ void header_queue::rollback()
             if (match != list_.end())
             {
                 list_.erase(++match, list_.end());
+                retain(list_.back());
                 return;
             }
         }
@@ -313,6 +370,23 @@ void header_queue::rollback()
     }
 
     head_ = list_.begin();
+
+    if (!is_empty())
+        retain(list_.back());
+}
+
+// The next header is rejected unless the retained one is known.
+void header_queue::retain(const hash_digest& hash)
+{
+    const auto is_retained = [&hash](const chain::header& header)
+    {
+        return header.hash() == hash;
+    };
+
+    const auto it = std::find_if(retained_.begin(), retained_.end(),
+        is_retained);
+
+    last_header_ = it == retained_.end() ? chain::header() : *it;
 }
 
 bool header_queue::check(const hash_digest& hash, size_t height) const
@@ -320,6 +394,16 @@ bool header_queue::check(const hash_digest& hash, size_t height) const
     return checkpoint::validate(hash, height, checkpoints_);
 }
 
+bool header_queue::is_checkpoint(const hash_digest& hash, size_t height) const
+{
+    const auto is_match = [&hash, height](const checkpoint& check)
+    {
+        return check.height() == height && check.hash() == hash;
+    };
+
+    return std::any_of(checkpoints_.begin(), checkpoints_.end(), is_match);
+}
+
 bool header_queue::linked(const chain::header& header,
     const hash_digest& hash) const
 {
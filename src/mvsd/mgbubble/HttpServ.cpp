@@ -14,11 +14,13 @@
  * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
  * 02110-1301, USA.
  */
+#include <algorithm>
 #include <exception>
 #include <functional> //hash
 
 #include <metaverse/mgbubble/HttpServ.hpp>
 #include <metaverse/mgbubble/exception/Instances.hpp>
+#include <metaverse/mgbubble/utility/Json_writer.hpp>
 #include <metaverse/mgbubble/utility/Stream_buf.hpp>
 
 #include <metaverse/explorer/extensions/command_extension_func.hpp>
@@ -54,87 +56,396 @@ void HttpServ::reset(HttpMessage& data) noexcept
     uri_.reset(uri);
 }
 
-void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version)
+HttpServ::HttpServ(const char* webroot, libbitcoin::server::server_node &node, const std::string& srv_addr)
+    : node_(node), MgServer(srv_addr),
+      workers_(node.server_settings().rpc_workers,
+          node.server_settings().rpc_queue_limit,
+          node.server_settings().rpc_command_concurrency),
+      serial_(1, node.server_settings().rpc_queue_limit, 1),
+      cache_(node.server_settings().rpc_cache_megabytes * 1024 * 1024),
+      jobs_(serial_, node.server_settings().rpc_job_workers,
+          node.server_settings().rpc_queue_limit,
+          node.server_settings().rpc_command_concurrency,
+          node.server_settings().rpc_job_retention),
+      idle_timeout_(node.server_settings().rpc_idle_timeout_seconds),
+      compress_threshold_(node.server_settings().rpc_compress_threshold)
 {
-    reset(data);
-    StreamBuf buf{ nc.send_mbuf };
-    out_.rdbuf(&buf);
-    out_.reset(200, "OK");
+    document_root_ = webroot;
+    set_document_root(document_root_.c_str());
+}
 
-    const vector<uint8_t> api20_ver_list = {2, 3};
-    auto checkAPIVer = [](const vector<uint8_t> &api_ver_list, const uint8_t &rpc_version){
-        return find(api_ver_list.begin(), api_ver_list.end(), rpc_version) != api_ver_list.end();
-    };
+void HttpServ::rpc_request(mg_connection& nc, std::shared_ptr<HttpMessage> data, uint8_t rpc_version)
+{
+    reset(*data);
+    const auto id = enqueue(nc, false, !data->keep_alive());
+
+    // The body is only valid during this event, parse it here.
     try {
-        data.data_to_arg(rpc_version);
+        data->data_to_arg(rpc_version);
+    }
+    catch (...) {
+        auto error = std::current_exception();
+        complete(&nc, id, std::make_shared<std::string>(rpc_response(*data, rpc_version, error)));
+        return;
+    }
 
-        Json::Value jv_output;
-                
-        auto retcode = explorer::dispatch_command(data.argc(), const_cast<const char**>(data.argv()),
-            jv_output, node_, rpc_version);
+    if (data->batch().isArray()) {
+        rpc_batch(nc, id, *data, rpc_version);
+        return;
+    }
 
-        if (retcode == console_result::failure) { // only orignal command
-            if (rpc_version == 1 && !jv_output.isObject() && !jv_output.isArray()) {
-                throw explorer::command_params_exception{ jv_output.asString() };
-            }
-            throw explorer::command_params_exception{ jv_output.toStyledString() };
+    if (data->async() && rpc_version != 1) {
+        rpc_job(nc, id, data, rpc_version);
+        return;
+    }
+
+    const auto& command = data->jsonrpc_method();
+    auto* conn = &nc;
+
+    const auto accepted = lane(command).submit(command, [this, conn, id, data, rpc_version]() {
+        auto response = std::make_shared<std::string>(rpc_response(*data, rpc_version));
+        spawn_to_mongoose([this, conn, id, response](uint64_t) {
+            complete(conn, id, response);
+        });
+    });
+
+    if (!accepted) {
+        auto error = std::make_exception_ptr(explorer::jsonrpc_server_busy());
+        complete(&nc, id, std::make_shared<std::string>(rpc_response(*data, rpc_version, error, 503)));
+    }
+}
+
+// Account data is not safe to touch concurrently, only the commands reading
+// chain state run in parallel. Jobs share the serial lane.
+bool HttpServ::concurrent(const std::string& method)
+{
+    return method == "getjob" || explorer::readonly_extension(method);
+}
+
+RpcWorkers& HttpServ::lane(const std::string& method)
+{
+    return concurrent(method) ? workers_ : serial_;
+}
+
+void HttpServ::rpc_batch(mg_connection& nc, uint64_t id, HttpMessage& data, uint8_t rpc_version)
+{
+    const auto& calls = data.batch();
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(calls.size());
+    batch->notifications.resize(calls.size(), false);
+
+    // Read-only calls run one job each, the others run in order in one job.
+    std::vector<std::shared_ptr<HttpMessage>> readonly;
+    std::vector<std::pair<size_t, std::shared_ptr<HttpMessage>>> ordered;
+    std::vector<size_t> readonly_index;
+
+    for (Json::ArrayIndex i = 0; i < calls.size(); ++i) {
+        auto call = std::make_shared<HttpMessage>(data.get());
+        try {
+            call->json_to_arg(calls[i], rpc_version);
+        }
+        catch (...) {
+            batch->results[i] = jsonrpc_result(*call, rpc_version, std::current_exception());
+            continue;
         }
 
-        if (retcode == console_result::okay) {
-            if (rpc_version == 1) {
+        batch->notifications[i] = call->notification();
+
+        if (concurrent(call->jsonrpc_method())) {
+            readonly.push_back(call);
+            readonly_index.push_back(i);
+        } else {
+            ordered.push_back({ i, call });
+        }
+    }
+
+    // One extra count held while submitting, so the batch can not finish
+    // before every job is queued.
+    batch->remaining = readonly.size() + (ordered.empty() ? 0 : 1) + 1;
+
+    auto* conn = &nc;
+    const auto keep_alive = data.keep_alive();
+    const auto encoding = data.encoding();
+    auto done = [this, conn, id, batch, keep_alive, encoding]() {
+        if (--batch->remaining != 0)
+            return;
+
+        // Notifications are run but not answered.
+        Json::Value results(Json::arrayValue);
+        for (size_t i = 0; i < batch->results.size(); ++i) {
+            if (!batch->notifications[i])
+                results.append(batch->results[i]);
+        }
+
+        // A batch of notifications only is answered without a body.
+        auto response = std::make_shared<std::string>(http_response(200, keep_alive, encoding, [&results]() {
+            if (!results.empty())
+                writeJson(out_, results);
+        }));
+        spawn_to_mongoose([this, conn, id, response](uint64_t) {
+            complete(conn, id, response);
+        });
+    };
+
+    auto busy = [this, rpc_version, batch](HttpMessage& call, size_t index) {
+        auto error = std::make_exception_ptr(explorer::jsonrpc_server_busy());
+        batch->results[index] = jsonrpc_result(call, rpc_version, error);
+    };
+
+    for (size_t i = 0; i < readonly.size(); ++i) {
+        auto call = readonly[i];
+        const auto index = readonly_index[i];
+        const auto accepted = workers_.submit(call->jsonrpc_method(),
+            [this, call, index, rpc_version, batch, done]() {
+                batch->results[index] = jsonrpc_result(*call, rpc_version);
+                done();
+            });
+
+        if (!accepted) {
+            busy(*call, index);
+            done();
+        }
+    }
+
+    if (!ordered.empty()) {
+        const auto accepted = serial_.submit("batch",
+            [this, ordered, rpc_version, batch, done]() {
+                for (const auto& call : ordered)
+                    batch->results[call.first] = jsonrpc_result(*call.second, rpc_version);
+                done();
+            });
+
+        if (!accepted) {
+            for (const auto& call : ordered)
+                busy(*call.second, call.first);
+            done();
+        }
+    }
+
+    done();
+}
+
+void HttpServ::rpc_job(mg_connection& nc, uint64_t id, std::shared_ptr<HttpMessage> data, uint8_t rpc_version)
+{
+    const auto& command = data->jsonrpc_method();
+    const auto job = jobs_.submit(command, concurrent(command), [this, data, rpc_version]() {
+        return jsonrpc_result(*data, rpc_version);
+    });
+
+    if (job.empty()) {
+        auto error = std::make_exception_ptr(explorer::jsonrpc_server_busy());
+        complete(&nc, id, std::make_shared<std::string>(rpc_response(*data, rpc_version, error, 503)));
+        return;
+    }
+
+    // The result is fetched with getjob or pushed on the websocket job channel.
+    Json::Value root;
+    root["jsonrpc"] = "2.0";
+    root["id"] = data->jsonrpc_id();
+    root["result"]["job"] = job;
+    root["result"]["status"] = "queued";
+
+    complete(&nc, id, std::make_shared<std::string>(http_response(200,
+        data->keep_alive(), data->encoding(), [&root]() { writeJson(out_, root); })));
+}
+
+std::string HttpServ::rpc_response(HttpMessage& data, uint8_t rpc_version,
+    std::exception_ptr error, int status)
+{
+    return http_response(status, data.keep_alive(), data.encoding(), [&]() {
+        if (rpc_version != 1) {
+            const auto root = jsonrpc_result(data, rpc_version, error);
+            if (!root.isNull())
+                writeJson(out_, root);
+            return;
+        }
+
+        try {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+
+            Json::Value jv_output;
+
+            auto retcode = dispatch(data, rpc_version, jv_output);
+
+            if (retcode == console_result::failure) { // only orignal command
+                if (!jv_output.isObject() && !jv_output.isArray()) {
+                    throw explorer::command_params_exception{ jv_output.asString() };
+                }
+                throw explorer::command_params_exception{ jv_output.toStyledString() };
+            }
+
+            if (retcode == console_result::okay) {
                 if (jv_output.isObject() || jv_output.isArray())
-                    out_ << jv_output.toStyledString();
+                    writeJson(out_, jv_output, true);
                 else
                     out_ << jv_output.asString();
             }
-            else if (checkAPIVer(api20_ver_list, rpc_version)) {
-                Json::Value jv_root;
-                jv_root["jsonrpc"] = "2.0";
-                jv_root["id"] = data.jsonrpc_id();
-                jv_root["result"] = jv_output;
-
-                out_ << jv_root.toStyledString();
-            }
         }
-    }
-    catch (const libbitcoin::explorer::explorer_exception& e) {
-        if (rpc_version == 1) {
+        catch (const libbitcoin::explorer::explorer_exception& e) {
             out_ << e;
         }
-        else if (checkAPIVer(api20_ver_list, rpc_version)) {
-            Json::Value root;
-            root["jsonrpc"] = "2.0";
-            root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = (int32_t)e.code();
-            root["error"]["message"] = e.what();
-           
-            out_ << root.toStyledString();
-        }
-    }
-    catch (const std::exception& e) {
-        if (rpc_version == 1) {
+        catch (const std::exception& e) {
             libbitcoin::explorer::explorer_exception ex(1000, e.what());
             out_ << ex;
         }
-        else if (checkAPIVer(api20_ver_list, rpc_version)) {
-            Json::Value root;
+    });
+}
+
+Json::Value HttpServ::jsonrpc_result(HttpMessage& data, uint8_t rpc_version,
+    std::exception_ptr error)
+{
+    Json::Value root;
+
+    try {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        Json::Value jv_output;
+
+        auto retcode = dispatch(data, rpc_version, jv_output);
+
+        if (retcode == console_result::failure) { // only orignal command
+            throw explorer::command_params_exception{ jv_output.toStyledString() };
+        }
+
+        if (retcode == console_result::okay) {
             root["jsonrpc"] = "2.0";
             root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = 1000;
-            root["error"]["message"] = e.what();
-
-            out_ << root.toStyledString();
+            root["result"] = jv_output;
         }
     }
+    catch (const libbitcoin::explorer::explorer_exception& e) {
+        root["jsonrpc"] = "2.0";
+        root["id"] = data.jsonrpc_id();
+        root["error"]["code"] = (int32_t)e.code();
+        root["error"]["message"] = e.what();
+    }
+    catch (const std::exception& e) {
+        root["jsonrpc"] = "2.0";
+        root["id"] = data.jsonrpc_id();
+        root["error"]["code"] = 1000;
+        root["error"]["message"] = e.what();
+    }
+
+    return root;
+}
+
+console_result HttpServ::dispatch(HttpMessage& data, uint8_t rpc_version, Json::Value& jv_output)
+{
+    const auto& method = data.jsonrpc_method();
+    const auto& params = data.jsonrpc_params();
+
+    // Jobs are kept by this server, getjob is not an explorer command.
+    if (method == "getjob") {
+        if (params.size() != 1 || !params[0].isString())
+            throw explorer::command_params_exception{ "getjob takes the job id." };
+
+        jv_output = jobs_.get(params[0].asString());
+        if (jv_output.isNull())
+            throw explorer::command_params_exception{ "job not found or expired." };
+
+        return console_result::okay;
+    }
+
+    const auto key = cache_.key(method, params, rpc_version);
+
+    const auto cached = cache_.find(key);
+    if (cached) {
+        jv_output = *cached;
+        return console_result::okay;
+    }
+
+    // Commands with a json binder skip argv, only the others build it.
+    console_result retcode;
+    if (rpc_version == 1 || !explorer::dispatch_json_command(method, params,
+            jv_output, node_, rpc_version, retcode)) {
+        data.params_to_arg();
+        const auto argv = const_cast<const char**>(data.argv());
+        retcode = explorer::dispatch_command(data.argc(), argv, jv_output, node_, rpc_version);
+    }
+
+    if (retcode == console_result::okay)
+        cache_.store(key, jv_output);
+
+    return retcode;
+}
+
+std::string HttpServ::http_response(int status, bool keep_alive, Encoding encoding,
+    const std::function<void()>& write_body)
+{
+    const auto reason = status == 200 ? "OK" : "Service Unavailable";
+    const std::string headers = keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+
+    // Format into a private buffer, the connection may have other responses
+    // pending.
+    mbuf response;
+    mbuf_init(&response, 0);
+    StreamBuf buf{ response };
+    out_.rdbuf(&buf);
+    out_.reset(status, reason, "text/plain", "utf-8", headers.c_str());
+
+    write_body();
+
+    // Large bodies (blocks, transaction lists) are sent compressed to the
+    // clients accepting it.
+    std::string compressed;
+    if (compress_threshold_ != 0 && static_cast<size_t>(out_.bodySize()) >= compress_threshold_
+        && compress(encoding, out_.body(), out_.bodySize(), compressed)) {
+        const auto encoded = headers + "Content-Encoding: " + encodingName(encoding)
+            + "\r\nVary: Accept-Encoding\r\n";
+        out_.reset(status, reason, "text/plain", "utf-8", encoded.c_str());
+        out_.write(compressed.data(), compressed.size());
+    }
+
     out_.setContentLength();
+    out_.rdbuf(nullptr);
+
+    std::string result(response.buf, response.len);
+    mbuf_free(&response);
+    return result;
 }
 
-void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
+void HttpServ::ws_request(mg_connection& nc, std::shared_ptr<WebsocketMessage> ws)
+{
+    const auto id = enqueue(nc, true);
+
+    // The frame is only valid during this event, parse it here.
+    try {
+        ws->data_to_arg();
+    }
+    catch (...) {
+        auto error = std::current_exception();
+        complete(&nc, id, std::make_shared<std::string>(ws_response(*ws, error)));
+        return;
+    }
+
+    const std::string command = ws->argc() > 0 ? ws->argv()[0] : "";
+    auto* conn = &nc;
+
+    const auto accepted = lane(command).submit(command, [this, conn, id, ws]() {
+        auto response = std::make_shared<std::string>(ws_response(*ws));
+        spawn_to_mongoose([this, conn, id, response](uint64_t) {
+            complete(conn, id, response);
+        });
+    });
+
+    if (!accepted) {
+        auto error = std::make_exception_ptr(explorer::jsonrpc_server_busy());
+        complete(&nc, id, std::make_shared<std::string>(ws_response(*ws, error)));
+    }
+}
+
+std::string HttpServ::ws_response(WebsocketMessage& ws, std::exception_ptr error)
 {
     Json::Value jv_output;
 
     try{
-        ws.data_to_arg();
+        if (error) {
+            std::rethrow_exception(error);
+        }
 
         console_result retcode = explorer::dispatch_command(ws.argc(), const_cast<const char**>(ws.argv()), jv_output, node_);
         if (retcode != console_result::okay) {
@@ -148,18 +459,71 @@ void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
     }
 
     if (jv_output.isObject() || jv_output.isArray())
-        send_frame(nc, jv_output.toStyledString());
+        return toJson(jv_output);
     else
-        send_frame(nc, jv_output.asString());
+        return jv_output.asString();
+}
+
+uint64_t HttpServ::enqueue(mg_connection& nc, bool websocket, bool close)
+{
+    const auto id = ++request_id_;
+    pending_[&nc].push_back({ id, websocket, close, nullptr });
+    return id;
+}
+
+void HttpServ::complete(mg_connection* nc, uint64_t id, std::shared_ptr<std::string> response)
+{
+    // The connection closed while the command was running.
+    auto it = pending_.find(nc);
+    if (it == pending_.end())
+        return;
+
+    auto& list = it->second;
+    auto slot = std::find_if(list.begin(), list.end(),
+        [id](const Pending& pending) { return pending.id == id; });
+    if (slot == list.end())
+        return;
+
+    slot->response = response;
+
+    // Send every leading completed response, a slow command holds back the
+    // later ones of its connection.
+    while (!list.empty() && list.front().response) {
+        const auto& front = list.front();
+        if (front.websocket)
+            send_frame(*nc, *front.response);
+        else
+            send(*nc, *front.response, front.close);
+
+        // Requests pipelined after a closing one are not answered.
+        if (front.close)
+            list.clear();
+        else
+            list.pop_front();
+    }
+
+    if (list.empty())
+        pending_.erase(it);
 }
 
 bool HttpServ::start()
 {
     if (!attach_notify())
         return false;
+    workers_.start();
+    serial_.start();
+    jobs_.start();
     return base::start();
 }
 
+void HttpServ::stop()
+{
+    base::stop();
+    workers_.stop();
+    jobs_.stop();
+    serial_.stop();
+}
+
 void HttpServ::spawn_to_mongoose(const std::function<void(uint64_t)>&& handler)
 {
     auto msg = std::make_shared<MgEvent>(std::move(handler));
@@ -173,21 +537,51 @@ void HttpServ::run() {
 
     node_.subscribe_stop([this](const libbitcoin::code& ec) { stop(); });
 
+    node_.pool().subscribe_transaction(
+        std::bind(&HttpServ::handle_transaction_pool,
+            this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+
+    node_.chain().subscribe_reorganize(
+        std::bind(&HttpServ::handle_blockchain_reorganization,
+            this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+
     base::run();
 
     log::info(LOG_HTTP) << "Http Service Stopped.";
 }
 
+bool HttpServ::handle_transaction_pool(const code& ec, const index_list&, bc::message::transaction_message::ptr)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return false;
+
+    cache_.clear_pool();
+    return true;
+}
+
+bool HttpServ::handle_blockchain_reorganization(const code& ec, uint64_t, const block_list&, const block_list&)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return false;
+
+    cache_.clear();
+    return true;
+}
+
 void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
 {
+    // A request pipelined after one closing the connection.
+    if (nc.flags & MG_F_SEND_AND_CLOSE)
+        return;
+
     if ((mg_ncasecmp(msg.uri.p, "/rpc/v3", 7) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/v3/", 8) == 0)) {
-        rpc_request(nc, HttpMessage(&msg), 3); // v3 rpc
+        rpc_request(nc, std::make_shared<HttpMessage>(&msg), 3); // v3 rpc
     }
     else if ((mg_ncasecmp(msg.uri.p, "/rpc/v2", 7) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/v2/", 8) == 0)) {
-        rpc_request(nc, HttpMessage(&msg), 2); // v2 rpc
+        rpc_request(nc, std::make_shared<HttpMessage>(&msg), 2); // v2 rpc
     }
     else if ((mg_ncasecmp(msg.uri.p, "/rpc", 4) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/", 5) == 0)) {
-        rpc_request(nc, HttpMessage(&msg), 1); //v1 rpc
+        rpc_request(nc, std::make_shared<HttpMessage>(&msg), 1); //v1 rpc
     } else {
         std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection* ptr) { (void)(ptr); });
         serve_http_static(nc, msg);
@@ -215,7 +609,24 @@ void HttpServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message&
 {
     std::istringstream iss;
     iss.str(std::string((const char*)msg.data, msg.size));
-    ws_request(nc, WebsocketMessage(&msg));
+    ws_request(nc, std::make_shared<WebsocketMessage>(&msg));
+}
+
+void HttpServ::on_poll_handler(struct mg_connection& nc, time_t now)
+{
+    // Close keep-alive connections idle for too long, but not the ones
+    // waiting for their commands.
+    if (idle_timeout_ == 0 || nc.listener == nullptr || is_websocket(nc))
+        return;
+
+    if (now - nc.last_io_time >= idle_timeout_ && pending_.find(&nc) == pending_.end())
+        nc.flags |= MG_F_SEND_AND_CLOSE;
+}
+
+void HttpServ::on_close_handler(struct mg_connection& nc)
+{
+    // Responses of commands still running are dropped on completion.
+    pending_.erase(&nc);
 }
 
 }// mgbubble
@@ -24,6 +24,8 @@
 namespace mgbubble {
 using namespace std::placeholders;
 
+mg_event_handler_t MgServer::http_handler_ = nullptr;
+
 bool MgServer::start()
 {
     if (!nc_)
@@ -143,6 +145,10 @@ void MgServer::on_timer_handler(struct mg_connection& nc)
 {
 }
 
+void MgServer::on_poll_handler(struct mg_connection& nc, time_t now)
+{
+}
+
 void MgServer::on_close_handler(struct mg_connection& nc)
 {
 }
@@ -211,6 +217,10 @@ void MgServer::ev_handler(struct mg_connection *nc, int ev, void *ev_data)
         self->on_timer_handler(*nc);
         break;
     }
+    case MG_EV_POLL: {
+        self->on_poll_handler(*nc, *((time_t*)ev_data));
+        break;
+    }
     case MG_EV_CLOSE: {
         self->on_close_handler(*nc);
         break;
@@ -245,4 +255,23 @@ void MgServer::ev_notify_handler(struct mg_connection *nc, int ev, void *ev_data
     }
 }
 
+void MgServer::ev_http_pipeline(struct mg_connection *nc, int ev, void *ev_data)
+{
+    http_handler_(nc, ev, ev_data);
+    if (ev != MG_EV_RECV)
+        return;
+
+    // Stop once nothing is consumed, the next request is not fully buffered,
+    // or the connection switched to websocket or is closing.
+    size_t len = nc->recv_mbuf.len;
+    while (len > 0 && nc->proto_handler == ev_http_pipeline
+        && !(nc->flags & (MG_F_CLOSE_IMMEDIATELY | MG_F_SEND_AND_CLOSE))) {
+        int received = 0;
+        http_handler_(nc, MG_EV_RECV, &received);
+        if (nc->recv_mbuf.len == len)
+            break;
+        len = nc->recv_mbuf.len;
+    }
+}
+
 }
@@ -1,165 +1,229 @@
-/*
- * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
- * Copyright (C) 2013, 2016 Swirly Cloud Limited.
- *
- * This program is free software; you can redistribute it and/or modify it under the terms of the
- * GNU General Public License as published by the Free Software Foundation; either version 2 of the
- * License, or (at your option) any later version.
- *
- * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
- * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
- * General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License along with this program; if
- * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
- * 02110-1301, USA.
- */
-#include <cctype>
-#include <json/json.h>
-#include <metaverse/mgbubble/Mongoose.hpp>
-#include <metaverse/mgbubble/utility/Tokeniser.hpp>
-#include <metaverse/explorer/extensions/exception.hpp>
-
-namespace mgbubble {
-
-void HttpMessage::data_to_arg(uint8_t rpc_version) {
-
-    auto vargv_to_argv = [this]() {
-        // convert to char** argv
-        int i = 0;
-        for(auto& iter : this->vargv_){
-            if (i >= max_paramters){
-                break;
-            }
-            this->argv_[i++] = iter.c_str();
-        }
-        argc_ = i;
-    };
-    
-    Json::Reader reader;
-    Json::Value root;
-    const char* begin = body().data();
-    const char* end = body().data() + body().size();
-    if (!reader.parse(begin, end, root) || !root.isObject()) {
-        throw libbitcoin::explorer::jsonrpc_parse_error();
-    }
-
-    if (root["method"].isString()) {
-        vargv_.emplace_back(root["method"].asString());
-    }
-
-    if (root.isMember("params") && !root["params"].isArray()) {
-        throw libbitcoin::explorer::jsonrpc_invalid_params();
-    }
-
-    if (rpc_version == 1) {
-        /* ***************** /rpc **********************
-         * application/json
-         * {"method":"xxx", "params":["p1","p2"]}
-         * ******************************************/
-        for (auto& param : root["params"]) {
-            if (!param.isObject())
-                vargv_.emplace_back(param.asString());
-        }
-    } else {
-        /* ***************** /rpc/v2 **********************
-         * application/json
-         * {
-         *  "method":"xxx", 
-         *  "params":[
-         *      {
-         *          k1:v1,  ==> Command Option
-         *          k2:v2
-         *      },
-         *      "p1",  ==> Command Argument
-         *      "p2"
-         *      ]
-         *  }
-         * ******************************************/
-
-        if (root["jsonrpc"].asString() != "2.0") {
-            throw libbitcoin::explorer::jsonrpc_invalid_request();
-        }
-
-        if (root["id"].isString()) {
-            jsonrpc_id_ = std::stol(root["id"].asString());
-        } else {
-            jsonrpc_id_ = root["id"].asInt64();
-        }
-
-        // push options
-        for (auto& param : root["params"]) {
-            if (param.isObject()) {
-                for (auto& key : param.getMemberNames()) {
-                    if (!param[key].empty()) {
-
-                        if (!param[key].isArray()) {
-                            // --option
-                            vargv_.emplace_back("--" + key);
-                            // value
-                            vargv_.emplace_back(param[key].asString());
-                        } else  {
-                            for (auto& member : param[key]) {
-                                // --option
-                                vargv_.emplace_back("--" + key);
-                                // value
-                                vargv_.emplace_back(member.asString());
-                            }
-                        }
-
-                    } else {
-                        // --option
-                        vargv_.emplace_back("--" + key);
-                    }
-                }
-                break;
-            }
-        }
-
-        // push arguments at last
-        for (auto& param : root["params"]) {
-            if (!param.isObject()){
-                vargv_.emplace_back(param.asString());
-            }
-        }
-    }
-
-    vargv_to_argv();
-}
-
-void WebsocketMessage::data_to_arg(uint8_t api_version) {
-    Tokeniser<' '> args;
-    args.reset(+*impl_);
-
-    // store args from ws message
-    do {
-        //skip spaces
-        if (args.top().front() == ' '){
-            args.pop();
-            continue;
-        } else if (std::iscntrl(args.top().front())){
-            break;
-        } else {
-            this->vargv_.push_back({args.top().data(), args.top().size()});
-            args.pop();
-        }
-    }while(!args.empty());
-
-    // convert to char** argv
-    int i = 0;
-    for(auto& iter : vargv_){
-        if (i >= max_paramters){
-            break;
-        }
-        argv_[i++] = iter.c_str();
-    }
-    argc_ = i;
-}
-
-void ToCommandArg::add_arg(std::string&& outside)
-{
-    vargv_.push_back(outside); 
-    argc_++; 
-}
-
-} // mgbubble
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ * Copyright (C) 2013, 2016 Swirly Cloud Limited.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <algorithm>
+#include <cctype>
+#include <json/json.h>
+#include <metaverse/mgbubble/Mongoose.hpp>
+#include <metaverse/mgbubble/utility/Tokeniser.hpp>
+#include <metaverse/explorer/extensions/exception.hpp>
+
+namespace mgbubble {
+
+HttpMessage::HttpMessage(http_message* impl) noexcept
+    : impl_{impl}, jsonrpc_id_(-1)
+{
+    // HTTP/1.1 connections persist unless the client closes them, HTTP/1.0
+    // ones only when the client asks to.
+    const auto value = header("Connection");
+    std::string connection(value.data(), value.size());
+    std::transform(connection.begin(), connection.end(), connection.begin(), ::tolower);
+    if (proto() == "HTTP/1.0"_sv)
+        keep_alive_ = connection.find("keep-alive") != std::string::npos;
+    else
+        keep_alive_ = connection.find("close") == std::string::npos;
+
+    encoding_ = acceptEncoding(header("Accept-Encoding"));
+}
+
+void HttpMessage::data_to_arg(uint8_t rpc_version) {
+
+    Json::Reader reader;
+    Json::Value root;
+    const char* begin = body().data();
+    const char* end = body().data() + body().size();
+    if (!reader.parse(begin, end, root)) {
+        throw libbitcoin::explorer::jsonrpc_parse_error();
+    }
+
+    /* ***************** /rpc/v2 batch **********************
+     * application/json
+     * [{"jsonrpc":"2.0", "method":"xxx", ...}, {...}]
+     * every call is bound later on its own by json_to_arg
+     * ******************************************/
+    if (rpc_version != 1 && root.isArray()) {
+        if (root.empty()) {
+            throw libbitcoin::explorer::jsonrpc_invalid_request();
+        }
+        batch_ = std::move(root);
+        return;
+    }
+
+    if (!root.isObject()) {
+        throw libbitcoin::explorer::jsonrpc_parse_error();
+    }
+
+    json_to_arg(root, rpc_version);
+}
+
+void HttpMessage::json_to_arg(const Json::Value& root, uint8_t rpc_version) {
+
+    if (!root.isObject()) {
+        throw libbitcoin::explorer::jsonrpc_invalid_request();
+    }
+
+    rpc_version_ = rpc_version;
+
+    if (root["method"].isString()) {
+        jsonrpc_method_ = root["method"].asString();
+    }
+
+    if (root.isMember("params") && !root["params"].isArray()) {
+        throw libbitcoin::explorer::jsonrpc_invalid_params();
+    }
+
+    // kept for building argv on demand and for commands binding their
+    // params without argv
+    jsonrpc_params_ = root["params"];
+
+    if (rpc_version != 1) {
+        if (root["jsonrpc"].asString() != "2.0") {
+            throw libbitcoin::explorer::jsonrpc_invalid_request();
+        }
+
+        notification_ = !root.isMember("id");
+
+        if (root["id"].isString()) {
+            jsonrpc_id_ = std::stol(root["id"].asString());
+        } else {
+            jsonrpc_id_ = root["id"].asInt64();
+        }
+
+        // extension member, run the call as a background job
+        async_ = root["async"].isBool() && root["async"].asBool();
+    }
+}
+
+void HttpMessage::params_to_arg() {
+
+    // already built
+    if (!vargv_.empty()) {
+        return;
+    }
+
+    if (!jsonrpc_method_.empty()) {
+        vargv_.emplace_back(jsonrpc_method_);
+    }
+
+    if (rpc_version_ == 1) {
+        /* ***************** /rpc **********************
+         * application/json
+         * {"method":"xxx", "params":["p1","p2"]}
+         * ******************************************/
+        for (auto& param : jsonrpc_params_) {
+            if (!param.isObject())
+                vargv_.emplace_back(param.asString());
+        }
+    } else {
+        /* ***************** /rpc/v2 **********************
+         * application/json
+         * {
+         *  "method":"xxx", 
+         *  "params":[
+         *      {
+         *          k1:v1,  ==> Command Option
+         *          k2:v2
+         *      },
+         *      "p1",  ==> Command Argument
+         *      "p2"
+         *      ]
+         *  }
+         * ******************************************/
+
+        // push options
+        for (auto& param : jsonrpc_params_) {
+            if (param.isObject()) {
+                for (auto& key : param.getMemberNames()) {
+                    if (!param[key].empty()) {
+
+                        if (!param[key].isArray()) {
+                            // --option
+                            vargv_.emplace_back("--" + key);
+                            // value
+                            vargv_.emplace_back(param[key].asString());
+                        } else  {
+                            for (auto& member : param[key]) {
+                                // --option
+                                vargv_.emplace_back("--" + key);
+                                // value
+                                vargv_.emplace_back(member.asString());
+                            }
+                        }
+
+                    } else {
+                        // --option
+                        vargv_.emplace_back("--" + key);
+                    }
+                }
+                break;
+            }
+        }
+
+        // push arguments at last
+        for (auto& param : jsonrpc_params_) {
+            if (!param.isObject()){
+                vargv_.emplace_back(param.asString());
+            }
+        }
+    }
+
+    // convert to char** argv
+    int i = 0;
+    for(auto& iter : vargv_){
+        if (i >= max_paramters){
+            break;
+        }
+        argv_[i++] = iter.c_str();
+    }
+    argc_ = i;
+}
+
+void WebsocketMessage::data_to_arg(uint8_t api_version) {
+    Tokeniser<' '> args;
+    args.reset(+*impl_);
+
+    // store args from ws message
+    do {
+        //skip spaces
+        if (args.top().front() == ' '){
+            args.pop();
+            continue;
+        } else if (std::iscntrl(args.top().front())){
+            break;
+        } else {
+            this->vargv_.push_back({args.top().data(), args.top().size()});
+            args.pop();
+        }
+    }while(!args.empty());
+
+    // convert to char** argv
+    int i = 0;
+    for(auto& iter : vargv_){
+        if (i >= max_paramters){
+            break;
+        }
+        argv_[i++] = iter.c_str();
+    }
+    argc_ = i;
+}
+
+void ToCommandArg::add_arg(std::string&& outside)
+{
+    vargv_.push_back(outside); 
+    argc_++; 
+}
+
+} // mgbubble
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/RpcCache.hpp>
+
+#include <unordered_map>
+#include <metaverse/mgbubble/utility/Json_writer.hpp>
+
+namespace mgbubble {
+
+namespace {
+
+enum class Depends { chain, pool };
+
+// Commands whose result is a function of the chain (and of the pool).
+const std::unordered_map<std::string, Depends> cacheable_commands
+{
+    { "getblock", Depends::chain },
+    { "getblockheader", Depends::chain },
+    { "fetch-header", Depends::chain },
+    { "gettx", Depends::pool },
+    { "gettransaction", Depends::pool },
+    { "fetch-tx", Depends::pool },
+    { "getasset", Depends::pool },
+    { "listassets", Depends::pool }
+};
+
+// listassets of an account answers for that account only, the cache keeps
+// the public listing.
+bool account_call(const std::string& command, const Json::Value& params)
+{
+    if (command != "listassets")
+        return false;
+
+    for (const auto& param : params) {
+        if (!param.isObject())
+            return true;
+
+        for (const auto& name : param.getMemberNames()) {
+            if (name != "cert" && name != "c")
+                return true;
+        }
+    }
+    return false;
+}
+
+// Bookkeeping of an entry, counted on top of its key and rendered result.
+constexpr size_t entry_overhead = 128;
+
+} // anonymous
+
+RpcCache::RpcCache(size_t capacity)
+    : capacity_(capacity),
+      size_(0),
+      chain_generation_(0),
+      pool_generation_(0)
+{
+}
+
+RpcCache::Key RpcCache::key(const std::string& command, const Json::Value& params,
+    uint8_t api_version) const
+{
+    Key key{ {}, false, 0, 0 };
+    if (capacity_ == 0)
+        return key;
+
+    const auto it = cacheable_commands.find(command);
+    if (it == cacheable_commands.end() || account_call(command, params))
+        return key;
+
+    // The params are rendered compact, object members come sorted.
+    key.value.push_back(static_cast<char>('0' + api_version));
+    key.value.append(command);
+    key.value.push_back('\0');
+    key.value.append(toJson(params));
+    key.pool = it->second == Depends::pool;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    key.chain_generation = chain_generation_;
+    key.pool_generation = pool_generation_;
+    return key;
+}
+
+RpcCache::result_ptr RpcCache::find(const Key& key)
+{
+    if (key.empty())
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key.value);
+    if (it == entries_.end())
+        return nullptr;
+
+    used_.splice(used_.begin(), used_, it->second.used);
+    return it->second.result;
+}
+
+void RpcCache::store(const Key& key, const Json::Value& result)
+{
+    if (key.empty())
+        return;
+
+    // Rendered outside the lock, the size is only an estimate.
+    const auto size = toJson(result).size() + key.value.size() + entry_overhead;
+    if (size > capacity_ / 8)
+        return;
+
+    auto value = std::make_shared<const Json::Value>(result);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (key.chain_generation != chain_generation_
+        || (key.pool && key.pool_generation != pool_generation_))
+        return;
+
+    auto it = entries_.find(key.value);
+    if (it != entries_.end())
+        erase(it);
+
+    while (size_ + size > capacity_ && !used_.empty())
+        erase(entries_.find(used_.back()));
+
+    used_.push_front(key.value);
+    entries_.emplace(key.value, Entry{ value, size, key.pool, used_.begin() });
+    size_ += size;
+}
+
+void RpcCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++chain_generation_;
+    entries_.clear();
+    used_.clear();
+    size_ = 0;
+}
+
+void RpcCache::clear_pool()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++pool_generation_;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        auto next = std::next(it);
+        if (it->second.pool)
+            erase(it);
+        it = next;
+    }
+}
+
+// Called with the mutex held.
+void RpcCache::erase(std::unordered_map<std::string, Entry>::iterator it)
+{
+    size_ -= it->second.size;
+    used_.erase(it->second.used);
+    entries_.erase(it);
+}
+
+} // mgbubble
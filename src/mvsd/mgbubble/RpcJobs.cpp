@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/RpcJobs.hpp>
+
+#include <metaverse/bitcoin/formats/base_16.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+#include <metaverse/bitcoin/utility/random.hpp>
+
+namespace mgbubble {
+
+namespace {
+
+const char* status_name(int status)
+{
+    static const char* names[] = { "queued", "running", "done", "failed" };
+    return names[status];
+}
+
+// Not guessable, the result of a wallet call is only for its caller.
+std::string new_job_id()
+{
+    bc::data_chunk id(16);
+    bc::pseudo_random_fill(id);
+    return bc::encode_base16(id);
+}
+
+} // anonymous
+
+RpcJobs::RpcJobs(RpcWorkers& serial, size_t threads, size_t queue_limit,
+    size_t command_limit, size_t retention)
+    : workers_(threads, queue_limit, command_limit),
+      serial_(serial),
+      retention_(retention)
+{
+}
+
+void RpcJobs::start()
+{
+    workers_.start();
+}
+
+void RpcJobs::stop()
+{
+    workers_.stop();
+}
+
+void RpcJobs::set_listener(Listener&& listener)
+{
+    listener_ = std::move(listener);
+}
+
+std::string RpcJobs::submit(const std::string& command, bool concurrent,
+    Work&& work)
+{
+    const auto id = new_job_id();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_[id] = { command, Status::queued, Json::Value() };
+    }
+
+    auto call = std::make_shared<Work>(std::move(work));
+    auto& lane = concurrent ? workers_ : serial_;
+    const auto accepted = lane.submit(command, [this, id, call]() {
+        update(id, Status::running);
+
+        auto response = (*call)();
+        const auto status = response.isMember("error") ? Status::failed : Status::done;
+        update(id, status, std::move(response));
+    });
+
+    if (!accepted) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.erase(id);
+        return {};
+    }
+
+    return id;
+}
+
+Json::Value RpcJobs::get(const std::string& id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = jobs_.find(id);
+    if (it == jobs_.end())
+        return Json::Value();
+
+    return to_json(id, it->second);
+}
+
+Json::Value RpcJobs::to_json(const std::string& id, const Job& job)
+{
+    Json::Value root;
+    root["job"] = id;
+    root["command"] = job.command;
+    root["status"] = status_name(static_cast<int>(job.status));
+
+    if (job.response.isMember("result"))
+        root["result"] = job.response["result"];
+    if (job.response.isMember("error"))
+        root["error"] = job.response["error"];
+
+    return root;
+}
+
+void RpcJobs::update(const std::string& id, Status status, Json::Value&& response)
+{
+    Json::Value state;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& job = jobs_[id];
+        job.status = status;
+        job.response = std::move(response);
+        state = to_json(id, job);
+
+        if (status == Status::done || status == Status::failed) {
+            finished_.push_back(id);
+            while (finished_.size() > retention_) {
+                jobs_.erase(finished_.front());
+                finished_.pop_front();
+            }
+        }
+    }
+
+    if (listener_)
+        listener_(state);
+}
+
+} // mgbubble
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/RpcWorkers.hpp>
+
+namespace mgbubble {
+
+RpcWorkers::RpcWorkers(size_t threads, size_t queue_limit, size_t command_limit)
+    : threads_(threads == 0 ? 1 : threads),
+      queue_limit_(queue_limit),
+      command_limit_(command_limit == 0 ? threads_ : command_limit),
+      queued_(0),
+      stopped_(true)
+{
+}
+
+void RpcWorkers::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopped_)
+        return;
+
+    stopped_ = false;
+    pool_.spawn(threads_);
+}
+
+void RpcWorkers::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+            return;
+
+        stopped_ = true;
+    }
+
+    // Running commands finish, waiting ones are abandoned.
+    pool_.shutdown();
+    pool_.join();
+}
+
+bool RpcWorkers::submit(const std::string& command, Job&& job)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_ || queued_ >= queue_limit_)
+        return false;
+
+    ++queued_;
+    auto& state = commands_[command];
+    if (state.running < command_limit_) {
+        ++state.running;
+        post(command, std::move(job));
+    } else {
+        state.waiting.push_back(std::move(job));
+    }
+    return true;
+}
+
+// Called with the mutex held.
+void RpcWorkers::post(const std::string& command, Job&& job)
+{
+    pool_.service().post([this, command, job]() { run(command, job); });
+}
+
+void RpcWorkers::run(const std::string& command, const Job& job)
+{
+    try {
+        job();
+    } catch (...) {
+        // A job reports its own failure, the slot must still be released.
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    --queued_;
+
+    auto it = commands_.find(command);
+    auto& state = it->second;
+
+    // The slot passes to the next waiting job of the same command.
+    if (!state.waiting.empty() && !stopped_) {
+        auto next = std::move(state.waiting.front());
+        state.waiting.pop_front();
+        post(command, std::move(next));
+        return;
+    }
+
+    if (--state.running == 0) {
+        queued_ -= state.waiting.size();
+        commands_.erase(it);
+    }
+}
+
+} // mgbubble
@@ -19,6 +19,7 @@
 #include <sstream>
 #include <metaverse/explorer/json_helper.hpp>
 #include <metaverse/mgbubble/WsPushServ.hpp>
+#include <metaverse/mgbubble/utility/Json_writer.hpp>
 #include <metaverse/server/server_node.hpp>
 
 namespace mgbubble {
@@ -35,6 +36,7 @@ namespace mgbubble {
 
     constexpr auto CH_BLOCK       = "block";
     constexpr auto CH_TRANSACTION = "tx";
+    constexpr auto CH_JOB         = "job";
 }
 namespace mgbubble {
 using namespace bc;
@@ -125,38 +127,28 @@ void WsPushServ::notify_block(uint32_t height, const block::ptr block)
     if (stopped())
         return;
 
-    const auto block_hash = block->header.hash();
-
+    // One dispatch to mongoose for the whole block.
+    frame_list frames;
     for (const auto& tx : block->transactions)
-    {
-        const auto tx_hash = tx.hash();
+        append_transaction(height, tx, frames);
 
-        notify_transaction(height, block_hash, tx);
-    }
+    send_frames(std::move(frames));
 }
 
 void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_hash, const transaction& tx)
 {
-    if (stopped() || tx.outputs.empty())
+    if (stopped())
         return;
 
-    std::map<std::weak_ptr<mg_connection>, std::vector<size_t>, std::owner_less<std::weak_ptr<mg_connection>>> subscribers;
-    {
-        std::lock_guard<std::mutex> guard(subscribers_lock_);
-        if (subscribers_.size() == 0)
-            return;
-        for (auto& con : subscribers_)
-        {
-            if (!con.first.expired())
-            {
-                subscribers.insert(con);
-            }
-        }
-        if (subscribers.size() != subscribers_.size())
-            subscribers_ = subscribers;
-    }
+    frame_list frames;
+    append_transaction(height, tx, frames);
+    send_frames(std::move(frames));
+}
 
-    /* ---------- may has subscribers ---------- */
+void WsPushServ::append_transaction(uint32_t height, const transaction& tx, frame_list& frames)
+{
+    if (tx.outputs.empty())
+        return;
 
     std::vector<size_t> tx_addrs;
     for (const auto& input : tx.inputs)
@@ -174,49 +166,81 @@ void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_ha
     }
 
     std::vector<std::weak_ptr<mg_connection>> notify_cons;
-    for (auto& sub : subscribers)
     {
-        auto& sub_addrs = sub.second;
-        bool bnotify = sub_addrs.size() == 0 ? true : std::any_of(sub_addrs.begin(), sub_addrs.end(), [&tx_addrs](size_t addr_hash) {
-            return tx_addrs.end() != std::find(tx_addrs.begin(), tx_addrs.end(), addr_hash);
-        });
-
-        if (bnotify)
-            notify_cons.push_back(sub.first);
+        std::lock_guard<std::mutex> guard(subscribers_lock_);
+        notify_cons = subscriptions_.match(tx_addrs);
     }
-    if (notify_cons.size() == 0)
+
+    if (notify_cons.empty())
         return;
 
     log::info(NAME) << " ******** notify_transaction: height [" << height << "]  ******** ";
 
+    // Serialized once for every subscriber.
     Json::Value root;
     root["event"] = EV_PUBLISH;
     root["channel"] = CH_TRANSACTION;
     root["result"] = explorer::config::json_helper().prop_list(tx, height, true);
 
-    auto rep = std::make_shared<std::string>(root.toStyledString());
+    auto rep = std::make_shared<std::string>(toJson(root));
 
     for (auto& con : notify_cons)
+        frames.emplace_back(con, rep);
+}
+
+void WsPushServ::send_frames(frame_list&& frames)
+{
+    if (frames.empty())
+        return;
+
+    auto batch = std::make_shared<frame_list>(std::move(frames));
+    spawn_to_mongoose([this, batch](uint64_t id) {
+        for (auto& frame : *batch)
+        {
+            // Closed connections have been dropped from map_connections_.
+            auto con = frame.first.lock();
+            if (con)
+                send_frame(*con, *frame.second);
+        }
+    });
+}
+
+void WsPushServ::notify_job(const Json::Value& job)
+{
+    if (stopped())
+        return;
+
+    const auto id = job["job"].asString();
+    const auto status = job["status"].asString();
+    const auto finished = status == "done" || status == "failed";
+
+    std::vector<std::weak_ptr<mg_connection>> notify_cons;
     {
-        auto shared_con = con.lock();
-        if (!shared_con)
-            continue;
-
-        spawn_to_mongoose([this, shared_con, rep](uint64_t id) {
-            size_t active_connections = 0;
-            auto* mgr = &this->mg_mgr();
-            auto* notify_nc = shared_con.get();
-            for (auto* nc = mg_next(mgr, NULL); nc != NULL; nc = mg_next(mgr, nc)) {
-                if (!is_websocket(*nc) || is_listen_socket(*nc) || is_notify_socket(*nc))
-                    continue;
-                ++active_connections;
-                if (notify_nc == nc)
-                    send_frame(*nc, *rep);
-            }
-            if (active_connections != map_connections_.size())
-                refresh_connections();
-        });
+        std::lock_guard<std::mutex> guard(subscribers_lock_);
+        auto it = job_subscribers_.find(id);
+        if (it == job_subscribers_.end())
+            return;
+
+        for (const auto& sub : it->second)
+            notify_cons.push_back(sub.second);
+
+        // Nothing follows a finished job.
+        if (finished)
+            job_subscribers_.erase(it);
     }
+
+    Json::Value root;
+    root["event"] = EV_PUBLISH;
+    root["channel"] = CH_JOB;
+    root["result"] = job;
+
+    auto rep = std::make_shared<std::string>(toJson(root));
+
+    frame_list frames;
+    for (auto& con : notify_cons)
+        frames.emplace_back(con, rep);
+
+    send_frames(std::move(frames));
 }
 
 void WsPushServ::send_bad_response(struct mg_connection& nc, const char* message, int code, Json::Value data)
@@ -230,7 +254,7 @@ void WsPushServ::send_bad_response(struct mg_connection& nc, const char* message
     root["event"]  = EV_MG_ERROR;
     root["result"] = result;
     
-    auto&& tmp = root.toStyledString();
+    auto&& tmp = toJson(root);
     send_frame(nc, tmp.c_str(), tmp.size());
 }
 
@@ -240,23 +264,10 @@ void WsPushServ::send_response(struct mg_connection& nc, const std::string& even
     root["event"] = event;
     root["channel"] = channel;
 
-    auto&& tmp = root.toStyledString();
+    auto&& tmp = toJson(root);
     send_frame(nc, tmp.c_str(), tmp.size());
 }
 
-void WsPushServ::refresh_connections()
-{
-    auto* mgr = &mg_mgr();
-    std::unordered_map<void*, std::shared_ptr<mg_connection>> swap;
-    for (auto* nc = mg_next(mgr, NULL); nc != NULL; nc = mg_next(mgr, nc)) {
-        if (!is_websocket(*nc) || is_listen_socket(*nc) || is_notify_socket(*nc))
-            continue;
-        std::shared_ptr<struct mg_connection> con(nc, [](struct mg_connection* ptr) { (void)(ptr); });
-        swap.emplace(&nc, con);
-    }
-    map_connections_.swap(swap);
-}
-
 void WsPushServ::on_ws_handshake_done_handler(struct mg_connection& nc)
 {
     std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection* ptr) { (void)(ptr); });
@@ -272,7 +283,7 @@ void WsPushServ::on_ws_handshake_done_handler(struct mg_connection& nc)
     root["event"] = EV_INFO;
     root["result"] = connections;
 
-    auto&& tmp = root.toStyledString();
+    auto&& tmp = toJson(root);
     send_frame(nc, tmp);
 }
 
@@ -288,7 +299,8 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
         const char* begin = (const char*)msg.data;
         const char* end = begin + msg.size;
         if (!reader.parse(begin, end, root) || !root.isObject() 
-            || !root["event"].isString() || !root["channel"].isString() || !root["address"].isString()) {
+            || !root["event"].isString() || !root["channel"].isString()
+            || (root["channel"].asString() == CH_JOB ? !root["job"].isString() : !root["address"].isString())) {
             stringstream ss;
             ss << "parse request error, "
                 << reader.getFormattedErrorMessages();
@@ -309,30 +321,11 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                 auto it = map_connections_.find(&nc);
                 if (it != map_connections_.end()) {
                     std::lock_guard<std::mutex> guard(subscribers_lock_);
-                    std::weak_ptr<struct mg_connection> week_con(it->second);
-                    auto sub_it = subscribers_.find(week_con);
-                    if (sub_it != subscribers_.end()) {
-                        auto& sub_list = sub_it->second;
-                        if (hash_addr == 0) {
-                            sub_list.clear();
-                            send_response(nc, EV_SUBSCRIBED, channel);
-                        }
-                        else {
-                            if (sub_list.end() == std::find(sub_list.begin(), sub_list.end(), hash_addr)) {
-                                sub_list.push_back(hash_addr);
-                                send_response(nc, EV_SUBSCRIBED, channel);
-                            }
-                            else {
-                                send_bad_response(nc, "address already subscribed.");
-                            }
-                        }
+                    if (subscriptions_.subscribe(&nc, it->second, hash_addr)) {
+                        send_response(nc, EV_SUBSCRIBED, channel);
                     }
                     else {
-                        if (hash_addr == 0)
-                            subscribers_.insert({ week_con, {} });
-                        else
-                            subscribers_.insert({ week_con, { hash_addr } });
-                        send_response(nc, EV_SUBSCRIBED, channel);
+                        send_bad_response(nc, "address already subscribed.");
                     }
                 }
                 else {
@@ -340,12 +333,36 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                 }
             }
         }
+        else if ((event == EV_SUBSCRIBE) && (channel == CH_JOB)) {
+            // Job ids are only known to their callers, a job finished before
+            // this is fetched with getjob.
+            auto it = map_connections_.find(&nc);
+            if (it != map_connections_.end()) {
+                std::lock_guard<std::mutex> guard(subscribers_lock_);
+                job_subscribers_[root["job"].asString()].emplace(&nc, it->second);
+                send_response(nc, EV_SUBSCRIBED, channel);
+            }
+            else {
+                send_bad_response(nc, "connection lost.");
+            }
+        }
+        else if ((event == EV_UNSUBSCRIBE) && (channel == CH_JOB)) {
+            std::lock_guard<std::mutex> guard(subscribers_lock_);
+            auto it = job_subscribers_.find(root["job"].asString());
+            if (it != job_subscribers_.end() && it->second.erase(&nc)) {
+                if (it->second.empty())
+                    job_subscribers_.erase(it);
+                send_response(nc, EV_UNSUBSCRIBED, channel);
+            }
+            else {
+                send_bad_response(nc, "no subscription.");
+            }
+        }
         else if ((event == EV_UNSUBSCRIBE) && (channel == CH_TRANSACTION)) {
             auto it = map_connections_.find(&nc);
             if (it != map_connections_.end()) {
                 std::lock_guard<std::mutex> guard(subscribers_lock_);
-                std::weak_ptr<struct mg_connection> week_con(it->second);
-                subscribers_.erase(week_con);
+                subscriptions_.unsubscribe(&nc);
                 send_response(nc, EV_UNSUBSCRIBED, channel);
             }
             else {
@@ -362,11 +379,27 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
     }
 }
 
+void WsPushServ::unsubscribe_jobs(mg_connection* nc)
+{
+    for (auto it = job_subscribers_.begin(); it != job_subscribers_.end();)
+    {
+        it->second.erase(nc);
+        if (it->second.empty())
+            it = job_subscribers_.erase(it);
+        else
+            ++it;
+    }
+}
+
 void WsPushServ::on_close_handler(struct mg_connection& nc)
 {
     if (is_websocket(nc))
     {
         map_connections_.erase(&nc);
+
+        std::lock_guard<std::mutex> guard(subscribers_lock_);
+        subscriptions_.unsubscribe(&nc);
+        unsubscribe_jobs(&nc);
     }
 }
 
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/WsSubscriptions.hpp>
+
+namespace mgbubble {
+
+bool WsSubscriptions::subscribe(mg_connection* nc,
+    const connection_ptr& connection, size_t address_hash)
+{
+    auto it = subscribers_.find(nc);
+    if (it == subscribers_.end())
+        it = subscribers_.insert({ nc, { connection, {} } }).first;
+
+    auto& addresses = it->second.addresses;
+    if (address_hash == 0) {
+        drop_addresses(nc, it->second);
+        all_subscribers_.insert(nc);
+        return true;
+    }
+
+    if (!addresses.insert(address_hash).second)
+        return false;
+
+    all_subscribers_.erase(nc);
+    address_subscribers_[address_hash].insert(nc);
+    return true;
+}
+
+void WsSubscriptions::unsubscribe(mg_connection* nc)
+{
+    auto it = subscribers_.find(nc);
+    if (it == subscribers_.end())
+        return;
+
+    drop_addresses(nc, it->second);
+    all_subscribers_.erase(nc);
+    subscribers_.erase(it);
+}
+
+std::vector<WsSubscriptions::connection_ptr> WsSubscriptions::match(
+    const std::vector<size_t>& address_hashes) const
+{
+    std::vector<connection_ptr> connections;
+    if (subscribers_.empty())
+        return connections;
+
+    std::unordered_set<mg_connection*> matched(all_subscribers_);
+    for (const auto address_hash : address_hashes) {
+        auto it = address_subscribers_.find(address_hash);
+        if (it != address_subscribers_.end())
+            matched.insert(it->second.begin(), it->second.end());
+    }
+
+    for (auto* nc : matched)
+        connections.push_back(subscribers_.at(nc).connection);
+
+    return connections;
+}
+
+void WsSubscriptions::drop_addresses(mg_connection* nc, Subscriber& subscriber)
+{
+    for (const auto address_hash : subscriber.addresses) {
+        auto it = address_subscribers_.find(address_hash);
+        it->second.erase(nc);
+        if (it->second.empty())
+            address_subscribers_.erase(it);
+    }
+
+    subscriber.addresses.clear();
+}
+
+} // mgbubble
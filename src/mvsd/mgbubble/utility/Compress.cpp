@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/utility/Compress.hpp>
+
+#include <cctype>
+#include <cstdlib>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace mgbubble {
+
+namespace {
+
+string_view trim(string_view sv) noexcept
+{
+    while (!sv.empty() && std::isspace(static_cast<unsigned char>(sv.front())))
+        sv.remove_prefix(1);
+    while (!sv.empty() && std::isspace(static_cast<unsigned char>(sv.back())))
+        sv.remove_suffix(1);
+    return sv;
+}
+
+bool iequals(string_view lhs, string_view rhs) noexcept
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(lhs[i]))
+            != std::tolower(static_cast<unsigned char>(rhs[i])))
+            return false;
+    }
+    return true;
+}
+
+// A coding listed with "q=0" is refused by the client.
+bool refused(string_view params) noexcept
+{
+    while (!params.empty()) {
+        const auto next = params.find(';');
+        const auto param = trim(params.substr(0, next));
+        if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+            const std::string value(param.data() + 2, param.size() - 2);
+            return std::strtod(value.c_str(), nullptr) <= 0.0;
+        }
+        if (next == string_view::npos)
+            break;
+        params.remove_prefix(next + 1);
+    }
+    return false;
+}
+
+} // anonymous
+
+Encoding acceptEncoding(string_view header) noexcept
+{
+#ifdef USE_ZLIB
+    bool gzip = false, deflate = false;
+
+    while (!header.empty()) {
+        const auto next = header.find(',');
+        auto coding = header.substr(0, next);
+        const auto params = coding.find(';');
+        const auto name = trim(coding.substr(0, params));
+
+        if (params == string_view::npos || !refused(coding.substr(params + 1))) {
+            if (iequals(name, "gzip") || iequals(name, "x-gzip") || name == "*")
+                gzip = true;
+            else if (iequals(name, "deflate"))
+                deflate = true;
+        }
+
+        if (next == string_view::npos)
+            break;
+        header.remove_prefix(next + 1);
+    }
+
+    if (gzip)
+        return Encoding::gzip;
+    if (deflate)
+        return Encoding::deflate;
+#endif
+    return Encoding::identity;
+}
+
+const char* encodingName(Encoding encoding) noexcept
+{
+    switch (encoding) {
+    case Encoding::gzip:
+        return "gzip";
+    case Encoding::deflate:
+        return "deflate";
+    default:
+        return "identity";
+    }
+}
+
+bool compress(Encoding encoding, const char* data, size_t size, std::string& out)
+{
+#ifdef USE_ZLIB
+    if (encoding == Encoding::identity)
+        return false;
+
+    // Window bits above 15 select the gzip wrapper, deflate is the zlib format.
+    const int window_bits = encoding == Encoding::gzip ? 15 + 16 : 15;
+
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8,
+            Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    out.resize(deflateBound(&zs, size) + 18);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs.avail_in = static_cast<uInt>(size);
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+
+    const auto result = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+
+    // Not worth the client's work when nothing is saved.
+    return result == Z_STREAM_END && out.size() < size;
+#else
+    (void)encoding; (void)data; (void)size; (void)out;
+    return false;
+#endif
+}
+
+} // mgbubble
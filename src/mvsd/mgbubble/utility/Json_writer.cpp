@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/utility/Json_writer.hpp>
+
+#include <iomanip>
+#include <sstream>
+#include <json/minijson_writer.hpp>
+
+namespace mgbubble {
+
+namespace {
+
+// Walks the value tree, minijson does the quoting and the layout.
+struct ValueWriter {
+    void operator()(std::ostream& os, const Json::Value& value,
+        const minijson::writer_configuration& config) const
+    {
+        switch (value.type()) {
+        case Json::nullValue:
+            minijson::default_value_writer<minijson::null_t>()(os, minijson::null);
+            break;
+        case Json::intValue:
+            minijson::default_value_writer<Json::Int64>()(os, value.asInt64());
+            break;
+        case Json::uintValue:
+            minijson::default_value_writer<Json::UInt64>()(os, value.asUInt64());
+            break;
+        case Json::realValue: {
+            // Same precision as jsoncpp, the stream default would round.
+            const auto precision = os.precision(17);
+            minijson::default_value_writer<double>()(os, value.asDouble());
+            os.precision(precision);
+            break;
+        }
+        case Json::stringValue:
+            minijson::default_value_writer<std::string>()(os, value.asString());
+            break;
+        case Json::booleanValue:
+            minijson::default_value_writer<bool>()(os, value.asBool());
+            break;
+        case Json::arrayValue: {
+            minijson::array_writer writer(os, config);
+            for (const auto& item : value)
+                writer.write(item, *this);
+            writer.close();
+            break;
+        }
+        case Json::objectValue: {
+            minijson::object_writer writer(os, config);
+            for (auto it = value.begin(); it != value.end(); ++it)
+                writer.write(it.key().asCString(), *it, *this);
+            writer.close();
+            break;
+        }
+        }
+    }
+};
+
+} // anonymous
+
+void writeJson(std::ostream& os, const Json::Value& value, bool pretty)
+{
+    const auto config = minijson::writer_configuration().pretty_printing(pretty);
+    ValueWriter()(os, value, config);
+}
+
+std::string toJson(const Json::Value& value, bool pretty)
+{
+    std::ostringstream os;
+    writeJson(os, value, pretty);
+    return os.str();
+}
+
+} // mgbubble
@@ -73,7 +73,8 @@ OStream::OStream() : ostream{nullptr}
 
 OStream::~OStream() noexcept = default;
 
-void OStream::reset(int status, const char* reason,const char *content_type,const char *charset) noexcept
+void OStream::reset(int status, const char* reason,const char *content_type,const char *charset,
+    const char* headers) noexcept
 {
   rdbuf()->reset();
   mgbubble::reset(*this);
@@ -81,7 +82,7 @@ void OStream::reset(int status, const char* reason,const char *content_type,cons
   // Status-Line = HTTP-Version SP Status-Code SP Reason-Phrase CRLF. Use 10 space place-holder for
   // content length. RFC2616 states that field value MAY be preceded by any amount of LWS, though a
   // single SP is preferred.
-  *this << "HTTP/1.1 " << status << ' ' << reason << "\r\nContent-Type: "<< content_type<<";charset="<<charset<<"\r\nContent-Length:           \r\n\r\n";
+  *this << "HTTP/1.1 " << status << ' ' << reason << "\r\nContent-Type: "<< content_type<<";charset="<<charset<<"\r\n"<<headers<<"Content-Length:           \r\n\r\n";
   headSize_ = size();
   lengthAt_ = headSize_ - 4;
 }
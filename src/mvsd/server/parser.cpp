@@ -315,11 +315,26 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.transaction_pool_consistency),
         "Enforce consistency between the pool and the blockchain, defaults to false."
     )
+    (
+        "blockchain.script_cache_capacity",
+        value<uint32_t>(&configured.chain.script_cache_capacity),
+        "The maximum number of verified input scripts to cache, defaults to 100000."
+    )
     (
         "blockchain.use_testnet_rules",
         value<bool>(&configured.chain.use_testnet_rules),
         "Use testnet rules for determination of work required, defaults to false."
     )
+    (
+        "blockchain.dag_threads",
+        value<uint32_t>(&configured.chain.dag_threads),
+        "The number of threads generating the ethash DAG, defaults to 0 (all cores)."
+    )
+    (
+        "blockchain.dag_pregenerate",
+        value<bool>(&configured.chain.dag_pregenerate),
+        "Generate the DAG of the next epoch in the background while mining, defaults to false."
+    )
     (
         "blockchain.checkpoint",
         value<config::checkpoint::list>(&configured.chain.checkpoints),
@@ -354,6 +369,46 @@ options_metadata parser::load_settings()
         value<std::string>(&configured.server.mongoose_listen),
         "The listening port for mongoose(Json-RPC), defaults to 127.0.0.1:8820."
     )
+    (
+        "server.rpc_workers",
+        value<uint16_t>(&configured.server.rpc_workers),
+        "The number of threads executing read-only Json-RPC commands, the others run one at a time, defaults to 4."
+    )
+    (
+        "server.rpc_queue_limit",
+        value<uint32_t>(&configured.server.rpc_queue_limit),
+        "The maximum number of queued Json-RPC commands before answering 503, defaults to 256."
+    )
+    (
+        "server.rpc_command_concurrency",
+        value<uint16_t>(&configured.server.rpc_command_concurrency),
+        "The maximum number of threads running the same Json-RPC command, 0 for no limit, defaults to 2."
+    )
+    (
+        "server.rpc_idle_timeout_seconds",
+        value<uint32_t>(&configured.server.rpc_idle_timeout_seconds),
+        "The time an idle keep-alive Json-RPC connection is kept open, 0 for no limit, defaults to 30."
+    )
+    (
+        "server.rpc_compress_threshold",
+        value<uint32_t>(&configured.server.rpc_compress_threshold),
+        "The minimum Json-RPC response size compressed for clients accepting gzip or deflate, 0 to disable, defaults to 8192."
+    )
+    (
+        "server.rpc_cache_megabytes",
+        value<uint32_t>(&configured.server.rpc_cache_megabytes),
+        "The memory used to cache block, transaction and asset query results, 0 to disable, defaults to 64."
+    )
+    (
+        "server.rpc_job_workers",
+        value<uint16_t>(&configured.server.rpc_job_workers),
+        "The number of threads running read-only Json-RPC calls submitted as background jobs, defaults to 2."
+    )
+    (
+        "server.rpc_job_retention",
+        value<uint32_t>(&configured.server.rpc_job_retention),
+        "The number of finished background jobs kept for getjob, defaults to 1024."
+    )
     (
         "server.websocket_listen",
         value<std::string>(&configured.server.websocket_listen),
@@ -362,7 +417,7 @@ options_metadata parser::load_settings()
     (
         "server.query_workers",
         value<uint16_t>(&configured.server.query_workers),
-        "The number of query worker threads per endpoint, defaults to 1."
+        "The number of query worker threads per endpoint, defaults to 4."
     )
     (
         "server.heartbeat_interval_seconds",
@@ -91,6 +91,12 @@ void server_node::run(result_handler handler)
         return;
     }
 
+    // Background job states are pushed on the websocket job channel.
+    auto push_server = push_server_;
+    rest_server_->jobs().set_listener([push_server](const Json::Value& job) {
+        push_server->notify_job(job);
+    });
+
     if (!rest_server_->start() || !push_server_->start())
     {
         log::error(LOG_SERVER) << "Http/Websocket server can not start.";
@@ -135,6 +141,9 @@ void server_node::handle_running(const code& ec, result_handler handler)
 
 bool server_node::stop()
 {
+    if (!stopped())
+        query_statistics_.log_summary();
+
     // Suspend new work last so we can use work to clear subscribers.
     return authenticator_.stop() && p2p_node::stop();
 }
@@ -152,6 +161,11 @@ consensus::miner& server_node::miner()
 	return miner_;
 }
 
+server::query_statistics& server_node::query_statistics()
+{
+    return query_statistics_;
+}
+
 // Notification.
 // ----------------------------------------------------------------------------
 
@@ -27,11 +27,19 @@ namespace server {
 using namespace asio;
 
 settings::settings()
-  : query_workers(1),
+  : query_workers(4),
     heartbeat_interval_seconds(5),
     subscription_expiration_minutes(10),
     subscription_limit(100000000),
     mongoose_listen("127.0.0.1:8820"),
+    rpc_workers(4),
+    rpc_queue_limit(256),
+    rpc_command_concurrency(2),
+    rpc_idle_timeout_seconds(30),
+    rpc_compress_threshold(8192),
+    rpc_cache_megabytes(64),
+    rpc_job_workers(2),
+    rpc_job_retention(1024),
     websocket_listen("127.0.0.1:8821"),
     administrator_required(false),
     log_level("DEBUG"),
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/server/utility/query_statistics.hpp>
+
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/define.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+// The last slot counts the commands of no known interface.
+static const std::array<std::string, 4> interfaces
+{
+    { "address", "blockchain", "transaction_pool", "protocol" }
+};
+
+query_statistics::query_statistics()
+{
+    for (auto& counter: counters_)
+    {
+        counter.queries = 0;
+        counter.total_microseconds = 0;
+        counter.max_microseconds = 0;
+    }
+}
+
+size_t query_statistics::index(const std::string& command)
+{
+    const auto interface = command.substr(0, command.find('.'));
+
+    for (size_t index = 0; index < interfaces.size(); ++index)
+        if (interfaces[index] == interface)
+            return index;
+
+    return interfaces.size();
+}
+
+void query_statistics::record(const std::string& command,
+    uint64_t microseconds)
+{
+    auto& counter = counters_[index(command)];
+    ++counter.queries;
+    counter.total_microseconds += microseconds;
+
+    auto max = counter.max_microseconds.load();
+    while (microseconds > max &&
+        !counter.max_microseconds.compare_exchange_weak(max, microseconds));
+}
+
+query_statistics::latency query_statistics::get(
+    const std::string& interface) const
+{
+    const auto slot = index(interface);
+
+    if (slot == interfaces.size())
+        return { 0, 0, 0 };
+
+    const auto& counter = counters_[slot];
+    return
+    {
+        counter.queries.load(),
+        counter.total_microseconds.load(),
+        counter.max_microseconds.load()
+    };
+}
+
+void query_statistics::log_summary() const
+{
+    for (const auto& interface: interfaces)
+    {
+        const auto counters = get(interface);
+
+        if (counters.queries == 0)
+            continue;
+
+        log::info(LOG_SERVER)
+            << "Query interface " << interface << ": "
+            << counters.queries << " queries, average "
+            << counters.total_microseconds / counters.queries
+            << "us, max " << counters.max_microseconds << "us";
+    }
+}
+
+} // namespace server
+} // namespace libbitcoin
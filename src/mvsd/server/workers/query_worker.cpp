@@ -20,8 +20,10 @@
  */
 #include <metaverse/server/workers/query_worker.hpp>
 
+#include <chrono>
 #include <functional>
 #include <string>
+#include <thread>
 #include <metaverse/protocol.hpp>
 #include <metaverse/server/define.hpp>
 #include <metaverse/server/interface/address.hpp>
@@ -30,6 +32,8 @@
 #include <metaverse/server/interface/transaction_pool.hpp>
 #include <metaverse/server/messages/message.hpp>
 #include <metaverse/server/server_node.hpp>
+#include <metaverse/server/services/query_service.hpp>
+#include <metaverse/server/utility/query_statistics.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -55,6 +59,7 @@ query_worker::query_worker(zmq::authenticator& authenticator,
 void query_worker::work()
 {
     zmq::socket router(authenticator_, zmq::socket::role::router);
+    thread_ = std::this_thread::get_id();
 
     // Connect socket to the service endpoint.
     if (!started(connect(router)))
@@ -121,10 +126,25 @@ void query_worker::query(zmq::socket& router)
     if (stopped())
         return;
 
-    // TODO: rewrite the serial blockchain interface to avoid callbacks.
+    const auto start = std::chrono::steady_clock::now();
+    auto& statistics = node_.query_statistics();
+
+    // Chain queries complete on this thread, pool queries complete on the
+    // pool's thread, which may not use the router (zmq sockets are not
+    // thread safe), so those responses go through the notify endpoint.
     // We are using a closure vs. bind to take advantage of move arg syntax.
-    const auto sender = [&router](message&& response)
+    const auto sender = [this, &router, start, &statistics](message&& response)
     {
+        const auto elapsed = std::chrono::duration_cast<
+            std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        statistics.record(response.command(), elapsed.count());
+
+        if (std::this_thread::get_id() != thread_)
+        {
+            notify(response);
+            return;
+        }
+
         const auto ec = response.send(router);
 
         if (ec && ec != (code)error::service_stopped)
@@ -175,6 +195,36 @@ void query_worker::query(zmq::socket& router)
     query_execute(request, sender);
 }
 
+// Send a response completed off the worker thread, as the notification
+// worker sends notifications.
+void query_worker::notify(message& response)
+{
+    const auto security = secure_ ? "secure" : "public";
+    const auto& endpoint = secure_ ? query_service::secure_notify :
+        query_service::public_notify;
+
+    zmq::socket notifier(authenticator_, zmq::socket::role::router);
+    auto ec = notifier.connect(endpoint);
+
+    if (ec == (code)error::service_stopped)
+        return;
+
+    if (ec)
+    {
+        log::warning(LOG_SERVER)
+            << "Failed to connect " << security << " query worker notifier: "
+            << ec.message();
+        return;
+    }
+
+    ec = response.send(notifier);
+
+    if (ec && ec != (code)error::service_stopped)
+        log::warning(LOG_SERVER)
+            << "Failed to send query response to "
+            << response.route().display() << " " << ec.message();
+}
+
 // Query Interface.
 // ----------------------------------------------------------------------------
 
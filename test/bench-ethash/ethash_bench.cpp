@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <boost/filesystem.hpp>
+#include <metaverse/consensus/libethash/internal.h>
+
+// Compares the FNV loops of each instruction set on the same cache and DAG.
+//
+//   ethash-bench [dag-megabytes [full-hashes [light-hashes [rounds]]]]
+//
+// The DAG should exceed the last level cache for timings close to mining,
+// each variant reports the best of its rounds.
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const uint64_t cache_size = 16 * 1024 * 1024;
+
+static const ethash_isa_t isas[] = { ETHASH_ISA_SCALAR, ETHASH_ISA_SSE41 };
+static const char* const isa_names[] = { "scalar", "sse4.1" };
+
+static uint64_t argument(int argc, char* argv[], int index, uint64_t fallback)
+{
+    return argc > index ? std::strtoull(argv[index], nullptr, 10) : fallback;
+}
+
+static double milliseconds(bench_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+template <typename Hash>
+static double best_of(uint64_t rounds, uint64_t hashes, Hash hash)
+{
+    auto best = bench_clock::duration::max();
+    for (uint64_t round = 0; round < rounds; ++round)
+    {
+        const auto start = bench_clock::now();
+        for (uint64_t nonce = 0; nonce < hashes; ++nonce)
+            hash(nonce);
+
+        best = std::min(best, bench_clock::now() - start);
+    }
+
+    return milliseconds(best);
+}
+
+int main(int argc, char* argv[])
+{
+    const auto full_size = argument(argc, argv, 1, 64) * 1024 * 1024;
+    const auto full_hashes = argument(argc, argv, 2, 200000);
+    const auto light_hashes = argument(argc, argv, 3, 1000);
+    const auto rounds = std::max<uint64_t>(argument(argc, argv, 4, 3), 1);
+
+    if (full_size == 0 || full_size % ETHASH_MIX_BYTES != 0)
+    {
+        std::cerr << "The DAG size must be a multiple of " << ETHASH_MIX_BYTES
+            << " bytes." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ethash_h256_t seed;
+    ethash_h256_t header;
+    std::memset(&seed, 0x11, sizeof(seed));
+    std::memset(&header, 0x5a, sizeof(header));
+
+    const auto light = ethash_light_new_internal(cache_size, &seed);
+    if (light == nullptr)
+    {
+        std::cerr << "Failed to create the cache." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto directory = boost::filesystem::temp_directory_path() /
+        "ethash_bench";
+    boost::filesystem::create_directories(directory);
+
+    auto start = bench_clock::now();
+    const auto full = ethash_full_new_internal(directory.string().c_str(),
+        seed, full_size, light, nullptr);
+    if (full == nullptr)
+    {
+        std::cerr << "Failed to create the DAG." << std::endl;
+        ethash_light_delete(light);
+        boost::filesystem::remove_all(directory);
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "DAG of " << full_size / (1024 * 1024) << " MiB in "
+        << milliseconds(bench_clock::now() - start) << " ms" << std::endl;
+
+    for (size_t index = 0; index < sizeof(isas) / sizeof(*isas); ++index)
+    {
+        if (!ethash_select_isa(isas[index]))
+        {
+            std::cout << isa_names[index] << ": not supported" << std::endl;
+            continue;
+        }
+
+        const auto light_ms = best_of(rounds, light_hashes,
+            [&](uint64_t nonce)
+            {
+                ethash_light_compute_internal(light, full_size, header, nonce);
+            });
+
+        const auto full_ms = best_of(rounds, full_hashes,
+            [&](uint64_t nonce)
+            {
+                ethash_full_compute(full, header, nonce);
+            });
+
+        std::cout << isa_names[index] << ": "
+            << light_hashes << " light hashes in " << light_ms << " ms, "
+            << full_hashes << " full hashes in " << full_ms << " ms ("
+            << (full_ms == 0 ? 0 : full_hashes * 1000 / full_ms)
+            << " H/s)" << std::endl;
+    }
+
+    ethash_full_delete(full);
+    ethash_light_delete(light);
+    boost::filesystem::remove_all(directory);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+#ifdef  DATABASE_TESTS
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/databases/address_asset_database.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+using namespace libbitcoin::chain;
+
+static boost::filesystem::path make_asset_directory(const std::string& name)
+{
+    const auto directory = boost::filesystem::temp_directory_path() / name;
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    return directory;
+}
+
+static void touch_asset_file(const boost::filesystem::path& path)
+{
+    bc::ofstream file(path.string());
+
+    // Write one byte so file is nonzero size.
+    file.write("X", 1);
+}
+
+static short_hash make_address_key(uint8_t id)
+{
+    auto key = null_short_hash;
+    key[0] = id;
+    return key;
+}
+
+static output_point make_address_point(uint8_t id, uint32_t index)
+{
+    auto hash = null_hash;
+    hash[0] = id;
+    return { hash, index };
+}
+
+// Store an etp output of value at height, as data_base::push_etp does.
+static void store_etp(address_asset_database& assets, const short_hash& key,
+    const output_point& outpoint, uint32_t height, uint64_t value)
+{
+    etp amount(value);
+    assets.store_output(key, outpoint, height, value,
+        static_cast<uint16_t>(business_kind::etp), height, amount);
+}
+
+// The heights of the rows of key visited by scan, up to count rows.
+static std::vector<uint64_t> scan_heights(const address_asset_database& assets,
+    const short_hash& key, size_t max_height, size_t count)
+{
+    std::vector<uint64_t> heights;
+    assets.scan(key, max_height, [&](const business_record& row)
+    {
+        heights.push_back(row.height);
+        return heights.size() < count;
+    });
+    return heights;
+}
+
+BOOST_AUTO_TEST_SUITE(address_asset_scan_tests)
+
+BOOST_AUTO_TEST_CASE(address_asset__scan__newest_first_below_max_height)
+{
+    const auto directory = make_asset_directory("address_asset_scan");
+    const auto lookup = directory / "lookup";
+    const auto rows = directory / "rows";
+    touch_asset_file(lookup);
+    touch_asset_file(rows);
+
+    const auto key = make_address_key(1);
+    const auto other = make_address_key(2);
+
+    address_asset_database assets(lookup, rows);
+    BOOST_REQUIRE(assets.create());
+
+    store_etp(assets, key, make_address_point(1, 0), 1, 10);
+    store_etp(assets, key, make_address_point(2, 0), 2, 20);
+    store_etp(assets, key, make_address_point(2, 1), 2, 21);
+    store_etp(assets, other, make_address_point(3, 0), 3, 30);
+    store_etp(assets, key, make_address_point(4, 0), 4, 40);
+    assets.store_input(key, make_address_point(5, 0), 5,
+        make_address_point(1, 0), 5);
+
+    const std::vector<uint64_t> all{ 5, 4, 2, 2, 1 };
+    BOOST_REQUIRE(scan_heights(assets, key, max_size_t, max_size_t) == all);
+
+    // Rows above the height are skipped, the order is kept.
+    const std::vector<uint64_t> below{ 2, 2, 1 };
+    BOOST_REQUIRE(scan_heights(assets, key, 3, max_size_t) == below);
+
+    // The visitor stops the scan.
+    const std::vector<uint64_t> first{ 5, 4 };
+    BOOST_REQUIRE(scan_heights(assets, key, max_size_t, 2) == first);
+
+    BOOST_REQUIRE(scan_heights(assets, make_address_key(3), max_size_t,
+        max_size_t).empty());
+    BOOST_REQUIRE(scan_heights(assets, key, 0, max_size_t).empty());
+
+    // The rows carry the point, kind and value of what was stored.
+    business_record::list records;
+    assets.scan(key, 4, [&](const business_record& row)
+    {
+        records.push_back(row);
+        return true;
+    });
+    BOOST_REQUIRE_EQUAL(records.size(), 4u);
+    BOOST_REQUIRE(records[0].kind == point_kind::output);
+    BOOST_REQUIRE(records[0].point == make_address_point(4, 0));
+    BOOST_REQUIRE_EQUAL(records[0].val_chk_sum.value, 40u);
+    BOOST_REQUIRE(records[0].data.get_kind_value() == business_kind::etp);
+    BOOST_REQUIRE(records[1].point == make_address_point(2, 1));
+    BOOST_REQUIRE_EQUAL(records[3].val_chk_sum.value, 10u);
+
+    // A popped block removes the newest rows first.
+    assets.delete_last_row(key);
+    assets.delete_last_row(key);
+    const std::vector<uint64_t> popped{ 2, 2, 1 };
+    BOOST_REQUIRE(scan_heights(assets, key, max_size_t, max_size_t) == popped);
+    BOOST_REQUIRE(scan_heights(assets, other, max_size_t, max_size_t) ==
+        std::vector<uint64_t>{ 3 });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,205 @@
+#ifdef  DATABASE_TESTS
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/databases/address_balance_database.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+using namespace libbitcoin::chain;
+
+static boost::filesystem::path make_balance_directory(const std::string& name)
+{
+    const auto directory = boost::filesystem::temp_directory_path() / name;
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    return directory;
+}
+
+static void touch_balance_file(const boost::filesystem::path& path)
+{
+    bc::ofstream file(path.string());
+
+    // Write one byte so file is nonzero size.
+    file.write("X", 1);
+}
+
+static short_hash make_key(uint8_t id)
+{
+    auto key = null_short_hash;
+    key[0] = id;
+    return key;
+}
+
+static output_point make_point(uint8_t id, uint32_t index)
+{
+    auto hash = null_hash;
+    hash[0] = id;
+    return { hash, index };
+}
+
+static transaction make_tx(uint32_t locktime, const output_point& previous,
+    const short_hash& key, const std::vector<uint64_t>& values)
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = locktime;
+    tx.inputs.push_back({ previous, {}, max_uint32 });
+
+    for (const auto value: values)
+    {
+        output out;
+        out.value = value;
+        out.script.operations = operation::to_pay_key_hash_pattern(key);
+        out.attach_data = attachment(ETP_TYPE, 1, etp(value));
+        tx.outputs.push_back(out);
+    }
+
+    return tx;
+}
+
+// The locktime keeps the coinbase of each height distinct.
+static transaction make_coinbase(uint32_t height, const short_hash& key,
+    const std::vector<uint64_t>& values)
+{
+    return make_tx(height, { null_hash, max_uint32 }, key, values);
+}
+
+static block make_block(const hash_digest& previous, uint32_t height,
+    const transaction::list& txs)
+{
+    block instance;
+    instance.header = header(1, previous, null_hash, height, 0, height, 0,
+        height, txs.size());
+    instance.transactions = txs;
+    return instance;
+}
+
+static void require_balance(const address_balance_database& balances,
+    const short_hash& key, uint64_t received, uint64_t unspent, size_t locked)
+{
+    const auto balance = balances.get(key);
+    BOOST_REQUIRE_EQUAL(balance.received, received);
+    BOOST_REQUIRE_EQUAL(balance.unspent, unspent);
+    BOOST_REQUIRE_EQUAL(balance.locked.size(), locked);
+}
+
+BOOST_AUTO_TEST_SUITE(address_balance_tests)
+
+BOOST_AUTO_TEST_CASE(address_balance__store_spend_remove__tracks_balance)
+{
+    const auto directory = make_balance_directory("address_balance_store");
+    const auto lookup = directory / "lookup";
+    const auto outputs = directory / "outputs";
+    const auto rows = directory / "rows";
+    touch_balance_file(lookup);
+    touch_balance_file(outputs);
+    touch_balance_file(rows);
+
+    const auto key = make_key(1);
+    const auto other = make_key(2);
+    const auto unlocked = make_point(1, 0);
+    const auto locked = make_point(1, 1);
+
+    {
+        address_balance_database balances(lookup, outputs, rows);
+        BOOST_REQUIRE(balances.create(false));
+        BOOST_REQUIRE(!balances.complete());
+
+        balances.store(key, unlocked, 1, 10, 0);
+        balances.store(key, locked, 1, 5, 100);
+        balances.store(other, make_point(2, 0), 1, 7, 0);
+        require_balance(balances, key, 15, 15, 1);
+        require_balance(balances, other, 7, 7, 0);
+        BOOST_REQUIRE_EQUAL(balances.get(key).locked.front().unlock_height, 100u);
+        BOOST_REQUIRE_EQUAL(balances.get_unspent(key).size(), 2u);
+
+        address_output out;
+        balances.spend(unlocked);
+        require_balance(balances, key, 15, 5, 1);
+        BOOST_REQUIRE(!balances.get(unlocked, out));
+        BOOST_REQUIRE_EQUAL(balances.get_unspent(key).size(), 1u);
+
+        balances.unspend(unlocked);
+        require_balance(balances, key, 15, 15, 1);
+        BOOST_REQUIRE(balances.get(unlocked, out));
+        BOOST_REQUIRE(out.key == key);
+        BOOST_REQUIRE_EQUAL(out.value, 10u);
+
+        balances.remove(locked);
+        require_balance(balances, key, 10, 10, 0);
+        BOOST_REQUIRE(!balances.get(locked, out));
+
+        balances.set_complete();
+        balances.sync();
+    }
+
+    address_balance_database balances(lookup, outputs, rows);
+    BOOST_REQUIRE(balances.start());
+    BOOST_REQUIRE(balances.complete());
+    require_balance(balances, key, 10, 10, 0);
+    require_balance(balances, other, 7, 7, 0);
+    require_balance(balances, make_key(3), 0, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(address_balance__data_base_push_pop__index_balances)
+{
+    const auto directory = make_balance_directory("address_balance_database");
+    const auto miner = make_key(1);
+    const auto payee = make_key(2);
+    const auto genesis = make_block(null_hash, 0,
+        { make_coinbase(0, miner, { 50 }) });
+    BOOST_REQUIRE(data_base::initialize(directory, genesis));
+
+    database::settings configuration;
+    configuration.directory = directory;
+
+    {
+        data_base instance(configuration);
+        BOOST_REQUIRE(instance.start());
+        BOOST_REQUIRE(instance.balances.complete());
+
+        const auto block1 = make_block(genesis.header.hash(), 1,
+            { make_coinbase(1, miner, { 10, 20 }) });
+        instance.push(block1, 1);
+
+        // Block 2 pays the first output of block 1 to the payee.
+        const output_point spent{ block1.transactions[0].hash(), 0 };
+        const auto block2 = make_block(block1.header.hash(), 2,
+            { make_coinbase(2, miner, { 1 }), make_tx(0, spent, payee, { 10 }) });
+        instance.push(block2, 2);
+
+        // Coinbase outputs are locked until maturity.
+        require_balance(instance.balances, miner, 81, 71, 3);
+        require_balance(instance.balances, payee, 10, 10, 0);
+
+        instance.pop();
+        require_balance(instance.balances, miner, 80, 80, 3);
+        require_balance(instance.balances, payee, 0, 0, 0);
+
+        instance.push(block2, 2);
+        require_balance(instance.balances, miner, 81, 71, 3);
+        BOOST_REQUIRE(instance.close());
+    }
+
+    // Without the balance table the upgrade indexes the confirmed blocks.
+    const data_base::store paths(directory);
+    boost::filesystem::remove(paths.balances_lookup);
+    boost::filesystem::remove(paths.balances_outputs);
+    boost::filesystem::remove(paths.balances_rows);
+    BOOST_REQUIRE(data_base::upgrade_version_63(directory));
+
+    data_base instance(configuration);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE(instance.balances.complete());
+    require_balance(instance.balances, miner, 81, 71, 3);
+    require_balance(instance.balances, payee, 10, 10, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
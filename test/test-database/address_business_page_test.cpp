@@ -0,0 +1,180 @@
+#ifdef  DATABASE_TESTS
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/block_chain_impl.hpp>
+#include <metaverse/blockchain/settings.hpp>
+#include <metaverse/database/data_base.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::wallet;
+
+typedef std::pair<uint64_t, hash_digest> page_position;
+
+static boost::filesystem::path make_page_directory(const std::string& name)
+{
+    const auto directory = boost::filesystem::temp_directory_path() / name;
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    return directory;
+}
+
+static short_hash make_page_key(uint8_t id)
+{
+    auto key = null_short_hash;
+    key[0] = id;
+    return key;
+}
+
+// Pay each (key, value) from previous with an etp attachment.
+static transaction make_page_tx(uint32_t locktime, const output_point& previous,
+    const std::vector<std::pair<short_hash, uint64_t>>& payments)
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = locktime;
+    tx.inputs.push_back({ previous, {}, max_uint32 });
+
+    for (const auto& payment: payments)
+    {
+        output out;
+        out.value = payment.second;
+        out.script.operations = operation::to_pay_key_hash_pattern(payment.first);
+        out.attach_data = attachment(ETP_TYPE, 1, etp(payment.second));
+        tx.outputs.push_back(out);
+    }
+
+    return tx;
+}
+
+// The locktime keeps the coinbase of each height distinct.
+static transaction make_page_coinbase(uint32_t height, const short_hash& key)
+{
+    return make_page_tx(height, { null_hash, max_uint32 }, { { key, 50 } });
+}
+
+static block::ptr make_page_block(const hash_digest& previous, uint32_t height,
+    const transaction::list& txs)
+{
+    auto instance = std::make_shared<block>();
+    instance->header = header(1, previous, null_hash, height, 0, height, 0,
+        height, txs.size());
+    instance->transactions = txs;
+    return instance;
+}
+
+// Read every page of limit rows, checking each one is full but the last.
+static std::vector<page_position> read_pages(block_chain_impl& chain,
+    const std::vector<std::string>& addresses, size_t end_height, size_t limit)
+{
+    std::vector<page_position> positions;
+    std::string cursor;
+
+    do
+    {
+        const auto page = chain.get_address_business_record_page(addresses,
+            "", 0, end_height, limit, cursor);
+        BOOST_REQUIRE(page);
+        BOOST_REQUIRE(cursor.empty() ? page->size() <= limit :
+            page->size() == limit);
+
+        for (const auto& row: *page)
+            positions.emplace_back(row.height, row.point.hash);
+    } while (!cursor.empty());
+
+    return positions;
+}
+
+BOOST_AUTO_TEST_SUITE(address_business_page_tests)
+
+BOOST_AUTO_TEST_CASE(address_business_page__cursor__pages_each_transaction_once)
+{
+    const auto directory = make_page_directory("address_business_page");
+    const auto alice = make_page_key(1);
+    const auto bob = make_page_key(2);
+    const std::vector<std::string> addresses
+    {
+        payment_address(alice).encoded(),
+        payment_address(bob).encoded()
+    };
+
+    const auto genesis = make_page_block(null_hash, 0,
+        { make_page_coinbase(0, alice) });
+    BOOST_REQUIRE(database::data_base::initialize(directory, *genesis));
+
+    database::settings database_settings;
+    database_settings.directory = directory;
+    const blockchain::settings chain_settings;
+    threadpool pool(1);
+
+    block_chain_impl chain(pool, chain_settings, database_settings);
+    BOOST_REQUIRE(chain.start());
+
+    const auto& coinbase0 = genesis->transactions[0];
+    const auto block1 = make_page_block(genesis->header.hash(), 1,
+        { make_page_coinbase(1, alice) });
+    BOOST_REQUIRE(chain.import(block1, 1));
+
+    // A transaction paying both addresses is listed once.
+    const auto& coinbase1 = block1->transactions[0];
+    const auto block2 = make_page_block(block1->header.hash(), 2,
+    {
+        make_page_coinbase(2, bob),
+        make_page_tx(0, { coinbase1.hash(), 0 }, { { alice, 10 }, { bob, 40 } })
+    });
+    BOOST_REQUIRE(chain.import(block2, 2));
+
+    // Several transactions of one height may fall on different pages.
+    const auto block3 = make_page_block(block2->header.hash(), 3,
+    {
+        make_page_coinbase(3, alice),
+        make_page_tx(0, { coinbase0.hash(), 0 }, { { alice, 50 } }),
+        make_page_tx(0, { block2->transactions[1].hash(), 1 }, { { bob, 40 } })
+    });
+    BOOST_REQUIRE(chain.import(block3, 3));
+
+    std::vector<page_position> expected;
+    for (const auto& instance: { genesis, block1, block2, block3 })
+        for (const auto& tx: instance->transactions)
+            expected.emplace_back(instance->header.number, tx.hash());
+
+    // Newest first, then by hash.
+    std::sort(expected.begin(), expected.end(),
+        [](const page_position& lhs, const page_position& rhs)
+        {
+            return lhs.first != rhs.first ? lhs.first > rhs.first :
+                lhs.second < rhs.second;
+        });
+
+    BOOST_REQUIRE_EQUAL(expected.size(), 7u);
+    for (size_t limit = 1; limit <= expected.size() + 1; ++limit)
+        BOOST_REQUIRE(read_pages(chain, addresses, 0, limit) == expected);
+
+    // The end height is exclusive.
+    const std::vector<page_position> below(expected.begin() + 3,
+        expected.end());
+    BOOST_REQUIRE(read_pages(chain, addresses, 3, 2) == below);
+
+    // Only the rows of the given addresses.
+    const std::vector<std::string> only_bob{ addresses[1] };
+    BOOST_REQUIRE_EQUAL(read_pages(chain, only_bob, 0, 2).size(), 3u);
+
+    std::string cursor("00");
+    BOOST_REQUIRE(!chain.get_address_business_record_page(addresses, "", 0, 0,
+        2, cursor));
+
+    BOOST_REQUIRE(chain.stop());
+    pool.shutdown();
+    pool.join();
+    BOOST_REQUIRE(chain.close());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,222 @@
+#ifdef  DATABASE_TESTS
+#include <cstdint>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_hash_table.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+
+typedef byte_array<4> test_key;
+
+constexpr size_t test_buckets = 4;
+constexpr size_t test_entries = 1000;
+constexpr size_t test_header_size =
+    record_hash_table_header_size(test_buckets);
+constexpr size_t test_value_size = sizeof(uint32_t);
+constexpr size_t test_record_size =
+    hash_table_record_size<test_key>(test_value_size);
+
+static boost::filesystem::path touch_table_file(const std::string& name)
+{
+    const auto path = boost::filesystem::temp_directory_path() / name;
+    bc::ofstream file(path.string());
+
+    // Write one byte so file is nonzero size.
+    file.write("X", 1);
+    return path;
+}
+
+static test_key make_key(uint32_t value)
+{
+    test_key key;
+    auto serial = make_serializer(key.begin());
+    serial.write_4_bytes_little_endian(value);
+    return key;
+}
+
+static uint32_t read_value(const memory_ptr memory)
+{
+    return from_little_endian_unsafe<uint32_t>(REMAP_ADDRESS(memory));
+}
+
+// The file, header, manager and table of a single table file.
+struct table_fixture
+{
+    table_fixture(const boost::filesystem::path& path)
+      : file(path),
+        header(file, test_buckets),
+        manager(file, test_header_size, test_record_size),
+        table(header, manager)
+    {
+    }
+
+    bool create()
+    {
+        if (!file.start())
+            return false;
+
+        file.resize(test_header_size + minimum_records_size);
+        return table.create() && table.start();
+    }
+
+    bool start()
+    {
+        return file.start() && table.start();
+    }
+
+    void store(uint32_t value)
+    {
+        const auto write = [value](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_4_bytes_little_endian(value);
+        };
+
+        table.store(make_key(value), write);
+    }
+
+    bool contains_all(size_t count) const
+    {
+        for (uint32_t value = 0; value < count; ++value)
+        {
+            const auto memory = table.find(make_key(value));
+            if (!memory || read_value(memory) != value)
+                return false;
+        }
+
+        return true;
+    }
+
+    memory_map file;
+    record_hash_table_header header;
+    record_manager manager;
+    record_hash_table<test_key> table;
+};
+
+BOOST_AUTO_TEST_SUITE(hash_table_tests)
+
+BOOST_AUTO_TEST_CASE(hash_table__store__splits__finds_every_key)
+{
+    const auto path = touch_table_file("hash_table_split");
+    table_fixture instance(path);
+    BOOST_REQUIRE(instance.create());
+    BOOST_REQUIRE(instance.header.growable());
+
+    for (uint32_t value = 0; value < test_entries; ++value)
+        instance.store(value);
+
+    BOOST_REQUIRE_GT(instance.header.size(), test_buckets);
+    BOOST_REQUIRE(!instance.header.overloaded());
+    BOOST_REQUIRE_EQUAL(instance.header.entries(), test_entries);
+    BOOST_REQUIRE(instance.contains_all(test_entries));
+    BOOST_REQUIRE(!instance.table.find(make_key(test_entries)));
+}
+
+BOOST_AUTO_TEST_CASE(hash_table__start__version_1__reloads_directory)
+{
+    const auto path = touch_table_file("hash_table_reopen");
+    size_t size;
+
+    {
+        table_fixture instance(path);
+        BOOST_REQUIRE(instance.create());
+
+        for (uint32_t value = 0; value < test_entries; ++value)
+            instance.store(value);
+
+        instance.manager.sync();
+        size = instance.header.size();
+    }
+
+    table_fixture instance(path);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE(instance.header.growable());
+    BOOST_REQUIRE_EQUAL(instance.header.size(), size);
+    BOOST_REQUIRE_LE(instance.header.entries(), test_entries);
+    BOOST_REQUIRE(instance.contains_all(test_entries));
+}
+
+BOOST_AUTO_TEST_CASE(hash_table__sync__reopen__keeps_entries)
+{
+    const auto path = touch_table_file("hash_table_sync");
+    const uint32_t entries = 2;
+
+    {
+        table_fixture instance(path);
+        BOOST_REQUIRE(instance.create());
+
+        for (uint32_t value = 0; value < entries; ++value)
+            instance.store(value);
+
+        // No split yet, the count is only written by sync.
+        BOOST_REQUIRE_EQUAL(instance.header.size(), test_buckets);
+        instance.header.sync();
+        instance.manager.sync();
+    }
+
+    table_fixture instance(path);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE_EQUAL(instance.header.entries(), entries);
+    BOOST_REQUIRE(instance.contains_all(entries));
+}
+
+BOOST_AUTO_TEST_CASE(hash_table__start__version_0__upgrades_in_place)
+{
+    const auto path = touch_table_file("hash_table_upgrade");
+
+    // Write a fixed size table, chaining records as the version 0 table did.
+    {
+        memory_map file(path);
+        record_hash_table_header header(file, test_buckets);
+        record_manager manager(file, test_header_size, test_record_size);
+        BOOST_REQUIRE(file.start());
+        file.resize(test_header_size + minimum_records_size);
+        BOOST_REQUIRE(header.create() && manager.create());
+        BOOST_REQUIRE(header.start() && manager.start());
+        BOOST_REQUIRE(!header.growable());
+
+        for (uint32_t value = 0; value < test_entries; ++value)
+        {
+            const auto key = make_key(value);
+            const auto bucket = header.bucket(std::hash<test_key>()(key));
+            record_row<test_key> item(manager, 0);
+            const auto index = item.create(key, header.read(bucket));
+            auto serial = make_serializer(REMAP_ADDRESS(item.data()));
+            serial.write_4_bytes_little_endian(value);
+            header.write(bucket, index);
+        }
+
+        manager.sync();
+    }
+
+    // The upgrade counts the records and keeps every chain addressable.
+    {
+        table_fixture instance(path);
+        BOOST_REQUIRE(instance.start());
+        BOOST_REQUIRE(instance.header.growable());
+        BOOST_REQUIRE_EQUAL(instance.header.size(), test_buckets);
+        BOOST_REQUIRE_EQUAL(instance.header.entries(), test_entries);
+        BOOST_REQUIRE(instance.contains_all(test_entries));
+
+        // Stores after the upgrade split the overloaded header.
+        instance.store(test_entries);
+        BOOST_REQUIRE_GT(instance.header.size(), test_buckets);
+        BOOST_REQUIRE(instance.contains_all(test_entries + 1));
+        instance.manager.sync();
+    }
+
+    // The upgraded header is reloaded as version 1.
+    table_fixture instance(path);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE(instance.header.growable());
+    BOOST_REQUIRE(instance.contains_all(test_entries + 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
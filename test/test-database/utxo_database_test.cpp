@@ -0,0 +1,214 @@
+#ifdef  DATABASE_TESTS
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/databases/utxo_database.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+using namespace libbitcoin::chain;
+
+// Small enough that reads go past the cache to the table.
+constexpr size_t utxo_cache_capacity = 1;
+
+static boost::filesystem::path touch_utxo_file(const std::string& name)
+{
+    const auto path = boost::filesystem::temp_directory_path() / name;
+    bc::ofstream file(path.string());
+
+    // Write one byte so file is nonzero size.
+    file.write("X", 1);
+    return path;
+}
+
+static hash_digest make_tx_hash(uint8_t id)
+{
+    auto hash = null_hash;
+    hash[0] = id;
+    return hash;
+}
+
+static output make_output(uint64_t value)
+{
+    output out;
+    out.value = value;
+    out.attach_data = attachment(ETP_TYPE, 1, etp(value));
+    return out;
+}
+
+static transaction make_tx(uint32_t locktime, const output_point& previous,
+    const std::vector<uint64_t>& values)
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = locktime;
+    tx.inputs.push_back({ previous, {}, max_uint32 });
+
+    for (const auto value: values)
+    {
+        auto out = make_output(value);
+        out.script.operations =
+            operation::to_pay_key_hash_pattern(null_short_hash);
+        tx.outputs.push_back(out);
+    }
+
+    return tx;
+}
+
+// The locktime keeps the coinbase of each height distinct.
+static transaction make_coinbase(uint32_t height,
+    const std::vector<uint64_t>& values)
+{
+    return make_tx(height, { null_hash, max_uint32 }, values);
+}
+
+static block make_block(const hash_digest& previous, uint32_t height,
+    const transaction::list& txs)
+{
+    block instance;
+    instance.header = header(1, previous, null_hash, height, 0, height, 0,
+        height, txs.size());
+    instance.transactions = txs;
+    return instance;
+}
+
+static boost::filesystem::path make_database_directory(const std::string& name)
+{
+    const auto directory = boost::filesystem::temp_directory_path() / name;
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    return directory;
+}
+
+static bool is_unspent(const utxo_database& utxos, const output_point& point,
+    uint32_t height, bool coinbase, uint64_t value)
+{
+    const auto result = utxos.get(point);
+    return result.valid && result.height == height &&
+        result.coinbase == coinbase && result.output.value == value;
+}
+
+BOOST_AUTO_TEST_SUITE(utxo_database_tests)
+
+BOOST_AUTO_TEST_CASE(utxo_database__store__remove__reads_through_cache)
+{
+    const auto path = touch_utxo_file("utxo_store");
+    utxo_database utxos(path, nullptr, utxo_cache_capacity);
+    BOOST_REQUIRE(utxos.create());
+
+    const output_point first{ make_tx_hash(1), 0 };
+    const output_point second{ make_tx_hash(1), 1 };
+    utxos.store(first, 1, true, make_output(10));
+    utxos.store(second, 1, true, make_output(20));
+
+    // The first entry is no longer cached.
+    BOOST_REQUIRE(is_unspent(utxos, first, 1, true, 10));
+    BOOST_REQUIRE(is_unspent(utxos, second, 1, true, 20));
+
+    BOOST_REQUIRE(utxos.remove(first));
+    BOOST_REQUIRE(!utxos.remove(first));
+    BOOST_REQUIRE(!utxos.get(first).valid);
+    BOOST_REQUIRE(is_unspent(utxos, second, 1, true, 20));
+}
+
+// The writes of data_base::push_utxos and pop_utxos for a one block reorg.
+BOOST_AUTO_TEST_CASE(utxo_database__reorg__restores_spent_outputs)
+{
+    const auto path = touch_utxo_file("utxo_reorg");
+    const output_point coinbase0{ make_tx_hash(1), 0 };
+    const output_point coinbase1{ make_tx_hash(1), 1 };
+    const output_point spend_old{ make_tx_hash(2), 0 };
+    const output_point spend_new{ make_tx_hash(3), 0 };
+
+    {
+        utxo_database utxos(path, nullptr, utxo_cache_capacity);
+        BOOST_REQUIRE(utxos.create());
+
+        // Block 1 confirms a coinbase with two outputs.
+        utxos.store(coinbase0, 1, true, make_output(10));
+        utxos.store(coinbase1, 1, true, make_output(20));
+        utxos.sync();
+
+        // Block 2 spends the first output.
+        BOOST_REQUIRE(utxos.remove(coinbase0));
+        utxos.store(spend_old, 2, false, make_output(10));
+        utxos.sync();
+        BOOST_REQUIRE(!utxos.get(coinbase0).valid);
+
+        // Pop block 2, restoring the output it spent.
+        BOOST_REQUIRE(utxos.remove(spend_old));
+        utxos.store(coinbase0, 1, true, make_output(10));
+        utxos.sync();
+
+        // The new block 2 spends the second output instead.
+        BOOST_REQUIRE(utxos.remove(coinbase1));
+        utxos.store(spend_new, 2, false, make_output(20));
+        utxos.sync();
+
+        BOOST_REQUIRE(is_unspent(utxos, coinbase0, 1, true, 10));
+        BOOST_REQUIRE(!utxos.get(coinbase1).valid);
+        BOOST_REQUIRE(!utxos.get(spend_old).valid);
+        BOOST_REQUIRE(is_unspent(utxos, spend_new, 2, false, 20));
+    }
+
+    // The set is read back from the table with an empty cache.
+    utxo_database utxos(path, nullptr, utxo_cache_capacity);
+    BOOST_REQUIRE(utxos.start());
+    BOOST_REQUIRE(is_unspent(utxos, coinbase0, 1, true, 10));
+    BOOST_REQUIRE(!utxos.get(coinbase1).valid);
+    BOOST_REQUIRE(!utxos.get(spend_old).valid);
+    BOOST_REQUIRE(is_unspent(utxos, spend_new, 2, false, 20));
+}
+
+BOOST_AUTO_TEST_CASE(utxo_database__data_base_pop__restores_spent_outputs)
+{
+    const auto directory = make_database_directory("utxo_reorg_database");
+    const auto genesis = make_block(null_hash, 0, { make_coinbase(0, { 50 }) });
+    BOOST_REQUIRE(data_base::initialize(directory, genesis));
+
+    database::settings configuration;
+    configuration.directory = directory;
+    data_base instance(configuration);
+    BOOST_REQUIRE(instance.start());
+
+    const auto block1 = make_block(genesis.header.hash(), 1,
+        { make_coinbase(1, { 10, 20 }) });
+    instance.push(block1, 1);
+    const auto coinbase_hash = block1.transactions[0].hash();
+    const output_point coinbase0{ coinbase_hash, 0 };
+    const output_point coinbase1{ coinbase_hash, 1 };
+
+    // Block 2 spends the first output of block 1.
+    const auto spend_old = make_tx(0, coinbase0, { 10 });
+    const auto block2 = make_block(block1.header.hash(), 2,
+        { make_coinbase(2, { 1 }), spend_old });
+    instance.push(block2, 2);
+    const output_point spent_to{ spend_old.hash(), 0 };
+    BOOST_REQUIRE(!instance.utxos.get(coinbase0).valid);
+    BOOST_REQUIRE(is_unspent(instance.utxos, spent_to, 2, false, 10));
+
+    // The pop restores the spent output from the transaction table.
+    instance.pop();
+    BOOST_REQUIRE(is_unspent(instance.utxos, coinbase0, 1, true, 10));
+    BOOST_REQUIRE(!instance.utxos.get(spent_to).valid);
+    const output_point coinbase2{ block2.transactions[0].hash(), 0 };
+    BOOST_REQUIRE(!instance.utxos.get(coinbase2).valid);
+
+    // The new block 2 spends the second output instead.
+    const auto spend_new = make_tx(0, coinbase1, { 20 });
+    const auto block2b = make_block(block1.header.hash(), 2,
+        { make_coinbase(2, { 2 }), spend_new });
+    instance.push(block2b, 2);
+    BOOST_REQUIRE(is_unspent(instance.utxos, coinbase0, 1, true, 10));
+    BOOST_REQUIRE(!instance.utxos.get(coinbase1).valid);
+    BOOST_REQUIRE(is_unspent(instance.utxos, { spend_new.hash(), 0 }, 2, false,
+        20));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
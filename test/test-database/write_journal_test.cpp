@@ -0,0 +1,192 @@
+#ifdef  DATABASE_TESTS
+#include <cstdint>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/memory/write_journal.hpp>
+#include <metaverse/database/primitives/record_hash_table.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+
+typedef byte_array<4> journal_key;
+
+constexpr size_t journal_buckets = 4;
+constexpr uint32_t journal_entries = 10;
+constexpr size_t journal_header_size =
+    record_hash_table_header_size(journal_buckets);
+constexpr size_t journal_record_size =
+    hash_table_record_size<journal_key>(sizeof(uint32_t));
+
+static void touch_journal_file(const boost::filesystem::path& path)
+{
+    bc::ofstream file(path.string());
+
+    // Write one byte so file is nonzero size.
+    file.write("X", 1);
+}
+
+// The journal expects its tables in its own directory.
+static boost::filesystem::path make_journal_directory(const std::string& name)
+{
+    const auto directory = boost::filesystem::temp_directory_path() / name;
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    touch_journal_file(directory / "journal");
+    touch_journal_file(directory / "table");
+    return directory;
+}
+
+static journal_key make_journal_key(uint32_t value)
+{
+    journal_key key;
+    auto serial = make_serializer(key.begin());
+    serial.write_4_bytes_little_endian(value);
+    return key;
+}
+
+// A table written the way data_base writes a block: stores, then sync.
+struct journal_table
+{
+    journal_table(const boost::filesystem::path& path)
+      : file(path),
+        header(file, journal_buckets),
+        manager(file, journal_header_size, journal_record_size),
+        table(header, manager)
+    {
+    }
+
+    bool create()
+    {
+        if (!file.start())
+            return false;
+
+        file.resize(journal_header_size + minimum_records_size);
+        return table.create() && table.start();
+    }
+
+    bool start()
+    {
+        return file.start() && table.start();
+    }
+
+    void store(uint32_t from, uint32_t to)
+    {
+        for (auto value = from; value < to; ++value)
+        {
+            const auto write = [value](memory_ptr data)
+            {
+                auto serial = make_serializer(REMAP_ADDRESS(data));
+                serial.write_4_bytes_little_endian(value);
+            };
+
+            table.store(make_journal_key(value), write);
+        }
+    }
+
+    void sync()
+    {
+        header.sync();
+        manager.sync();
+    }
+
+    bool contains(uint32_t value) const
+    {
+        const auto memory = table.find(make_journal_key(value));
+        return memory &&
+            from_little_endian_unsafe<uint32_t>(REMAP_ADDRESS(memory)) == value;
+    }
+
+    memory_map file;
+    record_hash_table_header header;
+    record_manager manager;
+    record_hash_table<journal_key> table;
+};
+
+BOOST_AUTO_TEST_SUITE(write_journal_tests)
+
+BOOST_AUTO_TEST_CASE(write_journal__recover__interrupted_push__restores_tables)
+{
+    const auto directory = make_journal_directory("write_journal_push");
+    const auto crashed = make_journal_directory("write_journal_crashed");
+
+    {
+        write_journal journal(directory / "journal");
+        BOOST_REQUIRE(journal.create());
+
+        journal_table instance(directory / "table");
+        BOOST_REQUIRE(instance.create());
+        instance.store(0, journal_entries);
+        instance.sync();
+
+        journal.begin(write_journal::operation::push, 1);
+        instance.store(journal_entries, 2 * journal_entries);
+        instance.sync();
+        BOOST_REQUIRE(instance.contains(2 * journal_entries - 1));
+
+        // Keep the files as a crash before the commit would leave them, the
+        // mappings are shared so the copies see every write.
+        for (const auto name: { "journal", "table" })
+            boost::filesystem::copy_file(directory / name, crashed / name,
+                boost::filesystem::copy_option::overwrite_if_exists);
+
+        journal.commit();
+    }
+
+    {
+        write_journal journal(crashed / "journal");
+        BOOST_REQUIRE(journal.start());
+        BOOST_REQUIRE(journal.recover());
+    }
+
+    journal_table instance(crashed / "table");
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE_EQUAL(instance.header.entries(), journal_entries);
+
+    for (uint32_t value = 0; value < journal_entries; ++value)
+        BOOST_REQUIRE(instance.contains(value));
+
+    for (auto value = journal_entries; value < 2 * journal_entries; ++value)
+        BOOST_REQUIRE(!instance.contains(value));
+}
+
+BOOST_AUTO_TEST_CASE(write_journal__recover__committed_push__keeps_tables)
+{
+    const auto directory = make_journal_directory("write_journal_commit");
+    const auto journal_path = directory / "journal";
+
+    {
+        write_journal journal(journal_path);
+        BOOST_REQUIRE(journal.create());
+
+        journal_table instance(directory / "table");
+        BOOST_REQUIRE(instance.create());
+        instance.store(0, journal_entries);
+        instance.sync();
+
+        journal.begin(write_journal::operation::push, 1);
+        instance.store(journal_entries, 2 * journal_entries);
+        instance.sync();
+        journal.commit();
+    }
+
+    {
+        write_journal journal(journal_path);
+        BOOST_REQUIRE(journal.start());
+        BOOST_REQUIRE(journal.recover());
+    }
+
+    journal_table instance(directory / "table");
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE_EQUAL(instance.header.entries(), 2 * journal_entries);
+
+    for (uint32_t value = 0; value < 2 * journal_entries; ++value)
+        BOOST_REQUIRE(instance.contains(value));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,137 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/consensus/libethash/internal.h>
+
+// Small sizes keep the DAG generation short, the hashes do the same work.
+static const uint64_t test_cache_size = 1024 * 1024;
+static const uint64_t test_full_size = 4 * 1024 * 1024;
+static const uint64_t test_light_hashes = 200;
+
+static const ethash_isa_t test_isas[] = {
+    ETHASH_ISA_SCALAR, ETHASH_ISA_SSE41
+};
+
+static const char* const test_isa_names[] = { "scalar", "sse4.1" };
+static const size_t test_isa_count = sizeof(test_isas) / sizeof(*test_isas);
+
+typedef std::vector<ethash_return_value_t> results;
+
+struct ethash_fixture
+{
+    ethash_fixture()
+      : directory(boost::filesystem::temp_directory_path() / "ethash_test"),
+        full(nullptr)
+    {
+        std::memset(&seed, 0x11, sizeof(seed));
+        std::memset(&header, 0x5a, sizeof(header));
+        light = ethash_light_new_internal(test_cache_size, &seed);
+    }
+
+    ~ethash_fixture()
+    {
+        // Restore the best supported variant for the other tests.
+        if (!ethash_select_isa(ETHASH_ISA_SSE41))
+            ethash_select_isa(ETHASH_ISA_SCALAR);
+
+        if (full != nullptr)
+            ethash_full_delete(full);
+
+        ethash_light_delete(light);
+        boost::filesystem::remove_all(directory);
+    }
+
+    bool create_full()
+    {
+        boost::filesystem::create_directories(directory);
+        full = ethash_full_new_internal(directory.string().c_str(), seed,
+            test_full_size, light, nullptr);
+        return full != nullptr;
+    }
+
+    results light_hashes() const
+    {
+        results out;
+        for (uint64_t nonce = 0; nonce < test_light_hashes; ++nonce)
+            out.push_back(ethash_light_compute_internal(light, test_full_size,
+                header, nonce));
+        return out;
+    }
+
+    results full_hashes() const
+    {
+        results out;
+        for (uint64_t nonce = 0; nonce < test_light_hashes; ++nonce)
+            out.push_back(ethash_full_compute(full, header, nonce));
+        return out;
+    }
+
+    boost::filesystem::path directory;
+    ethash_h256_t seed;
+    ethash_h256_t header;
+    ethash_light_t light;
+    ethash_full_t full;
+};
+
+static bool equal(const results& left, const results& right)
+{
+    if (left.size() != right.size())
+        return false;
+
+    for (size_t index = 0; index < left.size(); ++index)
+    {
+        const auto& one = left[index];
+        const auto& two = right[index];
+
+        if (!one.success || !two.success ||
+            std::memcmp(&one.result, &two.result, sizeof(one.result)) != 0 ||
+            std::memcmp(&one.mix_hash, &two.mix_hash,
+                sizeof(one.mix_hash)) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+BOOST_FIXTURE_TEST_SUITE(ethash_tests, ethash_fixture)
+
+BOOST_AUTO_TEST_CASE(ethash__light_compute__every_isa__same_hashes)
+{
+    BOOST_REQUIRE(light != nullptr);
+    BOOST_REQUIRE(ethash_select_isa(ETHASH_ISA_SCALAR));
+    const auto expected = light_hashes();
+
+    for (size_t isa = 1; isa < test_isa_count; ++isa)
+    {
+        if (!ethash_select_isa(test_isas[isa]))
+        {
+            BOOST_TEST_MESSAGE(test_isa_names[isa] << " not supported");
+            continue;
+        }
+
+        BOOST_REQUIRE(equal(light_hashes(), expected));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ethash__full_compute__every_isa__same_as_light)
+{
+    BOOST_REQUIRE(light != nullptr);
+    BOOST_REQUIRE(ethash_select_isa(ETHASH_ISA_SCALAR));
+    const auto expected = light_hashes();
+
+    // The DAG is generated by the best supported variant.
+    BOOST_REQUIRE(create_full());
+
+    for (size_t isa = 0; isa < test_isa_count; ++isa)
+    {
+        if (!ethash_select_isa(test_isas[isa]))
+            continue;
+
+        BOOST_REQUIRE(equal(full_hashes(), expected));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/mgbubble/utility/Compress.hpp>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace mgbubble;
+
+#ifdef USE_ZLIB
+// Inflate either wrapper, zlib detects which one with window bits + 32.
+static bool inflate_all(const std::string& in, std::string& out)
+{
+    z_stream zs{};
+    if (inflateInit2(&zs, 15 + 32) != Z_OK)
+        return false;
+
+    char buffer[4096];
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+
+    int result;
+    do {
+        zs.next_out = reinterpret_cast<Bytef*>(buffer);
+        zs.avail_out = sizeof(buffer);
+        result = inflate(&zs, Z_NO_FLUSH);
+        out.append(buffer, sizeof(buffer) - zs.avail_out);
+    } while (result == Z_OK);
+
+    inflateEnd(&zs);
+    return result == Z_STREAM_END;
+}
+#endif
+
+static std::string make_body()
+{
+    std::string body("[");
+    for (size_t tx = 0; tx < 200; ++tx)
+        body += "{\"hash\":\"00ff00ff\",\"height\":1000,\"value\":12345},";
+    body.back() = ']';
+    return body;
+}
+
+BOOST_AUTO_TEST_SUITE(compress_tests)
+
+BOOST_AUTO_TEST_CASE(compress__accept_encoding__none__identity)
+{
+    BOOST_REQUIRE(acceptEncoding("") == Encoding::identity);
+    BOOST_REQUIRE(acceptEncoding("br, identity") == Encoding::identity);
+    BOOST_REQUIRE_EQUAL(encodingName(Encoding::identity), "identity");
+}
+
+BOOST_AUTO_TEST_CASE(compress__compress__identity__not_compressed)
+{
+    const auto body = make_body();
+    std::string out;
+    BOOST_REQUIRE(!compress(Encoding::identity, body.data(), body.size(), out));
+}
+
+#ifdef USE_ZLIB
+
+BOOST_AUTO_TEST_CASE(compress__accept_encoding__prefers_gzip)
+{
+    BOOST_REQUIRE(acceptEncoding("deflate, gzip") == Encoding::gzip);
+    BOOST_REQUIRE(acceptEncoding("GZIP;q=0.5") == Encoding::gzip);
+    BOOST_REQUIRE(acceptEncoding("*") == Encoding::gzip);
+    BOOST_REQUIRE(acceptEncoding(" deflate ") == Encoding::deflate);
+    BOOST_REQUIRE(acceptEncoding("gzip;q=0, deflate") == Encoding::deflate);
+    BOOST_REQUIRE(acceptEncoding("gzip; q=0.0") == Encoding::identity);
+    BOOST_REQUIRE_EQUAL(encodingName(Encoding::gzip), "gzip");
+    BOOST_REQUIRE_EQUAL(encodingName(Encoding::deflate), "deflate");
+}
+
+BOOST_AUTO_TEST_CASE(compress__compress__round_trips)
+{
+    const auto body = make_body();
+
+    for (const auto encoding: { Encoding::gzip, Encoding::deflate }) {
+        std::string out;
+        BOOST_REQUIRE(compress(encoding, body.data(), body.size(), out));
+        BOOST_REQUIRE_LT(out.size(), body.size());
+
+        std::string inflated;
+        BOOST_REQUIRE(inflate_all(out, inflated));
+        BOOST_REQUIRE_EQUAL(inflated, body);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compress__compress__no_saving__not_compressed)
+{
+    const std::string body("{}");
+    std::string out;
+    BOOST_REQUIRE(!compress(Encoding::gzip, body.data(), body.size(), out));
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <json/json.h>
+#include <metaverse/mgbubble/utility/Json_writer.hpp>
+
+using namespace mgbubble;
+
+static Json::Value parse(const std::string& text)
+{
+    Json::Value value;
+    Json::Reader reader;
+    BOOST_REQUIRE(reader.parse(text, value));
+    return value;
+}
+
+static Json::Value make_response()
+{
+    Json::Value result;
+    result["height"] = Json::Value::UInt64(18446744073709551615ull);
+    result["balance"] = Json::Value::Int64(-9007199254740993ll);
+    result["difficulty"] = 0.1;
+    result["confirmed"] = true;
+    result["memo"] = "quote \" backslash \\ newline \n tab \t";
+    result["txs"] = Json::Value(Json::arrayValue);
+    result["txs"].append("00ff");
+    result["txs"].append(Json::Value());
+
+    Json::Value response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = 1;
+    response["result"] = result;
+    return response;
+}
+
+BOOST_AUTO_TEST_SUITE(json_writer_tests)
+
+BOOST_AUTO_TEST_CASE(json_writer__to_json__compact__no_whitespace)
+{
+    Json::Value value;
+    value["a"] = 1;
+    value["b"] = Json::Value(Json::arrayValue);
+    value["b"].append("x");
+    value["b"].append(false);
+    BOOST_REQUIRE_EQUAL(toJson(value), "{\"a\":1,\"b\":[\"x\",false]}");
+    BOOST_REQUIRE_EQUAL(toJson(Json::Value(Json::objectValue)), "{}");
+    BOOST_REQUIRE_EQUAL(toJson(Json::Value(Json::arrayValue)), "[]");
+    BOOST_REQUIRE_EQUAL(toJson(Json::Value()), "null");
+}
+
+BOOST_AUTO_TEST_CASE(json_writer__to_json__round_trips)
+{
+    const auto response = make_response();
+    BOOST_REQUIRE(parse(toJson(response)) == response);
+    BOOST_REQUIRE(parse(toJson(response, true)) == response);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer__write_json__matches_to_json)
+{
+    const auto response = make_response();
+    std::ostringstream os;
+    writeJson(os, response);
+    BOOST_REQUIRE_EQUAL(os.str(), toJson(response));
+}
+
+BOOST_AUTO_TEST_CASE(json_writer__to_json__pretty__keeps_v1_layout)
+{
+    Json::Value value;
+    value["a"] = 1;
+    BOOST_REQUIRE(toJson(value, true).find('\n') != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/server/utility/query_statistics.hpp>
+
+using namespace libbitcoin::server;
+
+BOOST_AUTO_TEST_SUITE(query_statistics_tests)
+
+BOOST_AUTO_TEST_CASE(query_statistics__record__counts_per_interface)
+{
+    query_statistics statistics;
+    statistics.record("address.fetch_history2", 30);
+    statistics.record("address.subscribe2", 10);
+    statistics.record("blockchain.fetch_last_height", 5);
+    statistics.record("unknown.command", 1000);
+
+    const auto address = statistics.get("address");
+    BOOST_REQUIRE_EQUAL(address.queries, 2u);
+    BOOST_REQUIRE_EQUAL(address.total_microseconds, 40u);
+    BOOST_REQUIRE_EQUAL(address.max_microseconds, 30u);
+
+    const auto blockchain = statistics.get("blockchain");
+    BOOST_REQUIRE_EQUAL(blockchain.queries, 1u);
+    BOOST_REQUIRE_EQUAL(blockchain.max_microseconds, 5u);
+
+    BOOST_REQUIRE_EQUAL(statistics.get("transaction_pool").queries, 0u);
+    BOOST_REQUIRE_EQUAL(statistics.get("unknown").queries, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(query_statistics__record__concurrent_workers__keeps_every_query)
+{
+    constexpr uint64_t workers = 4;
+    constexpr uint64_t queries = 10000;
+    query_statistics statistics;
+
+    std::vector<std::thread> threads;
+    for (uint64_t worker = 0; worker < workers; ++worker)
+        threads.emplace_back([&statistics, worker] {
+            for (uint64_t query = 0; query < queries; ++query)
+                statistics.record("protocol.total_connections",
+                    worker * queries + query);
+        });
+
+    for (auto& thread: threads)
+        thread.join();
+
+    const auto total = workers * queries;
+    const auto protocol = statistics.get("protocol");
+    BOOST_REQUIRE_EQUAL(protocol.queries, total);
+    BOOST_REQUIRE_EQUAL(protocol.total_microseconds, total * (total - 1) / 2);
+    BOOST_REQUIRE_EQUAL(protocol.max_microseconds, total - 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <json/json.h>
+#include <metaverse/mgbubble/RpcCache.hpp>
+
+using namespace mgbubble;
+
+constexpr size_t cache_capacity = 1 << 20;
+
+static Json::Value make_params(uint64_t height)
+{
+    Json::Value params(Json::arrayValue);
+    params.append(Json::Value::UInt64(height));
+    return params;
+}
+
+static Json::Value make_result(uint64_t height)
+{
+    Json::Value result;
+    result["height"] = Json::Value::UInt64(height);
+    return result;
+}
+
+static bool cached(RpcCache& cache, const RpcCache::Key& key,
+    uint64_t height)
+{
+    const auto result = cache.find(key);
+    return result && (*result)["height"].asUInt64() == height;
+}
+
+BOOST_AUTO_TEST_SUITE(rpc_cache_tests)
+
+BOOST_AUTO_TEST_CASE(rpc_cache__key__uncacheable__empty)
+{
+    RpcCache cache(cache_capacity);
+    BOOST_REQUIRE(cache.key("getinfo", make_params(1), 3).empty());
+    BOOST_REQUIRE(cache.key("getbalance", make_params(1), 3).empty());
+    BOOST_REQUIRE(!cache.key("getblock", make_params(1), 3).empty());
+
+    // Only the public asset listing is cached.
+    Json::Value account(Json::arrayValue);
+    account.append("alice");
+    account.append("password");
+    BOOST_REQUIRE(cache.key("listassets", account, 3).empty());
+    BOOST_REQUIRE(!cache.key("listassets", Json::Value(Json::arrayValue),
+        3).empty());
+
+    RpcCache disabled(0);
+    BOOST_REQUIRE(disabled.key("getblock", make_params(1), 3).empty());
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__store__find__keyed_by_params_and_version)
+{
+    RpcCache cache(cache_capacity);
+    const auto key = cache.key("getblock", make_params(1), 3);
+    BOOST_REQUIRE(!cache.find(key));
+
+    cache.store(key, make_result(1));
+    BOOST_REQUIRE(cached(cache, key, 1));
+    BOOST_REQUIRE(!cache.find(cache.key("getblock", make_params(2), 3)));
+    BOOST_REQUIRE(!cache.find(cache.key("getblock", make_params(1), 2)));
+    BOOST_REQUIRE(!cache.find(cache.key("getblockheader", make_params(1), 3)));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__clear__drops_results_and_stale_stores)
+{
+    RpcCache cache(cache_capacity);
+    const auto key = cache.key("getblock", make_params(1), 3);
+    cache.store(key, make_result(1));
+
+    // A result read before the reorganization is not stored after it.
+    const auto stale = cache.key("getblock", make_params(2), 3);
+    cache.clear();
+    BOOST_REQUIRE(!cache.find(key));
+    cache.store(stale, make_result(2));
+    BOOST_REQUIRE(!cache.find(stale));
+
+    const auto fresh = cache.key("getblock", make_params(2), 3);
+    cache.store(fresh, make_result(2));
+    BOOST_REQUIRE(cached(cache, fresh, 2));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__clear_pool__keeps_chain_results)
+{
+    RpcCache cache(cache_capacity);
+    const auto block = cache.key("getblock", make_params(1), 3);
+    const auto tx = cache.key("gettx", make_params(1), 3);
+    cache.store(block, make_result(1));
+    cache.store(tx, make_result(1));
+
+    const auto stale_tx = cache.key("gettx", make_params(2), 3);
+    const auto block2 = cache.key("getblock", make_params(2), 3);
+    cache.clear_pool();
+    BOOST_REQUIRE(cached(cache, block, 1));
+    BOOST_REQUIRE(!cache.find(tx));
+
+    // Pool results read before the new transaction are stale, chain ones not.
+    cache.store(stale_tx, make_result(2));
+    cache.store(block2, make_result(2));
+    BOOST_REQUIRE(!cache.find(stale_tx));
+    BOOST_REQUIRE(cached(cache, block2, 2));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__store__over_capacity__drops_least_recently_used)
+{
+    // Room for a handful of results, each under an eighth of the capacity.
+    RpcCache cache(2048);
+    const auto first = cache.key("getblock", make_params(0), 3);
+    cache.store(first, make_result(0));
+
+    for (uint64_t height = 1; height < 50; ++height) {
+        BOOST_REQUIRE(cached(cache, first, 0));
+        cache.store(cache.key("getblock", make_params(height), 3),
+            make_result(height));
+    }
+
+    BOOST_REQUIRE(cached(cache, first, 0));
+    BOOST_REQUIRE(!cache.find(cache.key("getblock", make_params(1), 3)));
+    BOOST_REQUIRE(cached(cache, cache.key("getblock", make_params(49), 3), 49));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
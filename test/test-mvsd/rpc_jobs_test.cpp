@@ -0,0 +1,136 @@
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <json/json.h>
+#include <metaverse/mgbubble/RpcJobs.hpp>
+#include <metaverse/mgbubble/RpcWorkers.hpp>
+
+using namespace mgbubble;
+
+// Collects the states pushed by the jobs.
+struct job_listener
+{
+    void operator()(const Json::Value& job)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.push_back(job);
+        changed.notify_all();
+    }
+
+    // Wait for the count of finished states, false on timeout.
+    bool wait_finished(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(10), [this, count] {
+            size_t finished = 0;
+            for (const auto& state : states) {
+                const auto status = state["status"].asString();
+                if (status == "done" || status == "failed")
+                    ++finished;
+            }
+            return finished >= count;
+        });
+    }
+
+    std::vector<Json::Value> states;
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+static Json::Value make_result(const std::string& value)
+{
+    Json::Value response;
+    response["result"] = value;
+    return response;
+}
+
+BOOST_AUTO_TEST_SUITE(rpc_jobs_tests)
+
+BOOST_AUTO_TEST_CASE(rpc_jobs__submit__runs__reports_states)
+{
+    RpcWorkers serial(1, 10, 1);
+    RpcJobs jobs(serial, 1, 10, 1, 10);
+    job_listener listener;
+    jobs.set_listener([&listener](const Json::Value& job) { listener(job); });
+    serial.start();
+    jobs.start();
+
+    const auto done = jobs.submit("getblock", true,
+        [] { return make_result("block"); });
+    const auto failed = jobs.submit("send", false, [] {
+        Json::Value response;
+        response["error"]["code"] = 1000;
+        return response;
+    });
+    BOOST_REQUIRE(!done.empty());
+    BOOST_REQUIRE(!failed.empty());
+    BOOST_REQUIRE(done != failed);
+    BOOST_REQUIRE(listener.wait_finished(2));
+
+    auto state = jobs.get(done);
+    BOOST_REQUIRE_EQUAL(state["job"].asString(), done);
+    BOOST_REQUIRE_EQUAL(state["command"].asString(), "getblock");
+    BOOST_REQUIRE_EQUAL(state["status"].asString(), "done");
+    BOOST_REQUIRE_EQUAL(state["result"].asString(), "block");
+
+    state = jobs.get(failed);
+    BOOST_REQUIRE_EQUAL(state["status"].asString(), "failed");
+    BOOST_REQUIRE_EQUAL(state["error"]["code"].asInt(), 1000);
+    BOOST_REQUIRE(!state.isMember("result"));
+
+    // Each job reports running before it finishes.
+    BOOST_REQUIRE_EQUAL(listener.states.size(), 4u);
+    BOOST_REQUIRE(jobs.get("unknown").isNull());
+
+    jobs.stop();
+    serial.stop();
+}
+
+BOOST_AUTO_TEST_CASE(rpc_jobs__submit__serial_lane_stopped__refused)
+{
+    RpcWorkers serial(1, 10, 1);
+    RpcJobs jobs(serial, 1, 10, 1, 10);
+    job_listener listener;
+    jobs.set_listener([&listener](const Json::Value& job) { listener(job); });
+    jobs.start();
+
+    // Calls that are not concurrent only run on the shared serial lane.
+    BOOST_REQUIRE(jobs.submit("send", false,
+        [] { return make_result("tx"); }).empty());
+
+    const auto id = jobs.submit("getblock", true,
+        [] { return make_result("block"); });
+    BOOST_REQUIRE(!id.empty());
+    BOOST_REQUIRE(listener.wait_finished(1));
+    BOOST_REQUIRE_EQUAL(jobs.get(id)["status"].asString(), "done");
+    jobs.stop();
+}
+
+BOOST_AUTO_TEST_CASE(rpc_jobs__get__beyond_retention__expired)
+{
+    RpcWorkers serial(1, 10, 1);
+    RpcJobs jobs(serial, 1, 10, 1, 2);
+    job_listener listener;
+    jobs.set_listener([&listener](const Json::Value& job) { listener(job); });
+    serial.start();
+    jobs.start();
+
+    std::vector<std::string> ids;
+    for (size_t job = 0; job < 3; ++job) {
+        ids.push_back(jobs.submit("send", false,
+            [] { return make_result("tx"); }));
+        BOOST_REQUIRE(listener.wait_finished(job + 1));
+    }
+
+    BOOST_REQUIRE(jobs.get(ids[0]).isNull());
+    BOOST_REQUIRE_EQUAL(jobs.get(ids[1])["status"].asString(), "done");
+    BOOST_REQUIRE_EQUAL(jobs.get(ids[2])["status"].asString(), "done");
+
+    jobs.stop();
+    serial.stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/mgbubble/RpcWorkers.hpp>
+
+using namespace mgbubble;
+
+// Long enough for a job that is never expected to finish.
+constexpr auto job_timeout = std::chrono::seconds(10);
+
+BOOST_AUTO_TEST_SUITE(rpc_workers_tests)
+
+BOOST_AUTO_TEST_CASE(rpc_workers__submit__stopped__refused)
+{
+    RpcWorkers workers(1, 10, 1);
+    BOOST_REQUIRE(!workers.submit("getinfo", [] {}));
+
+    workers.start();
+    workers.stop();
+    BOOST_REQUIRE(!workers.submit("getinfo", [] {}));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_workers__submit__serial_lane__runs_in_order)
+{
+    constexpr size_t jobs = 20;
+    RpcWorkers serial(1, jobs, 1);
+    serial.start();
+
+    std::vector<size_t> order;
+    std::promise<void> done;
+
+    // Alternate commands, the lane must not reorder across them either.
+    for (size_t job = 0; job < jobs; ++job) {
+        const auto command = job % 2 == 0 ? "send" : "deposit";
+        BOOST_REQUIRE(serial.submit(command, [&order, &done, job] {
+            order.push_back(job);
+            if (order.size() == jobs)
+                done.set_value();
+        }));
+    }
+
+    BOOST_REQUIRE(done.get_future().wait_for(job_timeout) ==
+        std::future_status::ready);
+    serial.stop();
+
+    for (size_t job = 0; job < jobs; ++job)
+        BOOST_REQUIRE_EQUAL(order[job], job);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_workers__submit__queue_full__refused)
+{
+    RpcWorkers workers(1, 2, 1);
+    workers.start();
+
+    std::promise<void> gate;
+    auto opened = gate.get_future().share();
+    std::promise<void> done;
+
+    BOOST_REQUIRE(workers.submit("getblock", [opened] { opened.wait(); }));
+    BOOST_REQUIRE(workers.submit("getblock", [&done] { done.set_value(); }));
+    BOOST_REQUIRE(!workers.submit("getblock", [] {}));
+    BOOST_REQUIRE(!workers.submit("gettx", [] {}));
+
+    // The slots are released as the jobs finish.
+    gate.set_value();
+    BOOST_REQUIRE(done.get_future().wait_for(job_timeout) ==
+        std::future_status::ready);
+
+    std::promise<void> again;
+    BOOST_REQUIRE(workers.submit("gettx", [&again] { again.set_value(); }));
+    BOOST_REQUIRE(again.get_future().wait_for(job_timeout) ==
+        std::future_status::ready);
+    workers.stop();
+}
+
+BOOST_AUTO_TEST_CASE(rpc_workers__submit__command_limit__other_commands_run)
+{
+    RpcWorkers workers(2, 10, 1);
+    workers.start();
+
+    std::promise<void> gate;
+    auto opened = gate.get_future().share();
+    std::atomic<size_t> finished(0);
+    std::promise<void> other;
+
+    // The second getblock waits for the first, which waits on the gate.
+    BOOST_REQUIRE(workers.submit("getblock", [opened, &finished] {
+        opened.wait();
+        ++finished;
+    }));
+    BOOST_REQUIRE(workers.submit("getblock", [&finished] { ++finished; }));
+
+    // The free thread still serves another command.
+    BOOST_REQUIRE(workers.submit("gettx", [&other] { other.set_value(); }));
+    BOOST_REQUIRE(other.get_future().wait_for(job_timeout) ==
+        std::future_status::ready);
+    BOOST_REQUIRE_EQUAL(finished.load(), 0u);
+
+    std::promise<void> done;
+    gate.set_value();
+    BOOST_REQUIRE(workers.submit("getblock", [&finished, &done] {
+        ++finished;
+        done.set_value();
+    }));
+    BOOST_REQUIRE(done.get_future().wait_for(job_timeout) ==
+        std::future_status::ready);
+    BOOST_REQUIRE_EQUAL(finished.load(), 3u);
+    workers.stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
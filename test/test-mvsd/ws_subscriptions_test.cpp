@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/mgbubble/WsSubscriptions.hpp>
+
+using namespace mgbubble;
+
+typedef std::shared_ptr<mg_connection> connection;
+
+static connection make_connection()
+{
+    return std::make_shared<mg_connection>();
+}
+
+// The connections notified of a transaction touching the addresses.
+static std::vector<mg_connection*> notified(const WsSubscriptions& subscriptions,
+    const std::vector<size_t>& addresses)
+{
+    std::vector<mg_connection*> connections;
+    for (const auto& weak : subscriptions.match(addresses))
+        connections.push_back(weak.lock().get());
+
+    std::sort(connections.begin(), connections.end());
+    return connections;
+}
+
+static std::vector<mg_connection*> sorted(std::vector<mg_connection*> connections)
+{
+    std::sort(connections.begin(), connections.end());
+    return connections;
+}
+
+BOOST_AUTO_TEST_SUITE(ws_subscriptions_tests)
+
+BOOST_AUTO_TEST_CASE(ws_subscriptions__match__by_address)
+{
+    WsSubscriptions subscriptions;
+    BOOST_REQUIRE(subscriptions.empty());
+    BOOST_REQUIRE(subscriptions.match({ 1 }).empty());
+
+    const auto first = make_connection();
+    const auto second = make_connection();
+    BOOST_REQUIRE(subscriptions.subscribe(first.get(), first, 1));
+    BOOST_REQUIRE(subscriptions.subscribe(first.get(), first, 2));
+    BOOST_REQUIRE(subscriptions.subscribe(second.get(), second, 2));
+    BOOST_REQUIRE(!subscriptions.subscribe(first.get(), first, 1));
+    BOOST_REQUIRE(!subscriptions.empty());
+
+    BOOST_REQUIRE(notified(subscriptions, { 1 }) == sorted({ first.get() }));
+    BOOST_REQUIRE(notified(subscriptions, { 3 }).empty());
+
+    // A connection matching several addresses is notified once.
+    BOOST_REQUIRE(notified(subscriptions, { 1, 2, 2 }) ==
+        sorted({ first.get(), second.get() }));
+}
+
+BOOST_AUTO_TEST_CASE(ws_subscriptions__subscribe__every_address)
+{
+    WsSubscriptions subscriptions;
+    const auto every = make_connection();
+    const auto some = make_connection();
+    BOOST_REQUIRE(subscriptions.subscribe(every.get(), every, 0));
+    BOOST_REQUIRE(subscriptions.subscribe(every.get(), every, 0));
+    BOOST_REQUIRE(subscriptions.subscribe(some.get(), some, 1));
+
+    BOOST_REQUIRE(notified(subscriptions, {}) == sorted({ every.get() }));
+    BOOST_REQUIRE(notified(subscriptions, { 1 }) ==
+        sorted({ every.get(), some.get() }));
+
+    // An address narrows every address down to that address.
+    BOOST_REQUIRE(subscriptions.subscribe(every.get(), every, 2));
+    BOOST_REQUIRE(notified(subscriptions, { 1 }) == sorted({ some.get() }));
+    BOOST_REQUIRE(notified(subscriptions, { 2 }) == sorted({ every.get() }));
+
+    // Every address drops the addresses.
+    BOOST_REQUIRE(subscriptions.subscribe(some.get(), some, 0));
+    BOOST_REQUIRE(notified(subscriptions, { 3 }) == sorted({ some.get() }));
+    BOOST_REQUIRE(subscriptions.subscribe(some.get(), some, 1));
+}
+
+BOOST_AUTO_TEST_CASE(ws_subscriptions__unsubscribe__drops_connection)
+{
+    WsSubscriptions subscriptions;
+    const auto first = make_connection();
+    const auto second = make_connection();
+    BOOST_REQUIRE(subscriptions.subscribe(first.get(), first, 1));
+    BOOST_REQUIRE(subscriptions.subscribe(first.get(), first, 2));
+    BOOST_REQUIRE(subscriptions.subscribe(second.get(), second, 0));
+
+    subscriptions.unsubscribe(first.get());
+    BOOST_REQUIRE(notified(subscriptions, { 1, 2 }) == sorted({ second.get() }));
+
+    // Subscribing again starts over.
+    BOOST_REQUIRE(subscriptions.subscribe(first.get(), first, 1));
+    BOOST_REQUIRE(notified(subscriptions, { 2 }) == sorted({ second.get() }));
+
+    subscriptions.unsubscribe(first.get());
+    subscriptions.unsubscribe(second.get());
+    subscriptions.unsubscribe(second.get());
+    BOOST_REQUIRE(subscriptions.empty());
+    BOOST_REQUIRE(subscriptions.match({ 1, 2 }).empty());
+}
+
+BOOST_AUTO_TEST_CASE(ws_subscriptions__match__closed_connection__expired)
+{
+    WsSubscriptions subscriptions;
+    auto closed = make_connection();
+    BOOST_REQUIRE(subscriptions.subscribe(closed.get(), closed, 1));
+    closed.reset();
+
+    const auto matched = subscriptions.match({ 1 });
+    BOOST_REQUIRE_EQUAL(matched.size(), 1u);
+    BOOST_REQUIRE(matched.front().expired());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+from TestCase.MVSTestCase import *
+
+class TestBatch(MVSTestCaseBase):
+    '''
+    json-rpc 2.0 batch requests, read-only calls run concurrently and the
+    others in order, the results keep the order of the calls.
+    '''
+    need_mine = False
+    roles = (Alice,)
+
+    def test_0_results_in_call_order(self):
+        _, (hash, height) = mvs_rpc.getblockheader()
+        calls = [
+            mvs_rpc.batch_call("getblockheader", [], 1),
+            mvs_rpc.batch_call("getbalance", [Alice.name, Alice.password], 2),
+            mvs_rpc.batch_call("getheight", [], 3),
+            mvs_rpc.batch_call("getblock", [height], 4),
+            mvs_rpc.batch_call("validateaddress", [Alice.mainaddress()], 5),
+        ]
+
+        for version in ('v2', 'v3'):
+            rsp = mvs_rpc.post_batch(calls, version)
+            self.assertEqual(rsp.status_code, 200)
+            results = rsp.json()
+            self.assertEqual([result['id'] for result in results], [1, 2, 3, 4, 5])
+            for result in results:
+                self.assertNotIn('error', result, result)
+
+            self.assertEqual(results[0]['result']['hash'], hash)
+            self.assertEqual(results[1]['result']['total-available'], Alice.get_balance())
+            self.assertEqual(results[2]['result'], height)
+            self.assertEqual(results[3]['result']['hash'], hash)
+
+    def test_1_malformed_call(self):
+        calls = [
+            mvs_rpc.batch_call("getheight", [], 1),
+            "getheight",
+            mvs_rpc.batch_call("getheight", "", 3),
+            mvs_rpc.batch_call("nosuchcommand", [], 4),
+            mvs_rpc.batch_call("getbalance", [Alice.name], 5),
+        ]
+        results = mvs_rpc.post_batch(calls).json()
+        self.assertEqual(len(results), 5)
+        self.assertNotIn('error', results[0], results[0])
+        self.assertEqual(results[1]['error']['code'], code.jsonrpc_invalid_request)
+        self.assertEqual(results[2]['error']['code'], code.jsonrpc_invalid_params)
+        self.assertEqual(results[3]['error']['code'], code.invalid_command_exception)
+        self.assertEqual(results[4]['error']['code'], code.command_params_exception)
+
+    def test_2_notifications(self):
+        calls = [
+            mvs_rpc.batch_call("getheight", []),
+            mvs_rpc.batch_call("getheight", [], 7),
+            mvs_rpc.batch_call("getbalance", [Alice.name, Alice.password]),
+        ]
+        results = mvs_rpc.post_batch(calls).json()
+        self.assertEqual(len(results), 1)
+        self.assertEqual(results[0]['id'], 7)
+
+        # a batch of notifications only has no body
+        rsp = mvs_rpc.post_batch(calls[:1])
+        self.assertEqual(rsp.status_code, 200)
+        self.assertEqual(rsp.text, '')
+
+    def test_3_empty_batch(self):
+        rsp = mvs_rpc.post_batch([]).json()
+        self.assertEqual(rsp['error']['code'], code.jsonrpc_invalid_request)
@@ -0,0 +1,42 @@
+from TestCase.MVSTestCase import *
+
+class TestRPCParams(MVSTestCaseBase):
+    '''
+    getheight, getinfo and getbalance bind their params without the command
+    line parser, the other forms of params still go through it.
+    '''
+    need_mine = False
+    roles = (Alice,)
+
+    def test_0_bound_params(self):
+        _, (_, height) = mvs_rpc.getblockheader()
+
+        ec, message = mvs_rpc.get_height()
+        self.assertEqual(ec, 0, message)
+        self.assertEqual(message, height)
+
+        ec, message = mvs_rpc.get_info()
+        self.assertEqual(ec, 0, message)
+        self.assertEqual(message[0], height)
+
+        ec, message = mvs_rpc.get_balance(Alice.name, Alice.password)
+        self.assertEqual(ec, 0, message)
+        self.assertEqual(message['total-available'], Alice.get_balance())
+
+        # password error, as reported by the parser
+        ec, message = mvs_rpc.get_balance(Alice.name, Alice.password + '1')
+        self.assertEqual(ec, 1000, message)
+
+    def test_1_parser_fallback(self):
+        # a missing param is reported by the parser
+        rsp = mvs_rpc.RPC("getbalance").post([Alice.name], {}).json()
+        self.assertEqual(rsp['error']['code'], code.command_params_exception, rsp)
+
+        # options are read by the parser
+        ec, message = mvs_rpc.get_height("--help")
+        self.assertEqual(ec, 0, message)
+        self.assertIn("getheight", message)
+
+        # a param which is not a scalar is not bound
+        ec, message = mvs_rpc.get_height([Alice.name])
+        self.assertNotEqual(ec, 0, message)
@@ -7,6 +7,11 @@ fatal_exception = 1001
 connection_exception = 1011
 session_expired_exception = 1012
 
+jsonrpc_parse_error = -32700
+jsonrpc_invalid_request = -32600
+jsonrpc_method_not_found = -32601
+jsonrpc_invalid_params = -32602
+
 invalid_command_exception = 1020
 command_params_exception = 1021
 command_platform_compat_exception = 1022
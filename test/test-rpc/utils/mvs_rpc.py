@@ -680,6 +680,26 @@ def pop_block(height):
     '''
     return "popblock", [height], {}, None
 
+@mvs_api
+def get_height(*auth):
+    return "getheight", list(auth), {}, None
+
+def batch_call(method, params, id=None):
+    '''
+    One call of a batch, a notification without id.
+    '''
+    call = {'jsonrpc': '2.0', 'method': method, 'params': params}
+    if id != None:
+        call['id'] = id
+    return call
+
+def post_batch(calls, version='v2'):
+    '''
+    Post the calls as one json-rpc batch, returns the http response.
+    '''
+    url = RPC.url.replace('/v2', '/' + version)
+    return requests.post(url, data=json.dumps(calls))
+
 if __name__ == "__main__":
     rc = RemoteCtrl("10.10.10.35")
     print rc.list_balances('lxf', '123')